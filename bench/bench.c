@@ -0,0 +1,17 @@
+#include "state_bench.h"
+#include "fifo_bench.h"
+#include "heap_bench.h"
+#include "emitter_bench.h"
+#include "executor_bench.h"
+#include "work_stealing_bench.h"
+
+int main( void )
+{
+    STATEBenchSuite();
+    FIFOBenchSuite();
+    HEAPBenchSuite();
+    EMITTERBenchSuite();
+    EXECUTORBenchSuite();
+    WORKSTEALINGBenchSuite();
+    return 0;
+}
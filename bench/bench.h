@@ -0,0 +1,34 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+static inline uint64_t Bench_Now( void )
+{
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ( (uint64_t)ts.tv_sec * 1000000000ULL ) + (uint64_t)ts.tv_nsec;
+}
+
+static inline void Bench_Report( const char * name, uint64_t elapsed_ns, uint64_t ops )
+{
+    printf( "%-40s %12llu ops %10.2f ns/op\n", 
+            name, 
+            (unsigned long long)ops,
+            (double)elapsed_ns / (double)ops );
+}
+
+/* Deterministic generator so that runs are comparable */
+static inline uint32_t Bench_Rand( uint32_t * seed )
+{
+    uint32_t x = *seed;
+    x ^= x << 13U;
+    x ^= x >> 17U;
+    x ^= x << 5U;
+    *seed = x;
+    return x;
+}
+
+#endif /* BENCH_H */
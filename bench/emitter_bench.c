@@ -0,0 +1,72 @@
+#include "emitter_bench.h"
+#include "bench.h"
+#include "emitter_wheel.h"
+#include "fifo_static.h"
+
+#define MAX_TIMERS ( 1U << 20U )
+#define MAX_DELAY ( 1U << 16U )
+#define FIFO_LEN ( 1U << 16U )
+#define POLL_STRIDE ( 1U << 10U )
+
+GENERATE_FIFO( timer_fifo, event_t, FIFO_LEN );
+
+static timer_fifo_t fifo;
+static emitter_wheel_t wheel;
+static emitter_timer_t timers[ MAX_TIMERS ];
+static emitter_handle_t handles[ MAX_TIMERS ];
+static event_t drained[ FIFO_LEN ];
+static uint64_t ticks;
+
+static uint64_t Clock( void * arg )
+{
+    return *(uint64_t *)arg;
+}
+
+/* Arm n one-shots spread over MAX_DELAY ticks, cancel every other one,
+ * then run the clock until the rest have expired, draining as it goes.
+ * The clock moves POLL_STRIDE ticks per poll, so the figure is the cost
+ * of expiring a timer rather than of polling ticks where nothing is due */
+static void Bench_Wheel( uint32_t n )
+{
+    uint32_t seed = 0x12345678U;
+    char name[ 64 ];
+
+    ticks = 0U;
+    timer_fifo_Init( &fifo );
+    EMITTER_WHEEL_Init( &wheel, &fifo, timers, n, Clock, &ticks );
+
+    uint64_t start = Bench_Now();
+    for( uint32_t idx = 0U; idx < n; idx++ )
+    {
+        handles[ idx ] = EMITTER_WHEEL_Start( &wheel, idx, 1U + ( Bench_Rand( &seed ) % MAX_DELAY ), 0U );
+    }
+    snprintf( name, sizeof( name ), "Wheel start, %u timers", n );
+    Bench_Report( name, Bench_Now() - start, n );
+
+    start = Bench_Now();
+    for( uint32_t idx = 0U; idx < n; idx += 2U )
+    {
+        (void)EMITTER_WHEEL_Stop( &wheel, handles[ idx ] );
+    }
+    snprintf( name, sizeof( name ), "Wheel stop, %u timers", n );
+    Bench_Report( name, Bench_Now() - start, n / 2U );
+
+    uint64_t emitted = 0U;
+    start = Bench_Now();
+    while( wheel.active > 0U )
+    {
+        ticks += POLL_STRIDE;
+        emitted += EMITTER_WHEEL_Poll( &wheel );
+        (void)FIFO_DequeueN( &fifo, drained, FIFO_LEN );
+    }
+    snprintf( name, sizeof( name ), "Wheel expire, %u timers", n );
+    Bench_Report( name, Bench_Now() - start, emitted );
+}
+
+extern void EMITTERBenchSuite(void)
+{
+    for( uint32_t n = 1024U; n <= MAX_TIMERS; n <<= 5U )
+    {
+        Bench_Wheel( n );
+    }
+}
@@ -0,0 +1,6 @@
+#ifndef EMITTER_BENCH_H
+#define EMITTER_BENCH_H
+
+extern void EMITTERBenchSuite(void);
+
+#endif /* EMITTER_BENCH_H */
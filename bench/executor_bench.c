@@ -0,0 +1,129 @@
+#include "executor_bench.h"
+#include "bench.h"
+#include "executor.h"
+#include "state.h"
+#include <sched.h>
+#include <unistd.h>
+
+#define EVENTS(EVNT) \
+    EVNT( Work ) \
+
+GENERATE_EVENTS( EVENTS );
+
+#define NUM_MACHINES ( 256U )
+#define NUM_PRODUCERS ( 2U )
+#define EVENTS_PER_PRODUCER ( 1U << 19U )
+/* Rough amount of work done per event by each machine */
+#define WORK_LOOPS ( 64U )
+
+typedef struct
+{
+    state_t state;
+    uint32_t acc;
+}
+worker_machine_t;
+
+typedef struct
+{
+    executor_t * exec;
+    executor_object_t * object;
+    uint32_t seed;
+}
+producer_t;
+
+static executor_t exec;
+static executor_object_t object[ NUM_MACHINES ];
+static worker_machine_t machine[ NUM_MACHINES ];
+
+DEFINE_STATE( Working );
+
+static state_ret_t State_Working( state_t * this, event_t s )
+{
+    state_ret_t ret;
+    worker_machine_t * m = (worker_machine_t *)this;
+
+    switch( s )
+    {
+        case EVENT( Enter ):
+        case EVENT( Exit ):
+            ret = HANDLED( this );
+            break;
+        case EVENT( Work ):
+            for( uint32_t idx = 0U; idx < WORK_LOOPS; idx++ )
+            {
+                m->acc = ( m->acc * 1664525U ) + 1013904223U;
+            }
+            ret = HANDLED( this );
+            break;
+        default:
+            ret = NO_PARENT( this );
+            break;
+    }
+    return ret;
+}
+
+static void * Producer( void * arg )
+{
+    producer_t * producer = (producer_t *)arg;
+
+    for( uint32_t idx = 0U; idx < EVENTS_PER_PRODUCER; idx++ )
+    {
+        executor_object_t * target = &producer->object[ Bench_Rand( &producer->seed ) % NUM_MACHINES ];
+        while( !Executor_Post( producer->exec, target, EVENT( Work ) ) )
+        {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void Bench_Storm( uint32_t num_workers, uint32_t num_cpus )
+{
+    int cpus[ EXECUTOR_MAX_WORKERS ];
+    for( uint32_t idx = 0U; idx < num_workers; idx++ )
+    {
+        cpus[ idx ] = (int)( idx % num_cpus );
+    }
+
+    Executor_Init( &exec, num_workers, cpus );
+    for( uint32_t idx = 0U; idx < NUM_MACHINES; idx++ )
+    {
+        STATEMACHINE_Init( &machine[ idx ].state, STATE( Working ) );
+        Executor_Register( &exec, &object[ idx ], &machine[ idx ].state, EXECUTOR_ANY_WORKER );
+    }
+
+    producer_t producer[ NUM_PRODUCERS ];
+    pthread_t thread[ NUM_PRODUCERS ];
+
+    uint64_t start = Bench_Now();
+    (void)Executor_Start( &exec );
+    for( uint32_t idx = 0U; idx < NUM_PRODUCERS; idx++ )
+    {
+        producer[ idx ].exec = &exec;
+        producer[ idx ].object = object;
+        producer[ idx ].seed = 0x9E3779B9U * ( idx + 1U );
+        pthread_create( &thread[ idx ], NULL, Producer, &producer[ idx ] );
+    }
+    for( uint32_t idx = 0U; idx < NUM_PRODUCERS; idx++ )
+    {
+        pthread_join( thread[ idx ], NULL );
+    }
+    Executor_Stop( &exec );
+    uint64_t elapsed = Bench_Now() - start;
+
+    char name[ 64 ];
+    snprintf( name, sizeof( name ), "Executor event storm, %u workers", num_workers );
+    Bench_Report( name, elapsed, (uint64_t)NUM_PRODUCERS * EVENTS_PER_PRODUCER );
+}
+
+extern void EXECUTORBenchSuite(void)
+{
+    long online = sysconf( _SC_NPROCESSORS_ONLN );
+    uint32_t num_cpus = ( online > 0 ) ? (uint32_t)online : 1U;
+    uint32_t max_workers = ( num_cpus < EXECUTOR_MAX_WORKERS ) ? num_cpus : EXECUTOR_MAX_WORKERS;
+
+    for( uint32_t workers = 1U; workers <= max_workers; workers <<= 1U )
+    {
+        Bench_Storm( workers, num_cpus );
+    }
+}
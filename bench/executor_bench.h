@@ -0,0 +1,6 @@
+#ifndef EXECUTOR_BENCH_H
+#define EXECUTOR_BENCH_H
+
+extern void EXECUTORBenchSuite(void);
+
+#endif /* EXECUTOR_BENCH_H */
@@ -0,0 +1,425 @@
+#include "fifo_bench.h"
+#include "bench.h"
+#include "fifo_base.h"
+#include "fifo_static.h"
+#include "fifo_spsc.h"
+#include "fifo_mpmc.h"
+#include <pthread.h>
+#include <sched.h>
+
+#define FIFO_LEN ( 1024U )
+#define TRANSFER_LEN ( 1U << 22U )
+#define ROUND_TRIPS ( 1U << 16U )
+#define MAX_PRODUCERS ( 8U )
+#define BURST_LEN ( 1000U )
+#define BURSTS ( 1U << 12U )
+#define RECORD_WORDS ( 64U )
+#define RECORD_FIFO_LEN ( 64U )
+
+typedef struct
+{
+    fifo_spsc_base_t base;
+    uint32_t queue[ FIFO_LEN ];
+    _Alignas( FIFO_SPSC_CACHE_LINE ) uint32_t in;
+    _Alignas( FIFO_SPSC_CACHE_LINE ) uint32_t out;
+}
+spsc_fifo_t;
+
+typedef struct
+{
+    fifo_base_t base;
+    uint32_t queue[ FIFO_LEN ];
+    uint32_t in;
+    uint32_t out;
+}
+plain_fifo_t;
+
+/* What producer/consumer pairs have had to do so far */
+typedef struct
+{
+    pthread_mutex_t lock;
+    plain_fifo_t fifo;
+}
+locked_fifo_t;
+
+typedef struct
+{
+    fifo_mpmc_base_t base;
+    FIFO_MPMC_SLOT( uint32_t ) slot[ FIFO_LEN ];
+}
+mpmc_fifo_t;
+
+/* A multi hundred byte payload record */
+typedef struct
+{
+    uint32_t word[ RECORD_WORDS ];
+}
+record_t;
+
+GENERATE_FIFO( static_fifo, uint32_t, FIFO_LEN );
+GENERATE_FIFO( record_fifo, record_t, RECORD_FIFO_LEN );
+
+static spsc_fifo_t spsc[ 2U ];
+static mpmc_fifo_t mpmc;
+static locked_fifo_t locked[ 2U ];
+
+static void SPSC_Enqueue( fifo_spsc_base_t * const base ) SPSC_ENQUEUE_BOILERPLATE( spsc_fifo_t, base )
+static void SPSC_Dequeue( fifo_spsc_base_t * const base ) SPSC_DEQUEUE_BOILERPLATE( spsc_fifo_t, base )
+static void Plain_Enqueue( fifo_base_t * const base ) ENQUEUE_BOILERPLATE( plain_fifo_t, base )
+static void Plain_Dequeue( fifo_base_t * const base ) DEQUEUE_BOILERPLATE( plain_fifo_t, base )
+static uint32_t Plain_EnqueueN( fifo_base_t * const base, void const * const values, uint32_t count ) ENQUEUE_N_BOILERPLATE( plain_fifo_t, base, values, count )
+static uint32_t Plain_DequeueN( fifo_base_t * const base, void * const values, uint32_t count ) DEQUEUE_N_BOILERPLATE( plain_fifo_t, base, values, count )
+
+static void Init( void )
+{
+    static const fifo_spsc_vfunc_t spsc_vfunc = { .enq = SPSC_Enqueue, .deq = SPSC_Dequeue, .peek = NULL };
+    static const fifo_vfunc_t plain_vfunc = { .enq = Plain_Enqueue, .deq = Plain_Dequeue, .peek = NULL, .flush = NULL, .enq_n = Plain_EnqueueN, .deq_n = Plain_DequeueN };
+
+    for( uint32_t idx = 0U; idx < 2U; idx++ )
+    {
+        FIFO_SPSC_Init( &spsc[ idx ].base, FIFO_LEN );
+        spsc[ idx ].base.vfunc = &spsc_vfunc;
+
+        pthread_mutex_init( &locked[ idx ].lock, NULL );
+        FIFO_Init( &locked[ idx ].fifo.base, FIFO_LEN );
+        locked[ idx ].fifo.base.vfunc = &plain_vfunc;
+    }
+}
+
+static inline void SPSCPush( spsc_fifo_t * const fifo, uint32_t value )
+{
+    while( FIFO_SPSC_IsFull( &fifo->base ) )
+    {
+        sched_yield();
+    }
+    FIFO_SPSC_Enqueue( fifo, value );
+}
+
+static inline uint32_t SPSCPop( spsc_fifo_t * const fifo )
+{
+    while( FIFO_SPSC_IsEmpty( &fifo->base ) )
+    {
+        sched_yield();
+    }
+    return FIFO_SPSC_Dequeue( fifo );
+}
+
+static inline void LockedPush( locked_fifo_t * const fifo, uint32_t value )
+{
+    while( true )
+    {
+        pthread_mutex_lock( &fifo->lock );
+        if( !FIFO_IsFull( &fifo->fifo.base ) )
+        {
+            FIFO_Enqueue( &fifo->fifo, value );
+            pthread_mutex_unlock( &fifo->lock );
+            break;
+        }
+        pthread_mutex_unlock( &fifo->lock );
+        sched_yield();
+    }
+}
+
+static inline uint32_t LockedPop( locked_fifo_t * const fifo )
+{
+    uint32_t value;
+    while( true )
+    {
+        pthread_mutex_lock( &fifo->lock );
+        if( !FIFO_IsEmpty( &fifo->fifo.base ) )
+        {
+            value = FIFO_Dequeue( &fifo->fifo );
+            pthread_mutex_unlock( &fifo->lock );
+            break;
+        }
+        pthread_mutex_unlock( &fifo->lock );
+        sched_yield();
+    }
+    return value;
+}
+
+static void * SPSCProducer( void * arg )
+{
+    (void)arg;
+    for( uint32_t idx = 0U; idx < TRANSFER_LEN; idx++ )
+    {
+        SPSCPush( &spsc[ 0U ], idx );
+    }
+    return NULL;
+}
+
+static void * LockedProducer( void * arg )
+{
+    (void)arg;
+    for( uint32_t idx = 0U; idx < TRANSFER_LEN; idx++ )
+    {
+        LockedPush( &locked[ 0U ], idx );
+    }
+    return NULL;
+}
+
+/* Echoes every value back on the second FIFO */
+static void * SPSCEcho( void * arg )
+{
+    (void)arg;
+    for( uint32_t idx = 0U; idx < ROUND_TRIPS; idx++ )
+    {
+        SPSCPush( &spsc[ 1U ], SPSCPop( &spsc[ 0U ] ) );
+    }
+    return NULL;
+}
+
+static void * LockedEcho( void * arg )
+{
+    (void)arg;
+    for( uint32_t idx = 0U; idx < ROUND_TRIPS; idx++ )
+    {
+        LockedPush( &locked[ 1U ], LockedPop( &locked[ 0U ] ) );
+    }
+    return NULL;
+}
+
+static void Bench_Throughput( const char * name, bool lock_free )
+{
+    pthread_t thread;
+    volatile uint32_t sink = 0U;
+
+    Init();
+    uint64_t start = Bench_Now();
+    pthread_create( &thread, NULL, lock_free ? SPSCProducer : LockedProducer, NULL );
+    for( uint32_t idx = 0U; idx < TRANSFER_LEN; idx++ )
+    {
+        sink += lock_free ? SPSCPop( &spsc[ 0U ] ) : LockedPop( &locked[ 0U ] );
+    }
+    pthread_join( thread, NULL );
+    Bench_Report( name, Bench_Now() - start, TRANSFER_LEN );
+    (void)sink;
+}
+
+static void Bench_RoundTrip( const char * name, bool lock_free )
+{
+    pthread_t thread;
+
+    Init();
+    uint64_t start = Bench_Now();
+    pthread_create( &thread, NULL, lock_free ? SPSCEcho : LockedEcho, NULL );
+    for( uint32_t idx = 0U; idx < ROUND_TRIPS; idx++ )
+    {
+        if( lock_free )
+        {
+            SPSCPush( &spsc[ 0U ], idx );
+            (void)SPSCPop( &spsc[ 1U ] );
+        }
+        else
+        {
+            LockedPush( &locked[ 0U ], idx );
+            (void)LockedPop( &locked[ 1U ] );
+        }
+    }
+    pthread_join( thread, NULL );
+    Bench_Report( name, Bench_Now() - start, ROUND_TRIPS );
+}
+
+static void * MPMCProducer( void * arg )
+{
+    const uint32_t count = *(uint32_t const *)arg;
+    for( uint32_t idx = 0U; idx < count; idx++ )
+    {
+        (void)FIFO_MPMC_Enqueue( &mpmc, &idx );
+    }
+    return NULL;
+}
+
+static void * LockedManyProducer( void * arg )
+{
+    const uint32_t count = *(uint32_t const *)arg;
+    for( uint32_t idx = 0U; idx < count; idx++ )
+    {
+        LockedPush( &locked[ 0U ], idx );
+    }
+    return NULL;
+}
+
+/* Many producers posting into the one queue of a single consumer */
+static void Bench_Producers( uint32_t num_producers, bool lock_free )
+{
+    pthread_t thread[ MAX_PRODUCERS ];
+    uint32_t count = TRANSFER_LEN / num_producers;
+    volatile uint32_t sink = 0U;
+
+    Init();
+    FIFO_MPMC_Init( &mpmc );
+
+    uint64_t start = Bench_Now();
+    for( uint32_t idx = 0U; idx < num_producers; idx++ )
+    {
+        pthread_create( &thread[ idx ], NULL, lock_free ? MPMCProducer : LockedManyProducer, &count );
+    }
+    for( uint32_t idx = 0U; idx < ( count * num_producers ); idx++ )
+    {
+        uint32_t value = 0U;
+        if( lock_free )
+        {
+            (void)FIFO_MPMC_Dequeue( &mpmc, &value );
+        }
+        else
+        {
+            value = LockedPop( &locked[ 0U ] );
+        }
+        sink += value;
+    }
+    for( uint32_t idx = 0U; idx < num_producers; idx++ )
+    {
+        pthread_join( thread[ idx ], NULL );
+    }
+    uint64_t elapsed = Bench_Now() - start;
+    FIFO_MPMC_Destroy( &mpmc.base );
+
+    char name[ 64 ];
+    snprintf( name, sizeof( name ), "%s FIFO, %u producers", lock_free ? "MPMC" : "Mutex", num_producers );
+    Bench_Report( name, elapsed, (uint64_t)count * num_producers );
+    (void)sink;
+}
+
+/* Bursts of BURST_LEN through one FIFO, element by element or as spans.
+ * The indices drift so the spans regularly split at the wrap point */
+static void Bench_Burst( const char * name, bool span )
+{
+    static uint32_t values[ BURST_LEN ];
+    static uint32_t out[ BURST_LEN ];
+    volatile uint32_t sink = 0U;
+    plain_fifo_t * const fifo = &locked[ 0U ].fifo;
+
+    Init();
+    for( uint32_t idx = 0U; idx < BURST_LEN; idx++ )
+    {
+        values[ idx ] = idx;
+    }
+
+    uint64_t start = Bench_Now();
+    for( uint32_t burst = 0U; burst < BURSTS; burst++ )
+    {
+        if( span )
+        {
+            (void)FIFO_EnqueueN( fifo, values, BURST_LEN );
+            (void)FIFO_DequeueN( fifo, out, BURST_LEN );
+        }
+        else
+        {
+            for( uint32_t idx = 0U; idx < BURST_LEN; idx++ )
+            {
+                FIFO_Enqueue( fifo, values[ idx ] );
+            }
+            for( uint32_t idx = 0U; idx < BURST_LEN; idx++ )
+            {
+                out[ idx ] = FIFO_Dequeue( fifo );
+            }
+        }
+        sink += out[ burst % BURST_LEN ];
+    }
+    Bench_Report( name, Bench_Now() - start, (uint64_t)BURSTS * BURST_LEN );
+    (void)sink;
+}
+
+/* Same single threaded traffic through the vfunc and the generated FIFO */
+static void Bench_Dispatch( const char * name, bool generated )
+{
+    static static_fifo_t fifo;
+    volatile uint32_t sink = 0U;
+
+    uint32_t sum = 0U;
+
+    static_fifo_Init( &fifo );
+    uint64_t start = Bench_Now();
+    for( uint32_t burst = 0U; burst < BURSTS; burst++ )
+    {
+        for( uint32_t idx = 0U; idx < BURST_LEN; idx++ )
+        {
+            if( generated )
+            {
+                static_fifo_PushUnchecked( &fifo, idx );
+            }
+            else
+            {
+                FIFO_Enqueue( &fifo, idx );
+            }
+        }
+        for( uint32_t idx = 0U; idx < BURST_LEN; idx++ )
+        {
+            sum += generated ? static_fifo_Pop( &fifo ) : FIFO_Dequeue( &fifo );
+        }
+    }
+    Bench_Report( name, Bench_Now() - start, (uint64_t)BURSTS * BURST_LEN );
+    sink = sum;
+    (void)sink;
+}
+
+/* Records built and consumed through in/out, or in place in the slots */
+static void Bench_Records( const char * name, bool in_place )
+{
+    static record_fifo_t fifo;
+    volatile uint32_t sink = 0U;
+    const uint32_t records = BURSTS * 16U;
+
+    record_fifo_Init( &fifo );
+    uint64_t start = Bench_Now();
+    for( uint32_t idx = 0U; idx < records; idx++ )
+    {
+        uint32_t sum = 0U;
+        if( in_place )
+        {
+            record_t * slot = FIFO_Reserve( &fifo );
+            for( uint32_t word = 0U; word < RECORD_WORDS; word++ )
+            {
+                slot->word[ word ] = idx + word;
+            }
+            FIFO_Commit( &fifo );
+
+            record_t const * front = FIFO_Front( &fifo );
+            for( uint32_t word = 0U; word < RECORD_WORDS; word++ )
+            {
+                sum += front->word[ word ];
+            }
+            FIFO_Release( &fifo );
+        }
+        else
+        {
+            record_t record;
+            for( uint32_t word = 0U; word < RECORD_WORDS; word++ )
+            {
+                record.word[ word ] = idx + word;
+            }
+            FIFO_Enqueue( &fifo, record );
+
+            record = FIFO_Dequeue( &fifo );
+            for( uint32_t word = 0U; word < RECORD_WORDS; word++ )
+            {
+                sum += record.word[ word ];
+            }
+        }
+        sink += sum;
+    }
+    Bench_Report( name, Bench_Now() - start, records );
+    (void)sink;
+}
+
+extern void FIFOBenchSuite(void)
+{
+    Bench_Records( "FIFO 256 byte records, copied", false );
+    Bench_Records( "FIFO 256 byte records, in place", true );
+    Bench_Dispatch( "FIFO through vfunc", false );
+    Bench_Dispatch( "FIFO generated, direct", true );
+    Bench_Burst( "FIFO burst, single element", false );
+    Bench_Burst( "FIFO burst, span", true );
+
+    Bench_Throughput( "Mutex FIFO throughput", false );
+    Bench_Throughput( "SPSC FIFO throughput", true );
+    Bench_RoundTrip( "Mutex FIFO round trip", false );
+    Bench_RoundTrip( "SPSC FIFO round trip", true );
+
+    for( uint32_t producers = 1U; producers <= MAX_PRODUCERS; producers <<= 1U )
+    {
+        Bench_Producers( producers, false );
+        Bench_Producers( producers, true );
+    }
+}
@@ -0,0 +1,6 @@
+#ifndef FIFO_BENCH_H
+#define FIFO_BENCH_H
+
+extern void FIFOBenchSuite(void);
+
+#endif /* FIFO_BENCH_H */
@@ -0,0 +1,307 @@
+#include "heap_bench.h"
+#include "bench.h"
+#include "heap_base.h"
+#include "heap_static.h"
+#include "heap_dary.h"
+
+#define MAX_ELEMENTS ( 1U << 20U )
+#define SMALL_ROUNDS ( 1U << 16U )
+#define TIMER_ROUNDS ( 1U << 21U )
+#define TIMER_PERIOD ( 1U << 16U )
+
+/* A deadline with the event to emit when it expires */
+typedef struct
+{
+    uint64_t deadline;
+    uint32_t event;
+    uint32_t target;
+}
+deadline_t;
+
+#define KEY_LESS( a, b ) ( *(a) < *(b) )
+#define DEADLINE_LESS( a, b ) ( (a)->deadline < (b)->deadline )
+
+GENERATE_HEAP( key_heap, uint32_t, MAX_ELEMENTS, KEY_LESS );
+GENERATE_HEAP( deadline_heap, deadline_t, MAX_ELEMENTS, DEADLINE_LESS );
+GENERATE_HEAP( small_heap, uint32_t, HEAP_LEN, KEY_LESS );
+
+static key_heap_t keys;
+static deadline_heap_t deadlines;
+static heap_dary_t dary;
+HEAP_DARY_STORAGE( dary_keys, MAX_ELEMENTS );
+
+static const char * const backend_names[] =
+{
+    [ HEAP_DARY_AUTO ] = "auto",
+    [ HEAP_DARY_SCALAR ] = "scalar",
+    [ HEAP_DARY_SSE41 ] = "SSE4.1",
+    [ HEAP_DARY_AVX2 ] = "AVX2",
+};
+
+/* Fill to n then drain, reported per push + pop pair */
+static void Bench_Keys( uint32_t n )
+{
+    uint32_t seed = 0x12345678U;
+    volatile uint32_t sink = 0U;
+
+    key_heap_Init( &keys );
+    uint64_t start = Bench_Now();
+    for( uint32_t idx = 0U; idx < n; idx++ )
+    {
+        key_heap_Push( &keys, Bench_Rand( &seed ) );
+    }
+    for( uint32_t idx = 0U; idx < n; idx++ )
+    {
+        sink += key_heap_Pop( &keys );
+    }
+
+    char name[ 64 ];
+    snprintf( name, sizeof( name ), "Heap uint32_t, %u elements", n );
+    Bench_Report( name, Bench_Now() - start, n );
+    (void)sink;
+}
+
+static void Bench_Deadlines( uint32_t n )
+{
+    uint32_t seed = 0x12345678U;
+    volatile uint64_t sink = 0U;
+
+    deadline_heap_Init( &deadlines );
+    uint64_t start = Bench_Now();
+    for( uint32_t idx = 0U; idx < n; idx++ )
+    {
+        deadline_heap_Push( &deadlines, (deadline_t){ .deadline = Bench_Rand( &seed ), .event = idx, .target = 0U } );
+    }
+    for( uint32_t idx = 0U; idx < n; idx++ )
+    {
+        sink += deadline_heap_Pop( &deadlines ).event;
+    }
+
+    char name[ 64 ];
+    snprintf( name, sizeof( name ), "Heap deadline_t, %u elements", n );
+    Bench_Report( name, Bench_Now() - start, n );
+    (void)sink;
+}
+
+static deadline_t restored[ MAX_ELEMENTS ];
+
+/* Restoring a snapshot of n deadlines, either pushed one at a time or
+ * handed to Build, reported per element */
+static void Bench_Restore( uint32_t n, bool build )
+{
+    uint32_t seed = 0x12345678U;
+    for( uint32_t idx = 0U; idx < n; idx++ )
+    {
+        restored[ idx ] = (deadline_t){ .deadline = Bench_Rand( &seed ), .event = idx, .target = 0U };
+    }
+
+    deadline_heap_Init( &deadlines );
+    uint64_t start = Bench_Now();
+    if( build )
+    {
+        deadline_heap_Build( &deadlines, restored, n );
+    }
+    else
+    {
+        for( uint32_t idx = 0U; idx < n; idx++ )
+        {
+            deadline_heap_Push( &deadlines, restored[ idx ] );
+        }
+    }
+    uint64_t elapsed = Bench_Now() - start;
+
+    char name[ 64 ];
+    snprintf( name, sizeof( name ), "Restore %s, %u deadlines", build ? "Build" : "Push", n );
+    Bench_Report( name, elapsed, n );
+}
+
+static void Bench_SmallRestore( bool build )
+{
+    uint32_t seed = 0x12345678U;
+    volatile uint32_t sink = 0U;
+    uint32_t data[ HEAP_LEN ];
+    heap_t heap;
+
+    uint64_t start = Bench_Now();
+    for( uint32_t round = 0U; round < SMALL_ROUNDS; round++ )
+    {
+        for( uint32_t idx = 0U; idx < HEAP_LEN; idx++ )
+        {
+            data[ idx ] = Bench_Rand( &seed );
+        }
+        Heap_Init( &heap );
+        if( build )
+        {
+            Heap_Build( &heap, data, HEAP_LEN );
+        }
+        else
+        {
+            for( uint32_t idx = 0U; idx < HEAP_LEN; idx++ )
+            {
+                Heap_Push( &heap, data[ idx ] );
+            }
+        }
+        sink += Heap_Peek( &heap );
+    }
+    Bench_Report( build ? "Restore Heap_Build, 8 elements" : "Restore Heap_Push, 8 elements",
+            Bench_Now() - start, (uint64_t)SMALL_ROUNDS * HEAP_LEN );
+    (void)sink;
+}
+
+/* The existing heap only holds HEAP_LEN keys, so compare at that size */
+static void Bench_Small( bool generated )
+{
+    uint32_t seed = 0x12345678U;
+    volatile uint32_t sink = 0U;
+    heap_t heap;
+    small_heap_t small;
+
+    uint64_t start = Bench_Now();
+    for( uint32_t round = 0U; round < SMALL_ROUNDS; round++ )
+    {
+        if( generated )
+        {
+            small_heap_Init( &small );
+            for( uint32_t idx = 0U; idx < HEAP_LEN; idx++ )
+            {
+                small_heap_Push( &small, Bench_Rand( &seed ) );
+            }
+            for( uint32_t idx = 0U; idx < HEAP_LEN; idx++ )
+            {
+                sink += small_heap_Pop( &small );
+            }
+        }
+        else
+        {
+            Heap_Init( &heap );
+            for( uint32_t idx = 0U; idx < HEAP_LEN; idx++ )
+            {
+                Heap_Push( &heap, Bench_Rand( &seed ) );
+            }
+            for( uint32_t idx = 0U; idx < HEAP_LEN; idx++ )
+            {
+                sink += Heap_Pop( &heap );
+            }
+        }
+    }
+    Bench_Report( generated ? "Heap generated, 8 elements" : "Heap_Push/Heap_Pop, 8 elements",
+            Bench_Now() - start, (uint64_t)SMALL_ROUNDS * HEAP_LEN );
+    (void)sink;
+}
+
+/* Timers in steady state, n armed and each expiry re-arms one period
+ * later, reported per pop + push pair. dary selects the d-ary heap */
+static void Bench_Timers( uint32_t n, bool use_dary )
+{
+    uint32_t seed = 0x12345678U;
+    volatile uint32_t sink = 0U;
+    heap_t heap;
+
+    if( use_dary )
+    {
+        HeapDary_Init( &dary, dary_keys, n );
+    }
+    else if( n <= HEAP_LEN )
+    {
+        Heap_Init( &heap );
+    }
+    else
+    {
+        key_heap_Init( &keys );
+    }
+
+    for( uint32_t idx = 0U; idx < n; idx++ )
+    {
+        const uint32_t deadline = Bench_Rand( &seed ) % TIMER_PERIOD;
+        if( use_dary )
+        {
+            HeapDary_Push( &dary, deadline );
+        }
+        else if( n <= HEAP_LEN )
+        {
+            Heap_Push( &heap, deadline );
+        }
+        else
+        {
+            key_heap_Push( &keys, deadline );
+        }
+    }
+
+    uint64_t start = Bench_Now();
+    for( uint32_t round = 0U; round < TIMER_ROUNDS; round++ )
+    {
+        const uint32_t period = 1U + ( Bench_Rand( &seed ) % TIMER_PERIOD );
+        uint32_t now;
+        if( use_dary )
+        {
+            now = HeapDary_Pop( &dary );
+            HeapDary_Push( &dary, now + period );
+        }
+        else if( n <= HEAP_LEN )
+        {
+            now = Heap_Pop( &heap );
+            Heap_Push( &heap, now + period );
+        }
+        else
+        {
+            now = key_heap_Pop( &keys );
+            key_heap_Push( &keys, now + period );
+        }
+        sink += now;
+    }
+
+    char name[ 64 ];
+    if( use_dary )
+    {
+        snprintf( name, sizeof( name ), "Timers %u-ary %s, %u armed", HEAP_DARY_D,
+                backend_names[ HeapDary_Backend() ], n );
+    }
+    else
+    {
+        snprintf( name, sizeof( name ), "Timers %s, %u armed",
+                ( n <= HEAP_LEN ) ? "Heap_Push/Heap_Pop" : "binary", n );
+    }
+    Bench_Report( name, Bench_Now() - start, TIMER_ROUNDS );
+    (void)sink;
+}
+
+static void Bench_TimerSuite( uint32_t n )
+{
+    static const heap_dary_backend_t backends[] = { HEAP_DARY_SCALAR, HEAP_DARY_SSE41, HEAP_DARY_AVX2 };
+
+    Bench_Timers( n, false );
+    for( uint32_t idx = 0U; idx < ( sizeof( backends ) / sizeof( backends[ 0 ] ) ); idx++ )
+    {
+        if( HeapDary_SelectBackend( backends[ idx ] ) )
+        {
+            Bench_Timers( n, true );
+        }
+    }
+    (void)HeapDary_SelectBackend( HEAP_DARY_AUTO );
+}
+
+extern void HEAPBenchSuite(void)
+{
+    Bench_Small( false );
+    Bench_Small( true );
+
+    Bench_SmallRestore( false );
+    Bench_SmallRestore( true );
+    for( uint32_t n = 1024U; n <= MAX_ELEMENTS; n <<= 2U )
+    {
+        Bench_Restore( n, false );
+        Bench_Restore( n, true );
+    }
+
+    Bench_TimerSuite( HEAP_LEN );
+    for( uint32_t n = 1024U; n <= MAX_ELEMENTS; n <<= 4U )
+    {
+        Bench_TimerSuite( n );
+    }
+
+    for( uint32_t n = 1024U; n <= MAX_ELEMENTS; n <<= 1U )
+    {
+        Bench_Keys( n );
+        Bench_Deadlines( n );
+    }
+}
@@ -0,0 +1,6 @@
+#ifndef HEAP_BENCH_H
+#define HEAP_BENCH_H
+
+extern void HEAPBenchSuite(void);
+
+#endif /* HEAP_BENCH_H */
@@ -0,0 +1,235 @@
+#include "state_bench.h"
+#include "bench.h"
+#include "state.h"
+#include "state_table.h"
+#include "fifo_base.h"
+
+#define EVENTS(EVNT) \
+    EVNT( Tick ) \
+    EVNT( Next ) \
+    EVNT( Reset ) \
+
+GENERATE_EVENTS( EVENTS );
+
+#define NUM_EVENTS ( 1U << 16U )
+#define ITERATIONS ( 64U )
+
+#define FIFO_LEN ( 256U )
+
+typedef struct
+{
+    fifo_base_t base;
+    event_t queue[ FIFO_LEN ];
+    event_t in;
+    event_t out;
+}
+event_fifo_t;
+
+static event_t events[ NUM_EVENTS ];
+static volatile uint32_t ticks;
+
+DEFINE_STATE( S0 );
+DEFINE_STATE( S1 );
+DEFINE_STATE( S2 );
+DEFINE_STATE( S3 );
+
+#define FLAT_STATE( x, next ) \
+    static state_ret_t STATE( x ) ( state_t * this, event_t s ) \
+    { \
+        state_ret_t ret; \
+        switch( s ) \
+        { \
+            case EVENT( Enter ): \
+            case EVENT( Exit ): \
+                ret = HANDLED( this ); \
+                break; \
+            case EVENT( Tick ): \
+                ticks++; \
+                ret = HANDLED( this ); \
+                break; \
+            case EVENT( Next ): \
+                ret = TRANSITION( this, STATE( next ) ); \
+                break; \
+            case EVENT( Reset ): \
+                ret = TRANSITION( this, STATE( S0 ) ); \
+                break; \
+            default: \
+                ret = NO_PARENT( this ); \
+                break; \
+        } \
+        return ret; \
+    }
+
+FLAT_STATE( S0, S1 )
+FLAT_STATE( S1, S2 )
+FLAT_STATE( S2, S3 )
+FLAT_STATE( S3, S0 )
+
+#define STATES(ST) \
+    ST( S0 ) \
+    ST( S1 ) \
+    ST( S2 ) \
+    ST( S3 ) \
+
+GENERATE_TABLE_STATES( STATES );
+
+static void Tick( state_table_t * this, event_t s )
+{
+    (void)this;
+    (void)s;
+    ticks++;
+}
+
+#define TRANSITIONS(TR) \
+    TR( S0, Tick,  None, Tick ) \
+    TR( S0, Next,  S1,   NULL ) \
+    TR( S0, Reset, S0,   NULL ) \
+    TR( S1, Tick,  None, Tick ) \
+    TR( S1, Next,  S2,   NULL ) \
+    TR( S1, Reset, S0,   NULL ) \
+    TR( S2, Tick,  None, Tick ) \
+    TR( S2, Next,  S3,   NULL ) \
+    TR( S2, Reset, S0,   NULL ) \
+    TR( S3, Tick,  None, Tick ) \
+    TR( S3, Next,  S0,   NULL ) \
+    TR( S3, Reset, S0,   NULL ) \
+
+GENERATE_STATE_TABLE( table, TRANSITIONS );
+
+static void GenerateEvents( uint32_t transition_percent )
+{
+    uint32_t seed = 0x12345678U;
+    for( uint32_t idx = 0U; idx < NUM_EVENTS; idx++ )
+    {
+        uint32_t r = Bench_Rand( &seed ) % 100U;
+        if( r < transition_percent )
+        {
+            events[ idx ] = ( r & 1U ) ? EVENT( Next ) : EVENT( Reset );
+        }
+        else
+        {
+            events[ idx ] = EVENT( Tick );
+        }
+    }
+}
+
+static void Bench_Dispatch( const char * name )
+{
+    state_t state;
+    STATEMACHINE_Init( &state, STATE( S0 ) );
+
+    uint64_t start = Bench_Now();
+    for( uint32_t it = 0U; it < ITERATIONS; it++ )
+    {
+        for( uint32_t idx = 0U; idx < NUM_EVENTS; idx++ )
+        {
+            STATEMACHINE_Dispatch( &state, events[ idx ] );
+        }
+    }
+    Bench_Report( name, Bench_Now() - start, (uint64_t)ITERATIONS * NUM_EVENTS );
+}
+
+static void Bench_Table( const char * name )
+{
+    state_table_t machine;
+    STATETABLE_Init( &machine, table, S0 );
+
+    uint64_t start = Bench_Now();
+    for( uint32_t it = 0U; it < ITERATIONS; it++ )
+    {
+        for( uint32_t idx = 0U; idx < NUM_EVENTS; idx++ )
+        {
+            STATETABLE_Dispatch( &machine, events[ idx ] );
+        }
+    }
+    Bench_Report( name, Bench_Now() - start, (uint64_t)ITERATIONS * NUM_EVENTS );
+}
+
+static void Enqueue( fifo_base_t * const base )
+{
+    ENQUEUE_BOILERPLATE( event_fifo_t, base );
+}
+
+static void Dequeue( fifo_base_t * const base )
+{
+    DEQUEUE_BOILERPLATE( event_fifo_t, base );
+}
+
+static void Flush( fifo_base_t * const base )
+{
+    FLUSH_BOILERPLATE( event_fifo_t, base );
+}
+
+static void InitFIFO( event_fifo_t * const fifo )
+{
+    static const fifo_vfunc_t vfunc =
+    {
+        .enq = Enqueue,
+        .deq = Dequeue,
+        .flush = Flush,
+    };
+    FIFO_Init( (fifo_base_t *)fifo, FIFO_LEN );
+    fifo->base.vfunc = &vfunc;
+}
+
+static void Bench_DequeueDispatch( const char * name )
+{
+    state_t state;
+    event_fifo_t fifo;
+    STATEMACHINE_Init( &state, STATE( S0 ) );
+    InitFIFO( &fifo );
+
+    uint64_t start = Bench_Now();
+    for( uint32_t it = 0U; it < ITERATIONS; it++ )
+    {
+        for( uint32_t idx = 0U; idx < NUM_EVENTS; idx += FIFO_LEN )
+        {
+            for( uint32_t jdx = 0U; jdx < FIFO_LEN; jdx++ )
+            {
+                FIFO_Enqueue( &fifo, events[ idx + jdx ] );
+            }
+            while( !FIFO_IsEmpty( &fifo.base ) )
+            {
+                STATEMACHINE_Dispatch( &state, FIFO_Dequeue( &fifo ) );
+            }
+        }
+    }
+    Bench_Report( name, Bench_Now() - start, (uint64_t)ITERATIONS * NUM_EVENTS );
+}
+
+static void Bench_DispatchBatch( const char * name )
+{
+    state_t state;
+    event_fifo_t fifo;
+    STATEMACHINE_Init( &state, STATE( S0 ) );
+    InitFIFO( &fifo );
+
+    uint64_t start = Bench_Now();
+    for( uint32_t it = 0U; it < ITERATIONS; it++ )
+    {
+        for( uint32_t idx = 0U; idx < NUM_EVENTS; idx += FIFO_LEN )
+        {
+            for( uint32_t jdx = 0U; jdx < FIFO_LEN; jdx++ )
+            {
+                FIFO_Enqueue( &fifo, events[ idx + jdx ] );
+            }
+            (void)STATEMACHINE_DispatchBatch( &state, &fifo, FIFO_LEN, NULL, NULL );
+        }
+    }
+    Bench_Report( name, Bench_Now() - start, (uint64_t)ITERATIONS * NUM_EVENTS );
+}
+
+extern void STATEBenchSuite(void)
+{
+    GenerateEvents( 10U );
+    Bench_Dispatch( "STATEMACHINE_Dispatch 10% transitions" );
+    Bench_Table( "STATETABLE_Dispatch 10% transitions" );
+
+    GenerateEvents( 50U );
+    Bench_Dispatch( "STATEMACHINE_Dispatch 50% transitions" );
+    Bench_Table( "STATETABLE_Dispatch 50% transitions" );
+
+    GenerateEvents( 10U );
+    Bench_DequeueDispatch( "FIFO_Dequeue + STATEMACHINE_Dispatch" );
+    Bench_DispatchBatch( "STATEMACHINE_DispatchBatch" );
+}
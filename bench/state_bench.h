@@ -0,0 +1,6 @@
+#ifndef STATE_BENCH_H
+#define STATE_BENCH_H
+
+extern void STATEBenchSuite(void);
+
+#endif /* STATE_BENCH_H */
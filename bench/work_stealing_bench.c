@@ -0,0 +1,203 @@
+#include "work_stealing_bench.h"
+#include "bench.h"
+#include "executor.h"
+#include "work_stealing.h"
+#include "state.h"
+#include <sched.h>
+#include <unistd.h>
+
+#define EVENTS(EVNT) \
+    EVNT( Work ) \
+
+GENERATE_EVENTS( EVENTS );
+
+#define NUM_MACHINES ( 256U )
+/* Most of the traffic lands on a handful of machines */
+#define NUM_HOT ( 8U )
+#define HOT_PERCENT ( 90U )
+#define NUM_PRODUCERS ( 2U )
+#define EVENTS_PER_PRODUCER ( 1U << 19U )
+#define WORK_LOOPS ( 64U )
+
+typedef struct
+{
+    state_t state;
+    uint32_t acc;
+}
+worker_machine_t;
+
+typedef struct
+{
+    bool stealing;
+    uint32_t seed;
+}
+producer_t;
+
+static executor_t exec;
+static executor_object_t exec_object[ NUM_MACHINES ];
+static work_stealing_t ws;
+static ws_object_t ws_object[ NUM_MACHINES ];
+static worker_machine_t machine[ NUM_MACHINES ];
+
+DEFINE_STATE( Working );
+
+static state_ret_t State_Working( state_t * this, event_t s )
+{
+    state_ret_t ret;
+    worker_machine_t * m = (worker_machine_t *)this;
+
+    switch( s )
+    {
+        case EVENT( Enter ):
+        case EVENT( Exit ):
+            ret = HANDLED( this );
+            break;
+        case EVENT( Work ):
+            for( uint32_t idx = 0U; idx < WORK_LOOPS; idx++ )
+            {
+                m->acc = ( m->acc * 1664525U ) + 1013904223U;
+            }
+            ret = HANDLED( this );
+            break;
+        default:
+            ret = NO_PARENT( this );
+            break;
+    }
+    return ret;
+}
+
+static uint32_t PickMachine( uint32_t * seed )
+{
+    uint32_t target;
+    if( ( Bench_Rand( seed ) % 100U ) < HOT_PERCENT )
+    {
+        target = Bench_Rand( seed ) % NUM_HOT;
+    }
+    else
+    {
+        target = NUM_HOT + ( Bench_Rand( seed ) % ( NUM_MACHINES - NUM_HOT ) );
+    }
+    return target;
+}
+
+static void * Producer( void * arg )
+{
+    producer_t * producer = (producer_t *)arg;
+
+    for( uint32_t idx = 0U; idx < EVENTS_PER_PRODUCER; idx++ )
+    {
+        uint32_t target = PickMachine( &producer->seed );
+        if( producer->stealing )
+        {
+            while( !WorkStealing_Post( &ws, &ws_object[ target ], EVENT( Work ) ) )
+            {
+                sched_yield();
+            }
+        }
+        else
+        {
+            while( !Executor_Post( &exec, &exec_object[ target ], EVENT( Work ) ) )
+            {
+                sched_yield();
+            }
+        }
+    }
+    return NULL;
+}
+
+static void RunProducers( bool stealing )
+{
+    producer_t producer[ NUM_PRODUCERS ];
+    pthread_t thread[ NUM_PRODUCERS ];
+
+    for( uint32_t idx = 0U; idx < NUM_PRODUCERS; idx++ )
+    {
+        producer[ idx ].stealing = stealing;
+        producer[ idx ].seed = 0x9E3779B9U * ( idx + 1U );
+        pthread_create( &thread[ idx ], NULL, Producer, &producer[ idx ] );
+    }
+    for( uint32_t idx = 0U; idx < NUM_PRODUCERS; idx++ )
+    {
+        pthread_join( thread[ idx ], NULL );
+    }
+}
+
+static void InitMachines( void )
+{
+    for( uint32_t idx = 0U; idx < NUM_MACHINES; idx++ )
+    {
+        STATEMACHINE_Init( &machine[ idx ].state, STATE( Working ) );
+        machine[ idx ].acc = 0U;
+    }
+}
+
+/* Static assignment where the hot machines happen to share a worker */
+static void Bench_ExecutorSkewed( uint32_t num_workers )
+{
+    InitMachines();
+    Executor_Init( &exec, num_workers, NULL );
+    for( uint32_t idx = 0U; idx < NUM_MACHINES; idx++ )
+    {
+        uint32_t worker = ( idx < NUM_HOT ) ? 0U : ( idx % num_workers );
+        Executor_Register( &exec, &exec_object[ idx ], &machine[ idx ].state, worker );
+    }
+
+    uint64_t start = Bench_Now();
+    (void)Executor_Start( &exec );
+    RunProducers( false );
+    Executor_Stop( &exec );
+    uint64_t elapsed = Bench_Now() - start;
+
+    char name[ 64 ];
+    snprintf( name, sizeof( name ), "Executor skewed, %u workers", num_workers );
+    Bench_Report( name, elapsed, (uint64_t)NUM_PRODUCERS * EVENTS_PER_PRODUCER );
+}
+
+static void Bench_WorkStealingSkewed( uint32_t num_workers )
+{
+    InitMachines();
+    WorkStealing_Init( &ws, num_workers );
+    for( uint32_t idx = 0U; idx < NUM_MACHINES; idx++ )
+    {
+        WorkStealing_Register( &ws, &ws_object[ idx ], &machine[ idx ].state );
+    }
+
+    uint64_t start = Bench_Now();
+    WorkStealing_Start( &ws );
+    RunProducers( true );
+    WorkStealing_Stop( &ws );
+    uint64_t elapsed = Bench_Now() - start;
+
+    char name[ 64 ];
+    snprintf( name, sizeof( name ), "Work stealing skewed, %u workers", num_workers );
+    Bench_Report( name, elapsed, (uint64_t)NUM_PRODUCERS * EVENTS_PER_PRODUCER );
+
+    for( uint32_t idx = 0U; idx < num_workers; idx++ )
+    {
+        ws_stats_t stats;
+        WorkStealing_GetStats( &ws, idx, &stats );
+        printf( "    worker %2u %10llu events %8llu/%-8llu steals %6.1f%% busy\n",
+                idx,
+                (unsigned long long)stats.dispatched,
+                (unsigned long long)stats.steals,
+                (unsigned long long)stats.steal_attempts,
+                stats.utilization );
+    }
+}
+
+extern void WORKSTEALINGBenchSuite(void)
+{
+    long online = sysconf( _SC_NPROCESSORS_ONLN );
+    uint32_t num_cpus = ( online > 0 ) ? (uint32_t)online : 1U;
+    uint32_t max_workers = ( num_cpus < WS_MAX_WORKERS ) ? num_cpus : WS_MAX_WORKERS;
+
+    /* Always run at least two workers so there is someone to steal */
+    max_workers = ( max_workers < 2U ) ? 2U : max_workers;
+    max_workers = ( max_workers > EXECUTOR_MAX_WORKERS ) ? EXECUTOR_MAX_WORKERS : max_workers;
+
+    for( uint32_t workers = 2U; workers <= max_workers; workers <<= 1U )
+    {
+        Bench_ExecutorSkewed( workers );
+        Bench_WorkStealingSkewed( workers );
+    }
+}
@@ -0,0 +1,6 @@
+#ifndef WORK_STEALING_BENCH_H
+#define WORK_STEALING_BENCH_H
+
+extern void WORKSTEALINGBenchSuite(void);
+
+#endif /* WORK_STEALING_BENCH_H */
@@ -1,13 +1,13 @@
 #include "emitter_base.h"
 
-static void Destroy(emitter_base_t * const base);
+static void Destroy(emitter_base_t * const base, event_t event);
 static void Create(emitter_base_t * const base, event_t event, uint32_t period);
 static bool Emit(emitter_base_t * const base, event_t event);
 
 extern void Emitter_Init(emitter_base_t * const base, fifo_base_t * fifo)
 {
     assert(base != NULL);
-    assert(base->fifo != NULL);
+    assert(fifo != NULL);
 
     static const emitter_vfunc_t vfunc =
     {
@@ -26,9 +26,10 @@ static bool Emit(emitter_base_t * const base, event_t event)
     return false;
 }
 
-static void Destroy(emitter_base_t * const base)
+static void Destroy(emitter_base_t * const base, event_t event)
 {
     (void)base;
+    (void)event;
     assert(false);
 }
 
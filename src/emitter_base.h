@@ -20,7 +20,7 @@ struct emitter_vfunc_t
 {
     bool (*emit)(emitter_base_t * const base, event_t event);
     void (*create)(emitter_base_t * const base, event_t event, uint32_t period);
-    void (*destroy)(emitter_base_t * const base);
+    void (*destroy)(emitter_base_t * const base, event_t event);
 };
 
 extern void Emitter_Init(emitter_base_t * const base, fifo_base_t * const fifo);
@@ -46,7 +46,7 @@ inline static void Emitter_Destroy( emitter_base_t * const base, event_t event )
     assert( base != NULL );
     assert( base->vfunc != NULL);
     assert( base->vfunc->destroy != NULL);
-    (base->vfunc->destroy)(base);
+    (base->vfunc->destroy)(base, event);
 }
 
 #endif /* EMITTER_BASE_H_ */
@@ -0,0 +1,365 @@
+#include "emitter_wheel.h"
+
+#define MASK ( EMITTER_WHEEL_SLOTS - 1U )
+#define IDLE ( UINT32_MAX )
+
+_Static_assert( EMITTER_WHEEL_SLOTS == 64U, "Slot occupancy is a 64-bit bitmap" );
+_Static_assert( ( EMITTER_WHEEL_LEVELS > 0U ) && ( ( EMITTER_WHEEL_LEVELS * EMITTER_WHEEL_BITS ) < 64U ),
+        "Wheel must span fewer than 2^64 ticks" );
+
+static void Destroy( emitter_base_t * const base, event_t event );
+static void Create( emitter_base_t * const base, event_t event, uint32_t period );
+static bool Emit( emitter_base_t * const base, event_t event );
+
+static emitter_handle_t Handle( emitter_wheel_t const * const wheel, uint32_t idx )
+{
+    return ( (uint64_t)wheel->timer[idx].generation << 32U ) | idx;
+}
+
+/* Index of a live handle, or capacity when stale or invalid */
+static uint32_t Index( emitter_wheel_t const * const wheel, emitter_handle_t handle )
+{
+    const uint32_t idx = (uint32_t)handle;
+    if( ( idx >= wheel->capacity ) ||
+        ( wheel->timer[idx].slot == IDLE ) ||
+        ( wheel->timer[idx].generation != (uint32_t)( handle >> 32U ) ) )
+    {
+        return wheel->capacity;
+    }
+    return idx;
+}
+
+static void Link( emitter_wheel_t * const wheel, uint32_t idx )
+{
+    emitter_timer_t * const timer = &wheel->timer[idx];
+    const uint64_t diff = timer->expiry ^ wheel->now;
+    uint32_t level = 0U;
+    uint64_t slot;
+
+    if( diff != 0U )
+    {
+        level = ( 63U - (uint32_t)__builtin_clzll( diff ) ) / EMITTER_WHEEL_BITS;
+    }
+
+    if( level < ( EMITTER_WHEEL_LEVELS - 1U ) )
+    {
+        slot = ( timer->expiry >> ( EMITTER_WHEEL_BITS * level ) ) & MASK;
+    }
+    else
+    {
+        /* The top level goes by distance rather than digits, as a carry
+         * can make near expiries differ above it. Anything further than
+         * the top level reaches parks in the slot before the current one,
+         * the last to come round, and is placed again from there */
+        const uint32_t shift = EMITTER_WHEEL_BITS * ( EMITTER_WHEEL_LEVELS - 1U );
+        const uint64_t current = wheel->now >> shift;
+        const uint64_t ahead = ( timer->expiry >> shift ) - current;
+
+        level = EMITTER_WHEEL_LEVELS - 1U;
+        slot = ( current + ( ( ahead < MASK ) ? ahead : MASK ) ) & MASK;
+    }
+
+    const uint32_t s = ( level * EMITTER_WHEEL_SLOTS ) + (uint32_t)slot;
+    timer->slot = s;
+    timer->prev = EMITTER_WHEEL_INVALID;
+    timer->next = wheel->head[s];
+    if( timer->next != EMITTER_WHEEL_INVALID )
+    {
+        wheel->timer[timer->next].prev = idx;
+    }
+    wheel->head[s] = idx;
+    wheel->occupied[level] |= ( 1ULL << slot );
+}
+
+static void Unlink( emitter_wheel_t * const wheel, uint32_t idx )
+{
+    emitter_timer_t * const timer = &wheel->timer[idx];
+    const uint32_t s = timer->slot;
+
+    if( timer->prev != EMITTER_WHEEL_INVALID )
+    {
+        wheel->timer[timer->prev].next = timer->next;
+    }
+    else
+    {
+        wheel->head[s] = timer->next;
+    }
+    if( timer->next != EMITTER_WHEEL_INVALID )
+    {
+        wheel->timer[timer->next].prev = timer->prev;
+    }
+    if( wheel->head[s] == EMITTER_WHEEL_INVALID )
+    {
+        wheel->occupied[s / EMITTER_WHEEL_SLOTS] &= ~( 1ULL << ( s & MASK ) );
+    }
+}
+
+static void Release( emitter_wheel_t * const wheel, uint32_t idx )
+{
+    emitter_timer_t * const timer = &wheel->timer[idx];
+
+    timer->slot = IDLE;
+    timer->generation++;
+    timer->next = wheel->free;
+    wheel->free = idx;
+    wheel->active--;
+}
+
+/* Detaches a whole slot, its timers are re-linked or emitted by the caller */
+static uint32_t Take( emitter_wheel_t * const wheel, uint32_t level, uint32_t slot )
+{
+    const uint32_t s = ( level * EMITTER_WHEEL_SLOTS ) + slot;
+    const uint32_t list = wheel->head[s];
+
+    wheel->head[s] = EMITTER_WHEEL_INVALID;
+    wheel->occupied[level] &= ~( 1ULL << slot );
+    return list;
+}
+
+/* Called with now just moved onto a new tick. Where the lower digits have
+ * wrapped to 0 the next slot up is spread back down, top level first so
+ * its timers can carry on down to level 0, then level 0 is emitted */
+static uint32_t Tick( emitter_wheel_t * const wheel )
+{
+    const uint64_t now = wheel->now;
+    uint32_t wrapped = 0U;
+
+    while( ( wrapped < ( EMITTER_WHEEL_LEVELS - 1U ) ) &&
+            ( ( ( now >> ( EMITTER_WHEEL_BITS * wrapped ) ) & MASK ) == 0U ) )
+    {
+        wrapped++;
+    }
+
+    for( uint32_t level = wrapped; level > 0U; level-- )
+    {
+        const uint32_t slot = (uint32_t)( now >> ( EMITTER_WHEEL_BITS * level ) ) & MASK;
+        uint32_t idx = Take( wheel, level, slot );
+        while( idx != EMITTER_WHEEL_INVALID )
+        {
+            const uint32_t next = wheel->timer[idx].next;
+            Link( wheel, idx );
+            idx = next;
+        }
+    }
+
+    uint32_t emitted = 0U;
+    uint32_t idx = Take( wheel, 0U, (uint32_t)now & MASK );
+    while( idx != EMITTER_WHEEL_INVALID )
+    {
+        emitter_timer_t * const timer = &wheel->timer[idx];
+        const uint32_t next = timer->next;
+
+        if( Emitter_Emit( &wheel->base, timer->event ) )
+        {
+            wheel->fired++;
+        }
+        else
+        {
+            wheel->dropped++;
+        }
+        emitted++;
+
+        if( timer->period > 0U )
+        {
+            timer->expiry += timer->period;
+            Link( wheel, idx );
+        }
+        else
+        {
+            Release( wheel, idx );
+        }
+        idx = next;
+    }
+    return emitted;
+}
+
+/* Rotates a level's bitmap so bit k stands for the slot k + 1 ahead of
+ * digit, returning how many slots ahead the nearest occupied one is */
+static uint64_t Ahead( uint64_t occupied, uint32_t digit )
+{
+    const uint32_t shift = ( digit + 1U ) & MASK;
+    const uint64_t rotated = ( shift == 0U ) ? occupied : ( ( occupied >> shift ) | ( occupied << ( 64U - shift ) ) );
+    return (uint64_t)__builtin_ctzll( rotated ) + 1U;
+}
+
+/* The next tick anything happens on, an expiry at level 0 or a cascade of
+ * an occupied slot above it. Every linked slot is ahead of now's digit at
+ * its level, so the nearest one comes round first and nothing in between
+ * needs visiting. Must have a timer armed */
+static uint64_t Next( emitter_wheel_t const * const wheel )
+{
+    const uint64_t now = wheel->now;
+    uint64_t next = UINT64_MAX;
+
+    for( uint32_t level = 0U; level < EMITTER_WHEEL_LEVELS; level++ )
+    {
+        if( wheel->occupied[level] != 0U )
+        {
+            const uint32_t shift = EMITTER_WHEEL_BITS * level;
+            const uint64_t ahead = Ahead( wheel->occupied[level], (uint32_t)( now >> shift ) & MASK );
+            const uint64_t at = ( ( now >> shift ) + ahead ) << shift;
+            next = ( at < next ) ? at : next;
+        }
+    }
+    return next;
+}
+
+extern void EMITTER_WHEEL_InitQueue( emitter_wheel_t * const wheel,
+        fifo_base_t * const fifo,
+        event_t * const queue,
+        emitter_timer_t * const timers,
+        uint32_t capacity,
+        emitter_clock_t clock,
+        void * arg )
+{
+    assert( wheel != NULL );
+    assert( queue != NULL );
+    assert( timers != NULL );
+    assert( clock != NULL );
+    assert( capacity > 0U );
+    assert( capacity < EMITTER_WHEEL_INVALID );
+
+    static const emitter_vfunc_t vfunc =
+    {
+        .emit = Emit,
+        .create = Create,
+        .destroy = Destroy,
+    };
+    Emitter_Init( &wheel->base, fifo );
+    wheel->base.vfunc = &vfunc;
+
+    wheel->queue = queue;
+    wheel->timer = timers;
+    wheel->capacity = capacity;
+    wheel->active = 0U;
+    wheel->clock = clock;
+    wheel->arg = arg;
+    wheel->now = clock( arg );
+    wheel->fired = 0U;
+    wheel->dropped = 0U;
+
+    for( uint32_t idx = 0U; idx < capacity; idx++ )
+    {
+        timers[idx] = (emitter_timer_t){ .slot = IDLE, .next = idx + 1U };
+    }
+    timers[capacity - 1U].next = EMITTER_WHEEL_INVALID;
+    wheel->free = 0U;
+
+    for( uint32_t idx = 0U; idx < ( EMITTER_WHEEL_LEVELS * EMITTER_WHEEL_SLOTS ); idx++ )
+    {
+        wheel->head[idx] = EMITTER_WHEEL_INVALID;
+    }
+    for( uint32_t idx = 0U; idx < EMITTER_WHEEL_LEVELS; idx++ )
+    {
+        wheel->occupied[idx] = 0U;
+    }
+    for( uint32_t idx = 0U; idx < EMITTER_WHEEL_EVENTS; idx++ )
+    {
+        wheel->by_event[idx] = EMITTER_HANDLE_INVALID;
+    }
+}
+
+extern emitter_handle_t EMITTER_WHEEL_Start( emitter_wheel_t * const wheel, event_t event, uint32_t delay, uint32_t period )
+{
+    assert( wheel != NULL );
+
+    const uint32_t idx = wheel->free;
+    if( idx == EMITTER_WHEEL_INVALID )
+    {
+        return EMITTER_HANDLE_INVALID;
+    }
+
+    emitter_timer_t * const timer = &wheel->timer[idx];
+    wheel->free = timer->next;
+    wheel->active++;
+
+    timer->event = event;
+    timer->period = period;
+    timer->expiry = wheel->now + ( ( delay > 0U ) ? delay : 1U );
+    Link( wheel, idx );
+
+    return Handle( wheel, idx );
+}
+
+extern bool EMITTER_WHEEL_Stop( emitter_wheel_t * const wheel, emitter_handle_t handle )
+{
+    assert( wheel != NULL );
+
+    const uint32_t idx = Index( wheel, handle );
+    if( idx == wheel->capacity )
+    {
+        return false;
+    }
+    Unlink( wheel, idx );
+    Release( wheel, idx );
+    return true;
+}
+
+extern bool EMITTER_WHEEL_IsActive( emitter_wheel_t const * const wheel, emitter_handle_t handle )
+{
+    assert( wheel != NULL );
+    return ( Index( wheel, handle ) < wheel->capacity );
+}
+
+extern uint32_t EMITTER_WHEEL_Advance( emitter_wheel_t * const wheel, uint64_t now )
+{
+    assert( wheel != NULL );
+    uint32_t emitted = 0U;
+
+    while( wheel->now < now )
+    {
+        if( wheel->active == 0U )
+        {
+            wheel->now = now;
+            break;
+        }
+
+        /* Skip straight to the next expiry or cascade, however far off */
+        const uint64_t next = Next( wheel );
+        if( next > now )
+        {
+            wheel->now = now;
+            break;
+        }
+        wheel->now = next;
+        emitted += Tick( wheel );
+    }
+    return emitted;
+}
+
+extern uint32_t EMITTER_WHEEL_Poll( emitter_wheel_t * const wheel )
+{
+    assert( wheel != NULL );
+    return EMITTER_WHEEL_Advance( wheel, wheel->clock( wheel->arg ) );
+}
+
+/* Written straight into the ring, as with the priority lanes */
+static bool Emit( emitter_base_t * const base, event_t event )
+{
+    assert( base != NULL );
+    emitter_wheel_t * const wheel = (emitter_wheel_t *)base;
+
+    return FIFO_Post( base->fifo, wheel->queue, &event, sizeof( event ) );
+}
+
+static void Create( emitter_base_t * const base, event_t event, uint32_t period )
+{
+    assert( base != NULL );
+    assert( event < EMITTER_WHEEL_EVENTS );
+    assert( period > 0U );
+    emitter_wheel_t * const wheel = (emitter_wheel_t *)base;
+
+    (void)EMITTER_WHEEL_Stop( wheel, wheel->by_event[event] );
+    wheel->by_event[event] = EMITTER_WHEEL_Start( wheel, event, period, period );
+    assert( wheel->by_event[event] != EMITTER_HANDLE_INVALID );
+}
+
+static void Destroy( emitter_base_t * const base, event_t event )
+{
+    assert( base != NULL );
+    assert( event < EMITTER_WHEEL_EVENTS );
+    emitter_wheel_t * const wheel = (emitter_wheel_t *)base;
+
+    (void)EMITTER_WHEEL_Stop( wheel, wheel->by_event[event] );
+    wheel->by_event[event] = EMITTER_HANDLE_INVALID;
+}
@@ -0,0 +1,117 @@
+#ifndef EMITTER_WHEEL_H
+#define EMITTER_WHEEL_H
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "state.h"
+#include "fifo_base.h"
+#include "emitter_base.h"
+
+/* Emitter backed by a hierarchical timing wheel. Each of the
+ * EMITTER_WHEEL_LEVELS levels has 64 slots, a slot at level L covering
+ * 64^L ticks. A timer sits in the level of the most significant base 64
+ * digit where its expiry differs from the current tick, and drops a level
+ * each time that digit comes round. Start, stop and expiry are O(1) and
+ * only touch the timer and its slot list, however many are armed.
+ *
+ * Ticks come from a caller provided monotonic clock, read by Poll, which
+ * emits every timer that has expired since the last Poll into the target
+ * FIFO. Delays count from the tick of the last Poll (or Init). Timers
+ * further out than the wheel spans park in the top level and are placed
+ * again as it turns.
+ *
+ * Expired events are written straight into the target FIFO's ring,
+ * applying its overflow policy but not through its vfunc, so it must be a
+ * FIFO of event_t laid out as GENERATE_FIFO does. Poll must run on the
+ * thread that owns the FIFO, and a FIFO attached to a fifo_wait_t cannot
+ * be a target, the wrapper's lock and eventfd would be skipped.
+ *
+ * The timers are caller provided storage, e.g.
+ *
+ * static emitter_timer_t timers[ 4096U ];
+ * EMITTER_WHEEL_Init( &wheel, &fifo, timers, 4096U, Clock, NULL );
+ *
+ * Emitter_Create( &wheel.base, event, period ) arms a periodic timer for
+ * event, replacing any earlier one, and Emitter_Destroy cancels it. Start
+ * and Stop take handles for any number of one-shot or periodic timers.
+ * A handle is the timer's index in the low 32 bits and a generation,
+ * bumped each time the timer is released, in the high 32, so a stale
+ * handle is only mistaken for a live one after 2^32 reuses of its timer */
+
+#ifndef EMITTER_WHEEL_LEVELS
+#define EMITTER_WHEEL_LEVELS (5U)
+#endif /* EMITTER_WHEEL_LEVELS */
+
+/* Events that can be armed through Emitter_Create */
+#ifndef EMITTER_WHEEL_EVENTS
+#define EMITTER_WHEEL_EVENTS (64U)
+#endif /* EMITTER_WHEEL_EVENTS */
+
+#define EMITTER_WHEEL_BITS (6U)
+#define EMITTER_WHEEL_SLOTS (1U << EMITTER_WHEEL_BITS)
+#define EMITTER_WHEEL_INVALID (UINT32_MAX)
+#define EMITTER_HANDLE_INVALID (UINT64_MAX)
+
+#define EMITTER_WHEEL_Init( wheel, f, timers, capacity, clock, arg ) \
+    EMITTER_WHEEL_InitQueue( (wheel), &(f)->base, (f)->queue, (timers), (capacity), (clock), (arg) )
+
+typedef uint64_t ( *emitter_clock_t )( void * arg );
+typedef uint64_t emitter_handle_t;
+
+typedef struct
+{
+    uint64_t expiry;
+    uint32_t period;
+    event_t event;
+    uint32_t next;
+    uint32_t prev;
+    uint32_t slot;
+    uint32_t generation;
+}
+emitter_timer_t;
+
+typedef struct
+{
+    emitter_base_t base;
+    event_t * queue;
+    emitter_timer_t * timer;
+    uint32_t capacity;
+    uint32_t free;
+    uint32_t active;
+    uint64_t now;
+    emitter_clock_t clock;
+    void * arg;
+    uint64_t occupied[EMITTER_WHEEL_LEVELS];
+    uint32_t head[EMITTER_WHEEL_LEVELS * EMITTER_WHEEL_SLOTS];
+    emitter_handle_t by_event[EMITTER_WHEEL_EVENTS];
+    uint64_t fired;
+    uint64_t dropped;
+}
+emitter_wheel_t;
+
+extern void EMITTER_WHEEL_InitQueue( emitter_wheel_t * const wheel,
+        fifo_base_t * const fifo,
+        event_t * const queue,
+        emitter_timer_t * const timers,
+        uint32_t capacity,
+        emitter_clock_t clock,
+        void * arg );
+
+/* Emits event after delay ticks (at least 1), then every period ticks, or
+ * once when period is 0. Returns EMITTER_HANDLE_INVALID when every timer
+ * is in use */
+extern emitter_handle_t EMITTER_WHEEL_Start( emitter_wheel_t * const wheel, event_t event, uint32_t delay, uint32_t period );
+
+/* False when the timer already fired as a one-shot or was stopped */
+extern bool EMITTER_WHEEL_Stop( emitter_wheel_t * const wheel, emitter_handle_t handle );
+extern bool EMITTER_WHEEL_IsActive( emitter_wheel_t const * const wheel, emitter_handle_t handle );
+
+/* Reads the clock and emits everything due, returns the number emitted.
+ * Only the ticks where a timer expires or a slot cascades are visited, so
+ * the cost does not grow with the ticks elapsed */
+extern uint32_t EMITTER_WHEEL_Poll( emitter_wheel_t * const wheel );
+extern uint32_t EMITTER_WHEEL_Advance( emitter_wheel_t * const wheel, uint64_t now );
+
+#endif /* EMITTER_WHEEL_H */
@@ -46,3 +46,30 @@ extern const event_observer_t * const EventObserver_GetSubs(event_observer_t * c
     return observer;
 }
 
+
+extern uint32_t EventObserver_Multicast(event_observer_t * const obs, event_handle_t handle, event_observer_post_t post, void * const arg)
+{
+    assert( obs != NULL );
+    assert( post != NULL );
+
+    const event_observer_t * const observer = EventObserver_GetSubs(obs, handle.event);
+    uint32_t accepted = 0U;
+
+    /* One reference per subscriber up front, so an early consumer cannot
+     * free the block before the rest have been posted */
+    EventPool_Retain(handle, observer->subscriptions);
+    for(uint32_t idx = 0U; idx < observer->subscriptions; idx++)
+    {
+        if( post(observer->subscriber[idx], handle, arg) )
+        {
+            accepted++;
+        }
+        else
+        {
+            EventPool_Release(handle);
+        }
+    }
+    EventPool_Release(handle);
+
+    return accepted;
+}
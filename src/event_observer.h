@@ -2,6 +2,7 @@
 #define EVENT_OBS_H_
 
 #include "state.h"
+#include "event_pool.h"
 #include <assert.h>
 #include <stdio.h>
 
@@ -22,8 +23,16 @@ event_observer_t;
         EV(EVENT_OBS_ARRAY) \
     }
 
+/* Hands a subscriber its copy of a handle, returning false if it could not
+ * be queued */
+typedef bool (*event_observer_post_t)(state_t * const subscriber, event_handle_t handle, void * const arg);
+
 extern void EventObserver_Init(event_observer_t * const obs, uint32_t num_events);
 extern void EventObserver_Subscribe(event_observer_t * const obs, event_t event, state_t * subscriber);
 extern const event_observer_t * const EventObserver_GetSubs(event_observer_t * const obs, event_t e);
+/* Posts one handle to every subscriber of its event, sharing the payload.
+ * Takes over the caller's reference and returns the number of posts that
+ * were accepted */
+extern uint32_t EventObserver_Multicast(event_observer_t * const obs, event_handle_t handle, event_observer_post_t post, void * const arg);
 
 #endif /* EVENT_OBS_H */
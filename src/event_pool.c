@@ -0,0 +1,270 @@
+#include "event_pool.h"
+#include <string.h>
+
+#define FREE_EMPTY ( UINT32_MAX )
+#define HEAD_INDEX( head ) ( (uint32_t)( (head) & 0xFFFFFFFFULL ) )
+#define HEAD_TAG( head ) ( (uint32_t)( (head) >> 32U ) )
+#define HEAD( tag, index ) ( ( (uint64_t)(tag) << 32U ) | (uint64_t)(index) )
+
+static void Enqueue( fifo_base_t * const base );
+static void Dequeue( fifo_base_t * const base );
+static void Peek( fifo_base_t * const base );
+static void Flush( fifo_base_t * const base );
+static uint32_t EnqueueN( fifo_base_t * const base, void const * const values, uint32_t count );
+static uint32_t DequeueN( fifo_base_t * const base, void * const values, uint32_t count );
+
+/* Handle being dispatched on this thread */
+static _Thread_local event_handle_t current;
+
+static inline event_block_t * Block( event_pool_class_t * const size_class, uint32_t index )
+{
+    return (event_block_t *)&size_class->storage[ (size_t)index * size_class->block_size ];
+}
+
+static bool Pop( event_pool_class_t * const size_class, uint32_t * const index )
+{
+    uint64_t head = atomic_load_explicit( &size_class->head, memory_order_acquire );
+    bool success = false;
+
+    while( HEAD_INDEX( head ) != FREE_EMPTY )
+    {
+        const uint32_t next = atomic_load_explicit( &size_class->next[ HEAD_INDEX( head ) ], memory_order_relaxed );
+        if( atomic_compare_exchange_weak_explicit( &size_class->head, &head, HEAD( HEAD_TAG( head ) + 1U, next ),
+                    memory_order_acquire, memory_order_acquire ) )
+        {
+            *index = HEAD_INDEX( head );
+            success = true;
+            break;
+        }
+    }
+
+    return success;
+}
+
+static void Push( event_pool_class_t * const size_class, uint32_t index )
+{
+    uint64_t head = atomic_load_explicit( &size_class->head, memory_order_relaxed );
+    do
+    {
+        atomic_store_explicit( &size_class->next[ index ], HEAD_INDEX( head ), memory_order_relaxed );
+    }
+    while( !atomic_compare_exchange_weak_explicit( &size_class->head, &head, HEAD( HEAD_TAG( head ) + 1U, index ),
+                memory_order_release, memory_order_relaxed ) );
+}
+
+extern void EventPool_Init( event_pool_t * const pool )
+{
+    assert( pool != NULL );
+
+    for( uint32_t idx = 0U; idx < EVENT_POOL_MAX_CLASSES; idx++ )
+    {
+        pool->size_class[ idx ] = NULL;
+    }
+    pool->num_classes = 0U;
+    atomic_init( &pool->failed, 0U );
+}
+
+extern void EventPool_AddClass( event_pool_t * const pool, event_pool_class_t * const size_class )
+{
+    assert( pool != NULL );
+    assert( size_class != NULL );
+    assert( size_class->storage != NULL );
+    assert( size_class->next != NULL );
+    assert( size_class->num_blocks > 0U );
+    assert( size_class->num_blocks < FREE_EMPTY );
+    assert( size_class->block_size >= EVENT_POOL_BLOCK_SIZE( size_class->payload_size ) );
+    assert( pool->num_classes < EVENT_POOL_MAX_CLASSES );
+    assert( ( pool->num_classes == 0U ) ||
+            ( pool->size_class[ pool->num_classes - 1U ]->payload_size < size_class->payload_size ) );
+
+    for( uint32_t idx = 0U; idx < size_class->num_blocks; idx++ )
+    {
+        event_block_t * const block = Block( size_class, idx );
+        block->owner = size_class;
+        atomic_init( &block->refs, 0U );
+        block->size = 0U;
+
+        const uint32_t next = ( ( idx + 1U ) < size_class->num_blocks ) ? ( idx + 1U ) : FREE_EMPTY;
+        atomic_init( &size_class->next[ idx ], next );
+    }
+    atomic_init( &size_class->head, HEAD( 0U, 0U ) );
+    atomic_init( &size_class->in_use, 0U );
+    atomic_init( &size_class->high_water, 0U );
+    atomic_init( &size_class->exhausted, 0U );
+
+    pool->size_class[ pool->num_classes ] = size_class;
+    pool->num_classes++;
+}
+
+extern bool EventPool_Alloc( event_pool_t * const pool, event_t event, uint32_t size, event_handle_t * const handle )
+{
+    assert( pool != NULL );
+    assert( handle != NULL );
+
+    bool success = false;
+    for( uint32_t idx = 0U; ( idx < pool->num_classes ) && !success; idx++ )
+    {
+        event_pool_class_t * const size_class = pool->size_class[ idx ];
+        uint32_t index;
+
+        if( size > size_class->payload_size )
+        {
+            continue;
+        }
+
+        if( Pop( size_class, &index ) )
+        {
+            event_block_t * const block = Block( size_class, index );
+            atomic_store_explicit( &block->refs, 1U, memory_order_relaxed );
+            block->size = size;
+
+            const uint32_t in_use = atomic_fetch_add( &size_class->in_use, 1U ) + 1U;
+            uint32_t high_water = atomic_load( &size_class->high_water );
+            while( ( in_use > high_water ) &&
+                    !atomic_compare_exchange_weak( &size_class->high_water, &high_water, in_use ) )
+            {
+            }
+
+            handle->event = event;
+            handle->block = block;
+            success = true;
+        }
+        else
+        {
+            atomic_fetch_add( &size_class->exhausted, 1U );
+        }
+    }
+
+    if( !success )
+    {
+        atomic_fetch_add( &pool->failed, 1U );
+    }
+
+    return success;
+}
+
+extern void EventPool_Retain( event_handle_t handle, uint32_t count )
+{
+    if( handle.block != NULL )
+    {
+        assert( atomic_load( &handle.block->refs ) > 0U );
+        atomic_fetch_add_explicit( &handle.block->refs, count, memory_order_relaxed );
+    }
+}
+
+extern void EventPool_Release( event_handle_t handle )
+{
+    event_block_t * const block = handle.block;
+    if( block != NULL )
+    {
+        const uint32_t refs = atomic_fetch_sub_explicit( &block->refs, 1U, memory_order_acq_rel );
+        assert( refs > 0U );
+
+        if( refs == 1U )
+        {
+            event_pool_class_t * const size_class = block->owner;
+            const uint32_t index = (uint32_t)( ( (uint8_t *)block - size_class->storage ) / size_class->block_size );
+
+            atomic_fetch_sub( &size_class->in_use, 1U );
+            Push( size_class, index );
+        }
+    }
+}
+
+extern void EventPool_GetStats( event_pool_t * const pool, uint32_t size_class, event_pool_stats_t * const stats )
+{
+    assert( pool != NULL );
+    assert( stats != NULL );
+    assert( size_class < pool->num_classes );
+
+    event_pool_class_t * const c = pool->size_class[ size_class ];
+    stats->payload_size = c->payload_size;
+    stats->num_blocks = c->num_blocks;
+    stats->in_use = atomic_load( &c->in_use );
+    stats->high_water = atomic_load( &c->high_water );
+    stats->exhausted = atomic_load( &c->exhausted );
+}
+
+extern uint32_t EventPool_Failed( event_pool_t * const pool )
+{
+    assert( pool != NULL );
+    return atomic_load( &pool->failed );
+}
+
+extern void EventPool_Dispatch( state_t * const state, event_handle_t handle )
+{
+    assert( state != NULL );
+
+    /* Handlers may dispatch other handles, so restore on the way out */
+    const event_handle_t previous = current;
+    current = handle;
+    STATEMACHINE_Dispatch( state, handle.event );
+    current = previous;
+
+    EventPool_Release( handle );
+}
+
+extern void const * EventPool_CurrentPayload( void )
+{
+    return ( current.block != NULL ) ? current.block->payload : NULL;
+}
+
+extern uint32_t EventPool_CurrentSize( void )
+{
+    return ( current.block != NULL ) ? current.block->size : 0U;
+}
+
+extern void EventHandleFIFO_Init( event_handle_fifo_t * const fifo )
+{
+    assert( fifo != NULL );
+
+    static const fifo_vfunc_t vfunc =
+    {
+        .enq = Enqueue,
+        .deq = Dequeue,
+        .peek = Peek,
+        .flush = Flush,
+        .enq_n = EnqueueN,
+        .deq_n = DequeueN,
+    };
+    FIFO_Init( (fifo_base_t *)fifo, EVENT_HANDLE_FIFO_LEN );
+
+    fifo->base.vfunc = &vfunc;
+    memset( fifo->queue, 0x00, EVENT_HANDLE_FIFO_LEN * sizeof( fifo->in ) );
+}
+
+static void Enqueue( fifo_base_t * const base )
+{
+    assert( base != NULL );
+    ENQUEUE_BOILERPLATE( event_handle_fifo_t, base );
+}
+
+static void Dequeue( fifo_base_t * const base )
+{
+    assert( base != NULL );
+    DEQUEUE_BOILERPLATE( event_handle_fifo_t, base );
+}
+
+static void Peek( fifo_base_t * const base )
+{
+    assert( base != NULL );
+    PEEK_BOILERPLATE( event_handle_fifo_t, base );
+}
+
+static void Flush( fifo_base_t * const base )
+{
+    assert( base != NULL );
+    FLUSH_BOILERPLATE( event_handle_fifo_t, base );
+}
+
+static uint32_t EnqueueN( fifo_base_t * const base, void const * const values, uint32_t count )
+{
+    assert( base != NULL );
+    ENQUEUE_N_BOILERPLATE( event_handle_fifo_t, base, values, count );
+}
+
+static uint32_t DequeueN( fifo_base_t * const base, void * const values, uint32_t count )
+{
+    assert( base != NULL );
+    DEQUEUE_N_BOILERPLATE( event_handle_fifo_t, base, values, count );
+}
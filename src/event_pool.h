@@ -0,0 +1,139 @@
+#ifndef EVENT_POOL_H_
+#define EVENT_POOL_H_
+
+#include <assert.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "state.h"
+#include "fifo_base.h"
+
+#ifndef EVENT_POOL_MAX_CLASSES
+#define EVENT_POOL_MAX_CLASSES (4U)
+#endif /* EVENT_POOL_MAX_CLASSES */
+
+#ifndef EVENT_HANDLE_FIFO_LEN
+#define EVENT_HANDLE_FIFO_LEN (32U)
+#endif /* EVENT_HANDLE_FIFO_LEN */
+
+#define EVENT_POOL_ALIGN ( _Alignof( max_align_t ) )
+
+/* Size of a block holding the header and a payload of the given size */
+#define EVENT_POOL_BLOCK_SIZE( payload ) \
+    ( ( sizeof( event_block_t ) + (payload) + EVENT_POOL_ALIGN - 1U ) & ~( EVENT_POOL_ALIGN - 1U ) )
+
+/* Static storage for one size class, e.g.
+ *
+ * GENERATE_EVENT_POOL_CLASS( small, 16U, 32U );
+ * EventPool_AddClass( &pool, &small );
+ */
+#define GENERATE_EVENT_POOL_CLASS( NAME, PAYLOAD, BLOCKS ) \
+    static _Alignas( EVENT_POOL_ALIGN ) uint8_t NAME##_storage[ EVENT_POOL_BLOCK_SIZE( PAYLOAD ) * (BLOCKS) ]; \
+    static atomic_uint NAME##_next[ (BLOCKS) ]; \
+    static event_pool_class_t NAME = \
+    { \
+        .storage = NAME##_storage, \
+        .next = NAME##_next, \
+        .payload_size = (PAYLOAD), \
+        .block_size = EVENT_POOL_BLOCK_SIZE( PAYLOAD ), \
+        .num_blocks = (BLOCKS), \
+    }
+
+typedef struct event_pool_class_t event_pool_class_t;
+
+typedef struct
+{
+    event_pool_class_t * owner;
+    atomic_uint refs;
+    uint32_t size;
+    _Alignas( EVENT_POOL_ALIGN ) uint8_t payload[];
+}
+event_block_t;
+
+struct event_pool_class_t
+{
+    uint8_t * storage;
+    atomic_uint * next;
+    uint32_t payload_size;
+    uint32_t block_size;
+    uint32_t num_blocks;
+    /* Free list head, a block index tagged with a counter against ABA */
+    _Atomic uint64_t head;
+    atomic_uint in_use;
+    atomic_uint high_water;
+    atomic_uint exhausted;
+};
+
+typedef struct
+{
+    event_pool_class_t * size_class[ EVENT_POOL_MAX_CLASSES ];
+    uint32_t num_classes;
+    atomic_uint failed;
+}
+event_pool_t;
+
+/* An event and optionally a shared payload, cheap to copy into FIFOs */
+typedef struct
+{
+    event_t event;
+    event_block_t * block;
+}
+event_handle_t;
+
+/* Flushing drops handles without releasing their references */
+typedef struct
+{
+    fifo_base_t base;
+    event_handle_t queue[ EVENT_HANDLE_FIFO_LEN ];
+    event_handle_t in;
+    event_handle_t out;
+}
+event_handle_fifo_t;
+
+typedef struct
+{
+    uint32_t payload_size;
+    uint32_t num_blocks;
+    uint32_t in_use;
+    uint32_t high_water;
+    /* Allocations that found this class empty */
+    uint32_t exhausted;
+}
+event_pool_stats_t;
+
+extern void EventPool_Init( event_pool_t * const pool );
+/* Classes must be added smallest payload first */
+extern void EventPool_AddClass( event_pool_t * const pool, event_pool_class_t * const size_class );
+
+/* Takes a block from the smallest class that fits, falling back to larger
+ * classes when it is empty. The handle holds one reference */
+extern bool EventPool_Alloc( event_pool_t * const pool, event_t event, uint32_t size, event_handle_t * const handle );
+extern void EventPool_Retain( event_handle_t handle, uint32_t count );
+/* Drops a reference, returning the block to its class on the last one */
+extern void EventPool_Release( event_handle_t handle );
+
+extern void EventPool_GetStats( event_pool_t * const pool, uint32_t size_class, event_pool_stats_t * const stats );
+extern uint32_t EventPool_Failed( event_pool_t * const pool );
+
+/* Dispatches the event and then drops the handle's reference. Handlers
+ * read the payload through EventPool_CurrentPayload */
+extern void EventPool_Dispatch( state_t * const state, event_handle_t handle );
+extern void const * EventPool_CurrentPayload( void );
+extern uint32_t EventPool_CurrentSize( void );
+
+extern void EventHandleFIFO_Init( event_handle_fifo_t * const fifo );
+
+inline static void * EventPool_Payload( event_handle_t handle )
+{
+    assert( handle.block != NULL );
+    return handle.block->payload;
+}
+
+inline static event_handle_t EventPool_Handle( event_t event )
+{
+    event_handle_t handle = { .event = event, .block = NULL };
+    return handle;
+}
+
+#endif /* EVENT_POOL_H_ */
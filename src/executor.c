@@ -0,0 +1,190 @@
+#define _GNU_SOURCE
+#include "executor.h"
+#include <sched.h>
+
+_Static_assert( EXECUTOR_QUEUE_LEN > 1U, "Executor queue length must be greater than 1" );
+_Static_assert( ( EXECUTOR_QUEUE_LEN & ( EXECUTOR_QUEUE_LEN - 1U ) ) == 0U, "Executor queue length must be a power of 2" );
+
+/* Set on worker threads so that posts from handlers are let through while
+ * the executor drains */
+static _Thread_local executor_worker_t * current_worker;
+
+static void * Worker( void * arg );
+static void Join( executor_t * const exec, uint32_t num_workers );
+
+extern void Executor_Init( executor_t * const exec, uint32_t num_workers, int const * const cpus )
+{
+    assert( exec != NULL );
+    assert( num_workers > 0U );
+    assert( num_workers <= EXECUTOR_MAX_WORKERS );
+
+    for( uint32_t idx = 0U; idx < num_workers; idx++ )
+    {
+        executor_worker_t * const worker = &exec->worker[idx];
+        FIFO_MPMC_Init( &worker->queue );
+        worker->executor = exec;
+        worker->cpu = ( cpus != NULL ) ? cpus[idx] : EXECUTOR_NO_AFFINITY;
+        worker->dispatched = 0U;
+    }
+
+    exec->num_workers = num_workers;
+    exec->next_worker = 0U;
+    atomic_init( &exec->accepting, false );
+    atomic_init( &exec->posting, 0U );
+    atomic_init( &exec->pending, 0U );
+    exec->started = false;
+}
+
+extern void Executor_Register( executor_t * const exec, executor_object_t * const object, state_t * const state, uint32_t worker )
+{
+    assert( exec != NULL );
+    assert( object != NULL );
+    assert( state != NULL );
+    /* Ownership cannot change once workers are running */
+    assert( !exec->started );
+
+    if( worker == EXECUTOR_ANY_WORKER )
+    {
+        worker = exec->next_worker;
+        exec->next_worker = ( exec->next_worker + 1U ) % exec->num_workers;
+    }
+    assert( worker < exec->num_workers );
+
+    object->state = state;
+    object->worker = worker;
+    object->dispatched = 0U;
+}
+
+extern int Executor_Start( executor_t * const exec )
+{
+    assert( exec != NULL );
+    assert( !exec->started );
+
+    exec->started = true;
+
+    int ret = 0;
+    uint32_t idx;
+    for( idx = 0U; ( idx < exec->num_workers ) && ( ret == 0 ); idx++ )
+    {
+        executor_worker_t * const worker = &exec->worker[idx];
+        pthread_attr_t attr;
+        FIFO_MPMC_Open( &worker->queue.base );
+
+        /* Pinned before it starts, so it never runs on the wrong CPU */
+        ret = pthread_attr_init( &attr );
+        if( ret == 0 )
+        {
+            if( worker->cpu != EXECUTOR_NO_AFFINITY )
+            {
+                cpu_set_t set;
+                CPU_ZERO( &set );
+                CPU_SET( worker->cpu, &set );
+                ret = pthread_attr_setaffinity_np( &attr, sizeof(set), &set );
+            }
+            if( ret == 0 )
+            {
+                ret = pthread_create( &worker->thread, &attr, Worker, worker );
+            }
+            (void)pthread_attr_destroy( &attr );
+        }
+    }
+
+    if( ret == 0 )
+    {
+        atomic_store( &exec->accepting, true );
+    }
+    else
+    {
+        /* Nothing can have been posted yet, so the workers that did start
+         * just see their queues closed */
+        Join( exec, idx - 1U );
+        exec->started = false;
+    }
+    return ret;
+}
+
+extern bool Executor_Post( executor_t * const exec, executor_object_t * const object, event_t event )
+{
+    assert( exec != NULL );
+    assert( object != NULL );
+    assert( object->worker < exec->num_workers );
+
+    bool success = false;
+
+    /* Handlers keep posting while the executor drains on stop */
+    executor_worker_t * const worker = current_worker;
+    const bool internal = ( worker != NULL ) && ( worker->executor == exec );
+
+    /* Lets Executor_Stop wait for posts that are already under way */
+    atomic_fetch_add( &exec->posting, 1U );
+    if( internal || atomic_load( &exec->accepting ) )
+    {
+        /* Counted before it can be dispatched and uncounted */
+        const executor_post_t post = { .object = object, .event = event };
+        atomic_fetch_add( &exec->pending, 1U );
+        success = FIFO_MPMC_TryEnqueue( &exec->worker[ object->worker ].queue, &post );
+        if( !success )
+        {
+            atomic_fetch_sub( &exec->pending, 1U );
+        }
+    }
+    atomic_fetch_sub( &exec->posting, 1U );
+
+    return success;
+}
+
+extern void Executor_Stop( executor_t * const exec )
+{
+    assert( exec != NULL );
+    assert( exec->started );
+
+    /* Reject new posts from outside, then let the workers drain what is
+     * queued. Handlers only post while they are being dispatched, so once
+     * nothing is pending nothing more can arrive */
+    atomic_store( &exec->accepting, false );
+    while( atomic_load( &exec->posting ) != 0U )
+    {
+        sched_yield();
+    }
+    while( atomic_load( &exec->pending ) != 0U )
+    {
+        sched_yield();
+    }
+
+    Join( exec, exec->num_workers );
+    exec->started = false;
+}
+
+/* Workers return from their blocking dequeue once their queue is closed */
+static void Join( executor_t * const exec, uint32_t num_workers )
+{
+    for( uint32_t idx = 0U; idx < num_workers; idx++ )
+    {
+        FIFO_MPMC_Close( &exec->worker[idx].queue.base );
+    }
+
+    for( uint32_t idx = 0U; idx < num_workers; idx++ )
+    {
+        pthread_join( exec->worker[idx].thread, NULL );
+    }
+}
+
+static void * Worker( void * arg )
+{
+    executor_worker_t * const worker = (executor_worker_t *)arg;
+    executor_t * const exec = worker->executor;
+    executor_post_t post;
+    current_worker = worker;
+
+    /* Sleeps while the queue is empty, until Executor_Stop closes it */
+    while( FIFO_MPMC_Dequeue( &worker->queue, &post ) )
+    {
+        STATEMACHINE_Dispatch( post.object->state, post.event );
+        post.object->dispatched++;
+        worker->dispatched++;
+        atomic_fetch_sub( &exec->pending, 1U );
+    }
+    current_worker = NULL;
+
+    return NULL;
+}
@@ -0,0 +1,88 @@
+#ifndef EXECUTOR_H_
+#define EXECUTOR_H_
+
+#include <assert.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "state.h"
+#include "fifo_mpmc.h"
+
+#ifndef EXECUTOR_MAX_WORKERS
+#define EXECUTOR_MAX_WORKERS (16U)
+#endif /* EXECUTOR_MAX_WORKERS */
+
+/* Inbound queue length of each worker, must be a power of 2 */
+#ifndef EXECUTOR_QUEUE_LEN
+#define EXECUTOR_QUEUE_LEN (1024U)
+#endif /* EXECUTOR_QUEUE_LEN */
+
+/* Let the executor pick the worker for an active object */
+#define EXECUTOR_ANY_WORKER (UINT32_MAX)
+/* Worker threads are not pinned to a CPU */
+#define EXECUTOR_NO_AFFINITY (-1)
+
+#define EXECUTOR_CACHE_LINE (64U)
+
+/* A state machine owned by exactly one worker, so that it is never
+ * dispatched from two threads at once */
+typedef struct
+{
+    state_t * state;
+    uint32_t worker;
+    uint64_t dispatched;
+}
+executor_object_t;
+
+typedef struct
+{
+    executor_object_t * object;
+    event_t event;
+}
+executor_post_t;
+
+typedef struct
+{
+    fifo_mpmc_base_t base;
+    FIFO_MPMC_SLOT( executor_post_t ) slot[EXECUTOR_QUEUE_LEN];
+}
+executor_queue_t;
+
+typedef struct executor_t executor_t;
+
+typedef struct
+{
+    executor_queue_t queue;
+    pthread_t thread;
+    executor_t * executor;
+    int cpu;
+    uint64_t dispatched;
+}
+executor_worker_t;
+
+struct executor_t
+{
+    executor_worker_t worker[EXECUTOR_MAX_WORKERS];
+    uint32_t num_workers;
+    uint32_t next_worker;
+    atomic_bool accepting;
+    atomic_uint posting;
+    /* Events queued or being dispatched */
+    atomic_uint pending;
+    bool started;
+};
+
+/* cpus may be NULL, otherwise it holds a CPU (or EXECUTOR_NO_AFFINITY) per worker */
+extern void Executor_Init( executor_t * const exec, uint32_t num_workers, int const * const cpus );
+extern void Executor_Register( executor_t * const exec, executor_object_t * const object, state_t * const state, uint32_t worker );
+/* Returns 0, or the error from pinning or creating a worker, in which
+ * case no worker is left running */
+extern int Executor_Start( executor_t * const exec );
+extern bool Executor_Post( executor_t * const exec, executor_object_t * const object, event_t event );
+/* Rejects posts from outside the executor, then returns once every queued
+ * event, including those posted by handlers while draining, is dispatched */
+extern void Executor_Stop( executor_t * const exec );
+
+#endif /* EXECUTOR_H_ */
@@ -4,6 +4,8 @@ static void virtual_EnQ( fifo_base_t * fifo );
 static void virtual_DeQ( fifo_base_t * fifo );
 static void virtual_Flush( fifo_base_t * fifo );
 static void virtual_Peek( fifo_base_t * fifo );
+static uint32_t virtual_EnQN( fifo_base_t * const fifo, void const * const values, uint32_t count );
+static uint32_t virtual_DeQN( fifo_base_t * const fifo, void * const values, uint32_t count );
 
 extern void FIFO_Init( fifo_base_t * fifo, uint32_t size )
 {
@@ -17,6 +19,8 @@ extern void FIFO_Init( fifo_base_t * fifo, uint32_t size )
         .deq = virtual_DeQ,
         .flush = virtual_Flush,
         .peek = virtual_Peek,
+        .enq_n = virtual_EnQN,
+        .deq_n = virtual_DeQN,
     };
 
     fifo->vfunc = &vfunc;
@@ -24,6 +28,70 @@ extern void FIFO_Init( fifo_base_t * fifo, uint32_t size )
     fifo->read_index = 0U;
     fifo->write_index = 0U;
     fifo->max = size;
+    memset( &fifo->overflow, 0x00, sizeof( fifo->overflow ) );
+    fifo->overflow.policy = FIFO_OVERFLOW_ASSERT;
+}
+
+extern void FIFO_SetOverflow( fifo_base_t * const fifo, fifo_overflow_policy_t policy, int32_t timeout_ms )
+{
+    assert(fifo != NULL);
+    assert(policy <= FIFO_OVERFLOW_BLOCK);
+
+    fifo->overflow.policy = policy;
+    fifo->overflow.timeout_ms = timeout_ms;
+}
+
+extern fifo_overflow_t FIFO_GetOverflow( fifo_base_t const * const fifo )
+{
+    assert(fifo != NULL);
+    return fifo->overflow;
+}
+
+extern fifo_overflow_ret_t FIFO_Overflow( fifo_base_t * const fifo, void const * const value )
+{
+    assert(fifo != NULL);
+    assert(fifo->fill == fifo->max);
+
+    fifo_overflow_ret_t ret = FIFO_OVERFLOW_FULL;
+
+    switch( fifo->overflow.policy )
+    {
+        case FIFO_OVERFLOW_DROP_OLDEST:
+            fifo->read_index = ( fifo->read_index + 1U ) & ( fifo->max - 1U );
+            fifo->fill--;
+            fifo->overflow.dropped++;
+            ret = FIFO_OVERFLOW_ROOM;
+            break;
+        case FIFO_OVERFLOW_OVERWRITE_LATEST:
+            fifo->write_index = ( fifo->write_index - 1U ) & ( fifo->max - 1U );
+            fifo->fill--;
+            fifo->overflow.overwritten++;
+            ret = FIFO_OVERFLOW_ROOM;
+            break;
+        case FIFO_OVERFLOW_COALESCE:
+            assert(fifo->vfunc->contains != NULL);
+            if( ( fifo->vfunc->contains != NULL ) && (fifo->vfunc->contains)(fifo, value) )
+            {
+                fifo->overflow.coalesced++;
+                ret = FIFO_OVERFLOW_MERGED;
+            }
+            else
+            {
+                fifo->overflow.rejected++;
+            }
+            break;
+        case FIFO_OVERFLOW_ASSERT:
+            assert(false);
+            fifo->overflow.rejected++;
+            break;
+        case FIFO_OVERFLOW_REJECT:
+        case FIFO_OVERFLOW_BLOCK:
+        default:
+            fifo->overflow.rejected++;
+            break;
+    }
+
+    return ret;
 }
 
 static void virtual_EnQ( fifo_base_t * const fifo )
@@ -50,6 +118,24 @@ static void virtual_Peek( fifo_base_t * const fifo )
     assert(false);
 }
 
+static uint32_t virtual_EnQN( fifo_base_t * const fifo, void const * const values, uint32_t count )
+{
+    (void)fifo;
+    (void)values;
+    (void)count;
+    assert(false);
+    return 0U;
+}
+
+static uint32_t virtual_DeQN( fifo_base_t * const fifo, void * const values, uint32_t count )
+{
+    (void)fifo;
+    (void)values;
+    (void)count;
+    assert(false);
+    return 0U;
+}
+
 extern bool FIFO_IsFull( fifo_base_t const * const fifo )
 {
     return ( fifo->fill == fifo->max );
@@ -5,10 +5,23 @@
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
 
-#define FIFO_Enqueue(f, val) ((f)->in = (val), FIFO_EnQ((fifo_base_t *)(f)))
+#define FIFO_Enqueue(f, val) ((f)->in = (val), FIFO_EnQ((fifo_base_t *)(f), &(f)->in))
 #define FIFO_Dequeue(f) ((FIFO_DeQ((fifo_base_t *)(f))), (f)->out)
 #define FIFO_Peek(f) ((FIFO_Pk((fifo_base_t *)(f))), (f)->out)
+#define FIFO_EnqueueN(f, values, n) (FIFO_EnQSpan((fifo_base_t *)(f), (values), (n), &(f)->in, sizeof((f)->in)))
+#define FIFO_DequeueN(f, values, n) (FIFO_DeQSpan((fifo_base_t *)(f), (values), (n), &(f)->out, sizeof((f)->out)))
+
+/* In place access for large slots. Reserve points at the next write slot
+ * and the value is only visible after Commit. Front points at the oldest
+ * slot, which stays valid until Release. Nothing is copied through in/out.
+ * Reserve on a full FIFO applies the overflow policy and is NULL when it
+ * cannot make room, COALESCE has no value to compare yet so rejects */
+#define FIFO_Reserve(f) (FIFO_Rsv((fifo_base_t *)(f)) ? &(f)->queue[ (f)->base.write_index ] : NULL)
+#define FIFO_Commit(f) (FIFO_Cmt((fifo_base_t *)(f)))
+#define FIFO_Front(f) ((FIFO_Frt((fifo_base_t *)(f))), &(f)->queue[ (f)->base.read_index ])
+#define FIFO_Release(f) (FIFO_Rls((fifo_base_t *)(f)))
 
 #define ENQUEUE_BOILERPLATE(TYPE, BASE) \
     { \
@@ -45,6 +58,96 @@
         fifo->base.fill = 0U; \
     }
 
+/* Span variants copy straight between the caller's array and the ring in
+ * at most two pieces, split at the wrap point. They return the number of
+ * elements moved, so they belong in a function returning uint32_t */
+#define ENQUEUE_N_BOILERPLATE(TYPE, BASE, VALUES, COUNT) \
+    { \
+        TYPE * fifo = ((TYPE *)(BASE)); \
+        const size_t element = sizeof( fifo->queue[0] ); \
+        const uint32_t space = fifo->base.max - fifo->base.fill; \
+        const uint32_t moved = ( (COUNT) < space ) ? (COUNT) : space; \
+        const uint32_t first = fifo->base.max - fifo->base.write_index; \
+        const uint32_t head = ( moved < first ) ? moved : first; \
+        \
+        memcpy( &fifo->queue[ fifo->base.write_index ], (VALUES), head * element ); \
+        memcpy( &fifo->queue[ 0U ], (uint8_t const *)(VALUES) + ( head * element ), ( moved - head ) * element ); \
+        fifo->base.write_index = ( fifo->base.write_index + moved ) & ( fifo->base.max - 1U ); \
+        fifo->base.fill += moved; \
+        return moved; \
+    }
+
+#define DEQUEUE_N_BOILERPLATE(TYPE, BASE, VALUES, COUNT) \
+    { \
+        TYPE * fifo = ((TYPE *)(BASE)); \
+        const size_t element = sizeof( fifo->queue[0] ); \
+        const uint32_t moved = ( (COUNT) < fifo->base.fill ) ? (COUNT) : fifo->base.fill; \
+        const uint32_t first = fifo->base.max - fifo->base.read_index; \
+        const uint32_t head = ( moved < first ) ? moved : first; \
+        \
+        memcpy( (VALUES), &fifo->queue[ fifo->base.read_index ], head * element ); \
+        memcpy( (uint8_t *)(VALUES) + ( head * element ), &fifo->queue[ 0U ], ( moved - head ) * element ); \
+        fifo->base.read_index = ( fifo->base.read_index + moved ) & ( fifo->base.max - 1U ); \
+        fifo->base.fill -= moved; \
+        return moved; \
+    }
+
+/* Looks for VALUE among the queued elements, byte for byte, so padded
+ * struct types need their padding cleared to coalesce reliably */
+#define CONTAINS_BOILERPLATE(TYPE, BASE, VALUE) \
+    { \
+        TYPE const * fifo = ((TYPE const *)(BASE)); \
+        uint32_t index = fifo->base.read_index; \
+        \
+        for( uint32_t idx = 0U; idx < fifo->base.fill; idx++ ) \
+        { \
+            if( memcmp( &fifo->queue[ index ], (VALUE), sizeof( fifo->queue[0] ) ) == 0 ) \
+            { \
+                return true; \
+            } \
+            index = ( index + 1U ) & ( fifo->base.max - 1U ); \
+        } \
+        return false; \
+    }
+
+/* What an enqueue into a full FIFO does. ASSERT is the default and keeps
+ * the old behaviour in debug builds, with NDEBUG it rejects instead of
+ * overrunning the ring. BLOCK needs someone else to drain the FIFO, so it
+ * only waits when posting through a fifo_wait_t and rejects otherwise */
+typedef enum
+{
+    FIFO_OVERFLOW_ASSERT,
+    FIFO_OVERFLOW_REJECT,
+    FIFO_OVERFLOW_DROP_OLDEST,
+    FIFO_OVERFLOW_OVERWRITE_LATEST,
+    FIFO_OVERFLOW_COALESCE,
+    FIFO_OVERFLOW_BLOCK,
+}
+fifo_overflow_policy_t;
+
+/* Outcome of FIFO_Overflow */
+typedef enum
+{
+    FIFO_OVERFLOW_ROOM,
+    FIFO_OVERFLOW_MERGED,
+    FIFO_OVERFLOW_FULL,
+}
+fifo_overflow_ret_t;
+
+typedef struct
+{
+    fifo_overflow_policy_t policy;
+    int32_t timeout_ms;
+    uint32_t high_water;
+    uint64_t rejected;
+    uint64_t dropped;
+    uint64_t overwritten;
+    uint64_t coalesced;
+    uint64_t blocked;
+    uint64_t timeouts;
+}
+fifo_overflow_t;
+
 typedef struct fifo_vfunc_t fifo_vfunc_t;
 typedef struct 
 {
@@ -53,6 +156,7 @@ typedef struct
     uint32_t write_index;
     uint32_t fill;
     uint32_t max;
+    fifo_overflow_t overflow;
 }
 fifo_base_t;
 
@@ -62,15 +166,83 @@ struct fifo_vfunc_t
     void (*deq)(fifo_base_t * const base);
     void (*peek)(fifo_base_t * const base);
     void (*flush)(fifo_base_t * const base);
+    uint32_t (*enq_n)(fifo_base_t * const base, void const * const values, uint32_t count);
+    uint32_t (*deq_n)(fifo_base_t * const base, void * const values, uint32_t count);
+    bool (*contains)(fifo_base_t const * const base, void const * const value);
 };
 
-inline static void FIFO_EnQ( fifo_base_t * const fifo )
+extern fifo_overflow_ret_t FIFO_Overflow( fifo_base_t * const fifo, void const * const value );
+
+inline static void FIFO_HighWater( fifo_base_t * const fifo )
+{
+    if( fifo->fill > fifo->overflow.high_water )
+    {
+        fifo->overflow.high_water = fifo->fill;
+    }
+}
+
+/* Returns false if the value was turned away by the overflow policy */
+inline static bool FIFO_EnQ( fifo_base_t * const fifo, void const * const value )
 {
     assert( fifo != NULL );
     assert( fifo->vfunc != NULL );
-    assert( fifo->fill < fifo->max );
-    
+
+    if( fifo->fill >= fifo->max )
+    {
+        const fifo_overflow_ret_t ret = FIFO_Overflow( fifo, value );
+        if( ret != FIFO_OVERFLOW_ROOM )
+        {
+            return ( ret == FIFO_OVERFLOW_MERGED );
+        }
+    }
+
     (fifo->vfunc->enq)(fifo);
+    FIFO_HighWater( fifo );
+    return true;
+}
+
+/* Ring access for owners that keep a typed FIFO's queue next to its base,
+ * such as the scheduler and priority lanes, copying size byte elements
+ * without going through in/out or the vfunc. Post applies the overflow
+ * policy and high water mark just as FIFO_EnQ does, Take returns false
+ * when the FIFO is empty */
+inline static bool FIFO_Post( fifo_base_t * const fifo, void * const queue, void const * const value, size_t size )
+{
+    assert( fifo != NULL );
+    assert( queue != NULL );
+    assert( value != NULL );
+
+    if( fifo->fill >= fifo->max )
+    {
+        const fifo_overflow_ret_t ret = FIFO_Overflow( fifo, value );
+        if( ret != FIFO_OVERFLOW_ROOM )
+        {
+            return ( ret == FIFO_OVERFLOW_MERGED );
+        }
+    }
+
+    memcpy( (uint8_t *)queue + ( fifo->write_index * size ), value, size );
+    fifo->write_index = ( fifo->write_index + 1U ) & ( fifo->max - 1U );
+    fifo->fill++;
+    FIFO_HighWater( fifo );
+    return true;
+}
+
+inline static bool FIFO_Take( fifo_base_t * const fifo, void const * const queue, void * const value, size_t size )
+{
+    assert( fifo != NULL );
+    assert( queue != NULL );
+    assert( value != NULL );
+
+    if( fifo->fill == 0U )
+    {
+        return false;
+    }
+
+    memcpy( value, (uint8_t const *)queue + ( fifo->read_index * size ), size );
+    fifo->read_index = ( fifo->read_index + 1U ) & ( fifo->max - 1U );
+    fifo->fill--;
+    return true;
 }
 
 inline static void FIFO_DeQ( fifo_base_t * const fifo )
@@ -99,9 +271,136 @@ inline static void FIFO_Pk( fifo_base_t * const fifo )
     (fifo->vfunc->peek)(fifo);
 }
 
+/* Span copies need the enq_n/deq_n vfunc entries, FIFO_EnqueueN and
+ * FIFO_DequeueN fall back to one element at a time through in/out for
+ * hand written vfuncs that leave them NULL. Whatever does not fit goes
+ * through the overflow policy one element of size bytes at a time, just as
+ * FIFO_EnQ would, and the return counts merged elements as accepted */
+inline static uint32_t FIFO_EnQN( fifo_base_t * const fifo, void const * const values, uint32_t count, size_t size )
+{
+    assert( fifo != NULL );
+    assert( fifo->vfunc != NULL );
+    assert( fifo->vfunc->enq_n != NULL );
+    assert( ( values != NULL ) || ( count == 0U ) );
+
+    uint32_t moved = (fifo->vfunc->enq_n)(fifo, values, count);
+    for( uint32_t idx = moved; idx < count; idx++ )
+    {
+        void const * const value = (uint8_t const *)values + ( idx * size );
+        const fifo_overflow_ret_t ret = FIFO_Overflow( fifo, value );
+        if( ret == FIFO_OVERFLOW_ROOM )
+        {
+            moved += (fifo->vfunc->enq_n)(fifo, value, 1U);
+        }
+        else if( ret == FIFO_OVERFLOW_MERGED )
+        {
+            moved++;
+        }
+    }
+    FIFO_HighWater( fifo );
+    return moved;
+}
+
+inline static uint32_t FIFO_DeQN( fifo_base_t * const fifo, void * const values, uint32_t count )
+{
+    assert( fifo != NULL );
+    assert( fifo->vfunc != NULL );
+    assert( fifo->vfunc->deq_n != NULL );
+    assert( ( values != NULL ) || ( count == 0U ) );
+
+    return (fifo->vfunc->deq_n)(fifo, values, count);
+}
+
+inline static uint32_t FIFO_EnQSpan( fifo_base_t * const fifo, void const * const values, uint32_t count, void * const in, size_t size )
+{
+    assert( fifo != NULL );
+    assert( fifo->vfunc != NULL );
+
+    if( fifo->vfunc->enq_n != NULL )
+    {
+        return FIFO_EnQN( fifo, values, count, size );
+    }
+
+    assert( ( values != NULL ) || ( count == 0U ) );
+    uint32_t moved = 0U;
+    for( uint32_t idx = 0U; idx < count; idx++ )
+    {
+        memcpy( in, (uint8_t const *)values + ( idx * size ), size );
+        if( FIFO_EnQ( fifo, in ) )
+        {
+            moved++;
+        }
+    }
+    return moved;
+}
+
+inline static uint32_t FIFO_DeQSpan( fifo_base_t * const fifo, void * const values, uint32_t count, void const * const out, size_t size )
+{
+    assert( fifo != NULL );
+    assert( fifo->vfunc != NULL );
+
+    if( fifo->vfunc->deq_n != NULL )
+    {
+        return FIFO_DeQN( fifo, values, count );
+    }
+
+    assert( ( values != NULL ) || ( count == 0U ) );
+    uint32_t moved = 0U;
+    for( ; ( moved < count ) && ( fifo->fill > 0U ); moved++ )
+    {
+        (fifo->vfunc->deq)(fifo);
+        memcpy( (uint8_t *)values + ( moved * size ), out, size );
+    }
+    return moved;
+}
+
+inline static bool FIFO_Rsv( fifo_base_t * const fifo )
+{
+    assert( fifo != NULL );
+
+    if( fifo->fill >= fifo->max )
+    {
+        if( fifo->overflow.policy == FIFO_OVERFLOW_COALESCE )
+        {
+            fifo->overflow.rejected++;
+            return false;
+        }
+        return ( FIFO_Overflow( fifo, NULL ) == FIFO_OVERFLOW_ROOM );
+    }
+    return true;
+}
+
+inline static void FIFO_Cmt( fifo_base_t * const fifo )
+{
+    assert( fifo != NULL );
+    assert( fifo->fill < fifo->max );
+
+    fifo->write_index = ( fifo->write_index + 1U ) & ( fifo->max - 1U );
+    fifo->fill++;
+    FIFO_HighWater( fifo );
+}
+
+inline static void FIFO_Frt( fifo_base_t const * const fifo )
+{
+    assert( fifo != NULL );
+    assert( fifo->fill > 0U );
+    (void)fifo;
+}
+
+inline static void FIFO_Rls( fifo_base_t * const fifo )
+{
+    assert( fifo != NULL );
+    assert( fifo->fill > 0U );
+
+    fifo->read_index = ( fifo->read_index + 1U ) & ( fifo->max - 1U );
+    fifo->fill--;
+}
+
 extern void FIFO_Init( fifo_base_t * const fifo, uint32_t size );
 extern bool FIFO_IsFull( fifo_base_t const * const fifo );
 extern bool FIFO_IsEmpty( fifo_base_t const * const fifo );
+extern void FIFO_SetOverflow( fifo_base_t * const fifo, fifo_overflow_policy_t policy, int32_t timeout_ms );
+extern fifo_overflow_t FIFO_GetOverflow( fifo_base_t const * const fifo );
 
 #endif /* FIFO_BASE_ */
 
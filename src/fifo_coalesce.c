@@ -0,0 +1,152 @@
+#include "fifo_coalesce.h"
+
+/* Top bit marks the event coalescible, the rest is the pending ring
+ * index + 1, or 0 when nothing is pending */
+#define COALESCIBLE ( 0x80000000U )
+#define INDEX_MASK ( 0x7FFFFFFFU )
+
+static event_t EventAt( fifo_coalesce_t const * const c, uint32_t index );
+static void Forget( fifo_coalesce_t * const c, uint32_t index );
+
+extern void FIFO_COALESCE_InitQueue( fifo_coalesce_t * const c,
+        fifo_base_t * const fifo,
+        uint8_t * const queue,
+        size_t element_size,
+        size_t event_offset,
+        uint32_t * const pending,
+        uint32_t num_events )
+{
+    assert( c != NULL );
+    assert( fifo != NULL );
+    assert( queue != NULL );
+    assert( pending != NULL );
+    assert( ( event_offset + sizeof( event_t ) ) <= element_size );
+    /* Anything already queued would not be tracked */
+    assert( FIFO_IsEmpty( fifo ) );
+
+    c->fifo = fifo;
+    c->queue = queue;
+    c->element_size = element_size;
+    c->event_offset = event_offset;
+    c->pending = pending;
+    c->num_events = num_events;
+    c->coalesced = 0U;
+
+    memset( pending, 0x00, num_events * sizeof( pending[0] ) );
+}
+
+extern void FIFO_COALESCE_Mark( fifo_coalesce_t * const c, event_t event )
+{
+    assert( c != NULL );
+    assert( event < c->num_events );
+    c->pending[event] |= COALESCIBLE;
+}
+
+extern void FIFO_COALESCE_Unmark( fifo_coalesce_t * const c, event_t event )
+{
+    assert( c != NULL );
+    assert( event < c->num_events );
+    /* An element already queued stays, it just no longer absorbs others */
+    c->pending[event] = 0U;
+}
+
+extern bool FIFO_COALESCE_IsPending( fifo_coalesce_t const * const c, event_t event )
+{
+    assert( c != NULL );
+    assert( event < c->num_events );
+    return ( ( c->pending[event] & INDEX_MASK ) != 0U );
+}
+
+extern bool FIFO_COALESCE_PostValue( fifo_coalesce_t * const c, void const * const value, size_t size )
+{
+    assert( c != NULL );
+    assert( value != NULL );
+    assert( size == c->element_size );
+    (void)size;
+
+    event_t event;
+    memcpy( &event, (uint8_t const *)value + c->event_offset, sizeof( event ) );
+    assert( event < c->num_events );
+
+    fifo_base_t * const fifo = c->fifo;
+    uint32_t * const entry = &c->pending[event];
+
+    if( ( *entry & INDEX_MASK ) != 0U )
+    {
+        const uint32_t index = ( *entry & INDEX_MASK ) - 1U;
+        memcpy( &c->queue[ index * c->element_size ], value, c->element_size );
+        c->coalesced++;
+        return true;
+    }
+
+    if( FIFO_IsFull( fifo ) )
+    {
+        /* Whichever element the policy makes room with may be the pending
+         * one, so forget it while its event is still in the slot */
+        if( fifo->overflow.policy == FIFO_OVERFLOW_DROP_OLDEST )
+        {
+            Forget( c, fifo->read_index );
+        }
+        else if( fifo->overflow.policy == FIFO_OVERFLOW_OVERWRITE_LATEST )
+        {
+            Forget( c, ( fifo->write_index - 1U ) & ( fifo->max - 1U ) );
+        }
+        else if( fifo->overflow.policy == FIFO_OVERFLOW_COALESCE )
+        {
+            /* Merged into an equal element already queued, or rejected,
+             * either way nothing was written for the entry to point at */
+            return FIFO_Post( fifo, c->queue, value, c->element_size );
+        }
+    }
+
+    if( !FIFO_Post( fifo, c->queue, value, c->element_size ) )
+    {
+        return false;
+    }
+    const uint32_t index = ( fifo->write_index - 1U ) & ( fifo->max - 1U );
+
+    if( ( *entry & COALESCIBLE ) != 0U )
+    {
+        *entry = COALESCIBLE | ( index + 1U );
+    }
+
+    return true;
+}
+
+extern bool FIFO_COALESCE_TakeValue( fifo_coalesce_t * const c, void * const value, size_t size )
+{
+    assert( c != NULL );
+    assert( value != NULL );
+    assert( size == c->element_size );
+    (void)size;
+
+    /* The slot still holds the event after the take, for Forget */
+    const uint32_t index = c->fifo->read_index;
+    if( !FIFO_Take( c->fifo, c->queue, value, c->element_size ) )
+    {
+        return false;
+    }
+    Forget( c, index );
+
+    return true;
+}
+
+static event_t EventAt( fifo_coalesce_t const * const c, uint32_t index )
+{
+    event_t event;
+    memcpy( &event, &c->queue[ ( index * c->element_size ) + c->event_offset ], sizeof( event ) );
+    return event;
+}
+
+/* Clears the pending entry if it points at the element leaving this slot */
+static void Forget( fifo_coalesce_t * const c, uint32_t index )
+{
+    const event_t event = EventAt( c, index );
+    assert( event < c->num_events );
+
+    uint32_t * const entry = &c->pending[event];
+    if( ( *entry & INDEX_MASK ) == ( index + 1U ) )
+    {
+        *entry &= COALESCIBLE;
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef FIFO_COALESCE_
+#define FIFO_COALESCE_
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "state.h"
+#include "fifo_base.h"
+
+/* Coalescing front end for an event FIFO. Events marked coalescible are
+ * queued at most once: posting one that is already pending overwrites the
+ * pending element in place (a no-op for a plain event_t FIFO, the newer
+ * payload wins for records), so a machine that falls behind sees the
+ * latest tick rather than hundreds of stale ones. The queue depth for those
+ * events is bounded by the number of distinct event kinds.
+ *
+ * Each event id has one entry in caller storage sized from
+ * EVENT(EventCount), holding the coalescible flag and the ring index of the
+ * pending element, e.g.
+ *
+ * static uint32_t pending[ EVENT(EventCount) ];
+ * FIFO_COALESCE_Init( &coalesce, &fifo, pending, EVENT(EventCount) );
+ * FIFO_COALESCE_Mark( &coalesce, EVENT(Tick) );
+ *
+ * FIFO_COALESCE_InitRecords does the same for FIFOs of records with an
+ * event_t member. Once attached, the FIFO must only be posted to and taken
+ * from through the coalescer, or the pending indices go stale */
+
+#define FIFO_COALESCE_Init( c, f, pending, num_events ) \
+    FIFO_COALESCE_InitQueue( (c), &(f)->base, (uint8_t *)(f)->queue, sizeof( (f)->queue[0] ), 0U, \
+            (pending), (num_events) )
+
+#define FIFO_COALESCE_InitRecords( c, f, member, pending, num_events ) \
+    FIFO_COALESCE_InitQueue( (c), &(f)->base, (uint8_t *)(f)->queue, sizeof( (f)->queue[0] ), \
+            (size_t)( (uint8_t const *)&(f)->queue[0].member - (uint8_t const *)&(f)->queue[0] ), \
+            (pending), (num_events) )
+
+#define FIFO_COALESCE_Post( c, val_ptr ) FIFO_COALESCE_PostValue( (c), (val_ptr), sizeof( *(val_ptr) ) )
+#define FIFO_COALESCE_Take( c, out_ptr ) FIFO_COALESCE_TakeValue( (c), (out_ptr), sizeof( *(out_ptr) ) )
+
+typedef struct
+{
+    fifo_base_t * fifo;
+    uint8_t * queue;
+    size_t element_size;
+    size_t event_offset;
+    uint32_t * pending;
+    uint32_t num_events;
+    uint64_t coalesced;
+}
+fifo_coalesce_t;
+
+extern void FIFO_COALESCE_InitQueue( fifo_coalesce_t * const c,
+        fifo_base_t * const fifo,
+        uint8_t * const queue,
+        size_t element_size,
+        size_t event_offset,
+        uint32_t * const pending,
+        uint32_t num_events );
+
+extern void FIFO_COALESCE_Mark( fifo_coalesce_t * const c, event_t event );
+extern void FIFO_COALESCE_Unmark( fifo_coalesce_t * const c, event_t event );
+extern bool FIFO_COALESCE_IsPending( fifo_coalesce_t const * const c, event_t event );
+
+/* Applies the FIFO's overflow policy when a new element does not fit */
+extern bool FIFO_COALESCE_PostValue( fifo_coalesce_t * const c, void const * const value, size_t size );
+extern bool FIFO_COALESCE_TakeValue( fifo_coalesce_t * const c, void * const value, size_t size );
+
+#endif /* FIFO_COALESCE_ */
@@ -0,0 +1,128 @@
+#include "fifo_mpmc.h"
+#include <sched.h>
+
+extern void FIFO_MPMC_InitBase( fifo_mpmc_base_t * const fifo, uint32_t size, uint8_t * const slots, size_t slot_size )
+{
+    assert(fifo != NULL);
+    assert(slots != NULL);
+    assert(size > 1U);
+    assert((size & (size - 1U )) == 0U);
+    assert(slot_size >= sizeof(atomic_size_t));
+
+    for( uint32_t idx = 0U; idx < size; idx++ )
+    {
+        atomic_init( (atomic_size_t *)&slots[ idx * slot_size ], (size_t)idx );
+    }
+
+    fifo->max = size;
+    atomic_init( &fifo->enqueue_pos, 0U );
+    atomic_init( &fifo->dequeue_pos, 0U );
+    atomic_init( &fifo->producers_waiting, 0U );
+    atomic_init( &fifo->consumers_waiting, 0U );
+    atomic_init( &fifo->closed, false );
+    pthread_mutex_init( &fifo->lock, NULL );
+    pthread_cond_init( &fifo->not_empty, NULL );
+    pthread_cond_init( &fifo->not_full, NULL );
+    fifo->sleeps = 0U;
+}
+
+extern void FIFO_MPMC_Destroy( fifo_mpmc_base_t * const fifo )
+{
+    assert(fifo != NULL);
+
+    pthread_cond_destroy( &fifo->not_full );
+    pthread_cond_destroy( &fifo->not_empty );
+    pthread_mutex_destroy( &fifo->lock );
+}
+
+extern void FIFO_MPMC_Close( fifo_mpmc_base_t * const fifo )
+{
+    assert(fifo != NULL);
+
+    pthread_mutex_lock( &fifo->lock );
+    atomic_store( &fifo->closed, true );
+    pthread_cond_broadcast( &fifo->not_empty );
+    pthread_cond_broadcast( &fifo->not_full );
+    pthread_mutex_unlock( &fifo->lock );
+}
+
+extern void FIFO_MPMC_Open( fifo_mpmc_base_t * const fifo )
+{
+    assert(fifo != NULL);
+    atomic_store( &fifo->closed, false );
+}
+
+extern void FIFO_MPMC_Notify( fifo_mpmc_base_t * const fifo, pthread_cond_t * const cond )
+{
+    assert(fifo != NULL);
+
+    pthread_mutex_lock( &fifo->lock );
+    pthread_cond_broadcast( cond );
+    pthread_mutex_unlock( &fifo->lock );
+}
+
+extern bool FIFO_MPMC_WaitNotEmpty( fifo_mpmc_base_t * const fifo )
+{
+    assert(fifo != NULL);
+
+    /* Going to sleep costs a futex round trip on both sides, so give the
+     * other side a few chances first */
+    for( uint32_t spin = 0U; spin < FIFO_MPMC_SPIN; spin++ )
+    {
+        if( !FIFO_MPMC_IsEmpty( fifo ) )
+        {
+            return true;
+        }
+        sched_yield();
+    }
+
+    pthread_mutex_lock( &fifo->lock );
+    atomic_fetch_add( &fifo->consumers_waiting, 1U );
+    /* Orders the count before the check below, against the seq_cst claim
+     * in FIFO_MPMC_TryEnQ. Only sleepers pay for it */
+    atomic_thread_fence( memory_order_seq_cst );
+
+    /* A claimed but unpublished slot counts as not empty, the caller just
+     * retries until the producer finishes writing it */
+    const bool empty = FIFO_MPMC_IsEmpty( fifo );
+    const bool closed = atomic_load( &fifo->closed );
+    if( empty && !closed )
+    {
+        pthread_cond_wait( &fifo->not_empty, &fifo->lock );
+        fifo->sleeps++;
+    }
+    atomic_fetch_sub( &fifo->consumers_waiting, 1U );
+    pthread_mutex_unlock( &fifo->lock );
+
+    return !( empty && closed );
+}
+
+extern bool FIFO_MPMC_WaitNotFull( fifo_mpmc_base_t * const fifo )
+{
+    assert(fifo != NULL);
+
+    for( uint32_t spin = 0U; spin < FIFO_MPMC_SPIN; spin++ )
+    {
+        if( !FIFO_MPMC_IsFull( fifo ) )
+        {
+            return true;
+        }
+        sched_yield();
+    }
+
+    pthread_mutex_lock( &fifo->lock );
+    atomic_fetch_add( &fifo->producers_waiting, 1U );
+    /* As above, against the claim in FIFO_MPMC_TryDeQ */
+    atomic_thread_fence( memory_order_seq_cst );
+
+    const bool closed = atomic_load( &fifo->closed );
+    if( FIFO_MPMC_IsFull( fifo ) && !closed )
+    {
+        pthread_cond_wait( &fifo->not_full, &fifo->lock );
+        fifo->sleeps++;
+    }
+    atomic_fetch_sub( &fifo->producers_waiting, 1U );
+    pthread_mutex_unlock( &fifo->lock );
+
+    return !closed;
+}
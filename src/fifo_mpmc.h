@@ -0,0 +1,238 @@
+#ifndef FIFO_MPMC_
+#define FIFO_MPMC_
+
+#include <assert.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+
+/* Bounded multi producer, multi consumer FIFO, a ring of slots each with a
+ * sequence number that says whose turn it is (after D. Vyukov). Typed
+ * FIFOs declare their slots with FIFO_MPMC_SLOT, e.g.
+ *
+ * typedef struct
+ * {
+ *     fifo_mpmc_base_t base;
+ *     FIFO_MPMC_SLOT( event_t ) slot[LEN];
+ * }
+ * event_mpmc_fifo_t;
+ *
+ * There is no shared in/out staging value, so values are passed by pointer.
+ * The Try variants never block, Enqueue/Dequeue sleep while the FIFO is
+ * full/empty and return false instead once it has been closed */
+
+#ifndef FIFO_MPMC_CACHE_LINE
+#define FIFO_MPMC_CACHE_LINE (64U)
+#endif /* FIFO_MPMC_CACHE_LINE */
+
+/* Times a blocking call yields before going to sleep */
+#ifndef FIFO_MPMC_SPIN
+#define FIFO_MPMC_SPIN (16U)
+#endif /* FIFO_MPMC_SPIN */
+
+#define FIFO_MPMC_SLOT( TYPE ) \
+    struct \
+    { \
+        atomic_size_t sequence; \
+        TYPE value; \
+    }
+
+#define FIFO_MPMC_LAYOUT_(f) \
+    (uint8_t *)(f)->slot, \
+    sizeof( (f)->slot[0] ), \
+    (size_t)( (uint8_t const *)&(f)->slot[0].value - (uint8_t const *)&(f)->slot[0] ), \
+    sizeof( (f)->slot[0].value )
+
+#define FIFO_MPMC_Init(f) \
+    FIFO_MPMC_InitBase( &(f)->base, (uint32_t)( sizeof( (f)->slot ) / sizeof( (f)->slot[0] ) ), \
+            (uint8_t *)(f)->slot, sizeof( (f)->slot[0] ) )
+
+#define FIFO_MPMC_TryEnqueue(f, val_ptr) FIFO_MPMC_TryEnQ( &(f)->base, FIFO_MPMC_LAYOUT_(f), (val_ptr) )
+#define FIFO_MPMC_TryDequeue(f, out_ptr) FIFO_MPMC_TryDeQ( &(f)->base, FIFO_MPMC_LAYOUT_(f), (out_ptr) )
+#define FIFO_MPMC_Enqueue(f, val_ptr) FIFO_MPMC_EnQ( &(f)->base, FIFO_MPMC_LAYOUT_(f), (val_ptr) )
+#define FIFO_MPMC_Dequeue(f, out_ptr) FIFO_MPMC_DeQ( &(f)->base, FIFO_MPMC_LAYOUT_(f), (out_ptr) )
+
+typedef struct
+{
+    uint32_t max;
+    _Alignas(FIFO_MPMC_CACHE_LINE) atomic_size_t enqueue_pos;
+    _Alignas(FIFO_MPMC_CACHE_LINE) atomic_size_t dequeue_pos;
+
+    /* Only touched by the blocking variants, or when someone is waiting */
+    _Alignas(FIFO_MPMC_CACHE_LINE) atomic_uint producers_waiting;
+    atomic_uint consumers_waiting;
+    atomic_bool closed;
+    pthread_mutex_t lock;
+    pthread_cond_t not_empty;
+    pthread_cond_t not_full;
+    uint64_t sleeps;
+}
+fifo_mpmc_base_t;
+
+extern void FIFO_MPMC_InitBase( fifo_mpmc_base_t * const fifo, uint32_t size, uint8_t * const slots, size_t slot_size );
+extern void FIFO_MPMC_Destroy( fifo_mpmc_base_t * const fifo );
+
+/* Wakes everyone up, after which blocking calls fail rather than wait */
+extern void FIFO_MPMC_Close( fifo_mpmc_base_t * const fifo );
+extern void FIFO_MPMC_Open( fifo_mpmc_base_t * const fifo );
+
+/* Slow paths of the blocking variants, returning false once closed */
+extern bool FIFO_MPMC_WaitNotEmpty( fifo_mpmc_base_t * const fifo );
+extern bool FIFO_MPMC_WaitNotFull( fifo_mpmc_base_t * const fifo );
+extern void FIFO_MPMC_Notify( fifo_mpmc_base_t * const fifo, pthread_cond_t * const cond );
+
+/* Approximate while other threads are using the FIFO */
+inline static uint32_t FIFO_MPMC_Fill( fifo_mpmc_base_t * const fifo )
+{
+    assert( fifo != NULL );
+    const size_t dequeue_pos = atomic_load_explicit( &fifo->dequeue_pos, memory_order_acquire );
+    const size_t enqueue_pos = atomic_load_explicit( &fifo->enqueue_pos, memory_order_acquire );
+    return (uint32_t)( enqueue_pos - dequeue_pos );
+}
+
+inline static bool FIFO_MPMC_IsEmpty( fifo_mpmc_base_t * const fifo )
+{
+    return ( FIFO_MPMC_Fill( fifo ) == 0U );
+}
+
+inline static bool FIFO_MPMC_IsFull( fifo_mpmc_base_t * const fifo )
+{
+    return ( FIFO_MPMC_Fill( fifo ) >= fifo->max );
+}
+
+inline static bool FIFO_MPMC_TryEnQ( fifo_mpmc_base_t * const fifo,
+        uint8_t * const slots,
+        size_t slot_size,
+        size_t value_offset,
+        size_t value_size,
+        void const * const value )
+{
+    assert( fifo != NULL );
+    assert( value != NULL );
+
+    size_t pos = atomic_load_explicit( &fifo->enqueue_pos, memory_order_relaxed );
+    uint8_t * slot;
+
+    while( true )
+    {
+        slot = &slots[ ( pos & ( fifo->max - 1U ) ) * slot_size ];
+        const size_t sequence = atomic_load_explicit( (atomic_size_t *)slot, memory_order_acquire );
+        const intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+
+        if( diff == 0 )
+        {
+            if( atomic_compare_exchange_weak_explicit( &fifo->enqueue_pos, &pos, pos + 1U,
+                        memory_order_seq_cst, memory_order_relaxed ) )
+            {
+                break;
+            }
+        }
+        else if( diff < 0 )
+        {
+            /* Slot still holds a value from the previous lap */
+            return false;
+        }
+        else
+        {
+            pos = atomic_load_explicit( &fifo->enqueue_pos, memory_order_relaxed );
+        }
+    }
+
+    memcpy( &slot[ value_offset ], value, value_size );
+    atomic_store_explicit( (atomic_size_t *)slot, pos + 1U, memory_order_release );
+
+    /* The claim above and this load are both seq_cst, so either a waiter
+     * in FIFO_MPMC_WaitNotEmpty sees the claim or this sees the waiter. The claim
+     * was a locked RMW anyway, so no fence is paid here */
+    if( atomic_load_explicit( &fifo->consumers_waiting, memory_order_seq_cst ) > 0U )
+    {
+        FIFO_MPMC_Notify( fifo, &fifo->not_empty );
+    }
+    return true;
+}
+
+inline static bool FIFO_MPMC_TryDeQ( fifo_mpmc_base_t * const fifo,
+        uint8_t * const slots,
+        size_t slot_size,
+        size_t value_offset,
+        size_t value_size,
+        void * const value )
+{
+    assert( fifo != NULL );
+    assert( value != NULL );
+
+    size_t pos = atomic_load_explicit( &fifo->dequeue_pos, memory_order_relaxed );
+    uint8_t * slot;
+
+    while( true )
+    {
+        slot = &slots[ ( pos & ( fifo->max - 1U ) ) * slot_size ];
+        const size_t sequence = atomic_load_explicit( (atomic_size_t *)slot, memory_order_acquire );
+        const intptr_t diff = (intptr_t)sequence - (intptr_t)( pos + 1U );
+
+        if( diff == 0 )
+        {
+            if( atomic_compare_exchange_weak_explicit( &fifo->dequeue_pos, &pos, pos + 1U,
+                        memory_order_seq_cst, memory_order_relaxed ) )
+            {
+                break;
+            }
+        }
+        else if( diff < 0 )
+        {
+            /* Nothing published in this slot yet */
+            return false;
+        }
+        else
+        {
+            pos = atomic_load_explicit( &fifo->dequeue_pos, memory_order_relaxed );
+        }
+    }
+
+    memcpy( value, &slot[ value_offset ], value_size );
+    atomic_store_explicit( (atomic_size_t *)slot, pos + fifo->max, memory_order_release );
+
+    /* The claim above and this load are both seq_cst, so either a waiter
+     * in FIFO_MPMC_WaitNotFull sees the claim or this sees the waiter. The claim
+     * was a locked RMW anyway, so no fence is paid here */
+    if( atomic_load_explicit( &fifo->producers_waiting, memory_order_seq_cst ) > 0U )
+    {
+        FIFO_MPMC_Notify( fifo, &fifo->not_full );
+    }
+    return true;
+}
+
+inline static bool FIFO_MPMC_EnQ( fifo_mpmc_base_t * const fifo,
+        uint8_t * const slots,
+        size_t slot_size,
+        size_t value_offset,
+        size_t value_size,
+        void const * const value )
+{
+    bool success = true;
+    while( success && !FIFO_MPMC_TryEnQ( fifo, slots, slot_size, value_offset, value_size, value ) )
+    {
+        success = FIFO_MPMC_WaitNotFull( fifo );
+    }
+    return success;
+}
+
+inline static bool FIFO_MPMC_DeQ( fifo_mpmc_base_t * const fifo,
+        uint8_t * const slots,
+        size_t slot_size,
+        size_t value_offset,
+        size_t value_size,
+        void * const value )
+{
+    bool success = true;
+    while( success && !FIFO_MPMC_TryDeQ( fifo, slots, slot_size, value_offset, value_size, value ) )
+    {
+        success = FIFO_MPMC_WaitNotEmpty( fifo );
+    }
+    return success;
+}
+
+#endif /* FIFO_MPMC_ */
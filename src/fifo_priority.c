@@ -0,0 +1,121 @@
+#include "fifo_priority.h"
+
+_Static_assert( FIFO_PRIORITY_LANES <= 32U, "Ready lanes are a 32-bit bitmap" );
+
+extern void FIFO_PRIORITY_Init( fifo_priority_t * const pq )
+{
+    assert( pq != NULL );
+
+    for( uint32_t idx = 0U; idx < FIFO_PRIORITY_LANES; idx++ )
+    {
+        pq->lane[idx] = (fifo_priority_lane_t){ 0 };
+    }
+    pq->ready = 0U;
+    pq->yields = 0U;
+}
+
+extern void FIFO_PRIORITY_AddLaneQueue( fifo_priority_t * const pq,
+        uint32_t lane,
+        fifo_base_t * const fifo,
+        event_t * const queue,
+        uint32_t quota )
+{
+    assert( pq != NULL );
+    assert( lane < FIFO_PRIORITY_LANES );
+    assert( pq->lane[lane].fifo == NULL );
+    assert( fifo != NULL );
+    assert( queue != NULL );
+
+    pq->lane[lane] = (fifo_priority_lane_t){ .fifo = fifo, .queue = queue, .quota = quota };
+
+    if( !FIFO_IsEmpty( fifo ) )
+    {
+        pq->ready |= ( 1U << lane );
+    }
+}
+
+extern bool FIFO_PRIORITY_Post( fifo_priority_t * const pq, uint32_t lane, event_t event )
+{
+    assert( pq != NULL );
+    assert( lane < FIFO_PRIORITY_LANES );
+    assert( pq->lane[lane].fifo != NULL );
+
+    fifo_priority_lane_t * const l = &pq->lane[lane];
+    if( !FIFO_Post( l->fifo, l->queue, &event, sizeof( event ) ) )
+    {
+        return false;
+    }
+
+    l->posted++;
+    pq->ready |= ( 1U << lane );
+    return true;
+}
+
+extern bool FIFO_PRIORITY_Take( fifo_priority_t * const pq, event_t * const event )
+{
+    assert( pq != NULL );
+    assert( event != NULL );
+
+    const uint32_t ready = pq->ready;
+    if( ready == 0U )
+    {
+        return false;
+    }
+
+    uint32_t lane = 31U - (uint32_t)__builtin_clz( ready );
+    uint32_t waiting = ready & ( ( 1U << lane ) - 1U );
+
+    /* A lane out of quota passes the turn down to the next waiting lane,
+     * which takes it against its own quota or passes it on in turn */
+    while( waiting != 0U )
+    {
+        fifo_priority_lane_t * const l = &pq->lane[lane];
+        if( ( l->quota == 0U ) || ( l->served < l->quota ) )
+        {
+            l->served++;
+            break;
+        }
+        l->served = 0U;
+        lane = 31U - (uint32_t)__builtin_clz( waiting );
+        waiting &= ( 1U << lane ) - 1U;
+        pq->yields++;
+    }
+
+    if( waiting == 0U )
+    {
+        /* Nothing below is waiting, so there is nobody to owe a turn */
+        pq->lane[lane].served = 0U;
+    }
+
+    fifo_priority_lane_t * const l = &pq->lane[lane];
+    fifo_base_t * const fifo = l->fifo;
+
+    const bool taken = FIFO_Take( fifo, l->queue, event, sizeof( *event ) );
+    if( fifo->fill == 0U )
+    {
+        pq->ready &= ~( 1U << lane );
+    }
+    if( !taken )
+    {
+        /* Emptied behind the queue's back, e.g. flushed, so with its bit
+         * now clear look again. Bounded by the number of lanes */
+        l->served = 0U;
+        return FIFO_PRIORITY_Take( pq, event );
+    }
+    l->dispatched++;
+
+    return true;
+}
+
+extern bool FIFO_PRIORITY_Dispatch( fifo_priority_t * const pq, state_t * const state )
+{
+    assert( state != NULL );
+
+    event_t event;
+    const bool taken = FIFO_PRIORITY_Take( pq, &event );
+    if( taken )
+    {
+        STATEMACHINE_Dispatch( state, event );
+    }
+    return taken;
+}
@@ -0,0 +1,69 @@
+#ifndef FIFO_PRIORITY_
+#define FIFO_PRIORITY_
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "state.h"
+#include "fifo_base.h"
+
+/* Event queue for one state machine made of up to FIFO_PRIORITY_LANES
+ * FIFOs of event_t, higher lanes are more urgent. A bitmap of non-empty
+ * lanes makes finding the next event a single count leading zeros.
+ *
+ * Strict priority would let a busy urgent lane starve the rest, so each
+ * lane has a quota: once it has been served that many times in a row while
+ * a lower lane was waiting, it passes one turn to the next lower waiting
+ * lane. Turns passed down count against the receiving lane's quota too,
+ * and a lane that has used it up passes the turn further down, so the
+ * lowest waiting lane always makes progress however many lanes above it
+ * are busy. A quota of 0 means strict priority for that lane */
+
+#ifndef FIFO_PRIORITY_LANES
+#define FIFO_PRIORITY_LANES (8U)
+#endif /* FIFO_PRIORITY_LANES */
+
+#define FIFO_PRIORITY_AddLane( pq, idx, f, quota ) \
+    FIFO_PRIORITY_AddLaneQueue( (pq), (idx), &(f)->base, (f)->queue, (quota) )
+
+typedef struct
+{
+    fifo_base_t * fifo;
+    event_t * queue;
+    uint32_t quota;
+    uint32_t served;
+    uint32_t posted;
+    uint32_t dispatched;
+}
+fifo_priority_lane_t;
+
+typedef struct
+{
+    fifo_priority_lane_t lane[FIFO_PRIORITY_LANES];
+    uint32_t ready;
+    uint32_t yields;
+}
+fifo_priority_t;
+
+extern void FIFO_PRIORITY_Init( fifo_priority_t * const pq );
+extern void FIFO_PRIORITY_AddLaneQueue( fifo_priority_t * const pq,
+        uint32_t lane,
+        fifo_base_t * const fifo,
+        event_t * const queue,
+        uint32_t quota );
+
+/* Applies the lane FIFO's overflow policy when it is full */
+extern bool FIFO_PRIORITY_Post( fifo_priority_t * const pq, uint32_t lane, event_t event );
+extern bool FIFO_PRIORITY_Take( fifo_priority_t * const pq, event_t * const event );
+
+/* Takes the next event and runs it to completion on the state machine */
+extern bool FIFO_PRIORITY_Dispatch( fifo_priority_t * const pq, state_t * const state );
+
+inline static bool FIFO_PRIORITY_IsEmpty( fifo_priority_t const * const pq )
+{
+    assert( pq != NULL );
+    return ( pq->ready == 0U );
+}
+
+#endif /* FIFO_PRIORITY_ */
@@ -0,0 +1,302 @@
+#include "fifo_shm.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define ROUND_UP( value, to ) ( ( ( value ) + ( to ) - 1U ) & ~( (size_t)( to ) - 1U ) )
+
+static void Map( fifo_shm_t * const fifo, void * const segment );
+static uint64_t Owner( pid_t pid );
+static bool Expired( struct stat const * const st );
+static fifo_shm_ret_t Reclaim( int fd, uint64_t self );
+
+#ifdef UNIT_TESTS
+void ( *FIFO_SHM_InitHook )( void ) = NULL;
+#define INIT_HOOK() ( ( FIFO_SHM_InitHook != NULL ) ? FIFO_SHM_InitHook() : (void)0 )
+#else
+#define INIT_HOOK() ( (void)0 )
+#endif
+
+extern fifo_shm_ret_t FIFO_SHM_Create( fifo_shm_t * const fifo, char const * const name, uint32_t size, uint32_t value_size )
+{
+    assert(fifo != NULL);
+    assert(name != NULL);
+    assert(size > 1U);
+    assert((size & (size - 1U )) == 0U);
+    assert(value_size > 0U);
+
+    const size_t slot_size = ROUND_UP( sizeof( uint64_t ) + value_size, sizeof( uint64_t ) );
+    const size_t slots_offset = ROUND_UP( sizeof( fifo_shm_header_t ), FIFO_SHM_CACHE_LINE );
+    const size_t segment_size = slots_offset + ( slot_size * size );
+
+    const uint64_t self = Owner( getpid() );
+    int fd = shm_open( name, O_RDWR | O_CREAT | O_EXCL, 0600 );
+    if( fd < 0 )
+    {
+        if( errno != EEXIST )
+        {
+            return FIFO_SHM_SYSTEM_ERROR;
+        }
+
+        /* Taken, but perhaps only by a creator that died half way */
+        fd = shm_open( name, O_RDWR, 0 );
+        if( fd < 0 )
+        {
+            return ( errno == ENOENT ) ? FIFO_SHM_EXISTS : FIFO_SHM_SYSTEM_ERROR;
+        }
+        const fifo_shm_ret_t ret = Reclaim( fd, self );
+        if( ret != FIFO_SHM_OK )
+        {
+            close( fd );
+            return ret;
+        }
+    }
+
+    /* A fresh object reads as zero, i.e. FIFO_SHM_INITIALISING, until the
+     * layout below is complete. A reclaimed one is still INITIALISING and
+     * is sized and laid out again from scratch */
+    void * segment = MAP_FAILED;
+    if( ftruncate( fd, (off_t)segment_size ) == 0 )
+    {
+        segment = mmap( NULL, segment_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+    }
+    close( fd );
+
+    if( segment == MAP_FAILED )
+    {
+        shm_unlink( name );
+        return FIFO_SHM_SYSTEM_ERROR;
+    }
+
+    fifo_shm_header_t * const header = segment;
+    atomic_store( &header->owner, self );
+    header->magic = 0U;
+    header->version = 0U;
+    header->max = size;
+    header->value_size = value_size;
+    header->slot_size = (uint32_t)slot_size;
+    header->slots_offset = (uint32_t)slots_offset;
+    header->segment_size = segment_size;
+    atomic_init( &header->enqueue_pos, 0U );
+    atomic_init( &header->dequeue_pos, 0U );
+
+    uint8_t * const slots = (uint8_t *)segment + slots_offset;
+    for( uint32_t idx = 0U; idx < size; idx++ )
+    {
+        atomic_init( (_Atomic uint64_t *)&slots[ idx * slot_size ], (uint64_t)idx );
+    }
+
+    INIT_HOOK();
+
+    header->magic = FIFO_SHM_MAGIC;
+    header->version = FIFO_SHM_VERSION;
+    atomic_store_explicit( &header->state, FIFO_SHM_READY, memory_order_release );
+
+    Map( fifo, segment );
+    return FIFO_SHM_OK;
+}
+
+extern fifo_shm_ret_t FIFO_SHM_Attach( fifo_shm_t * const fifo, char const * const name, uint32_t value_size )
+{
+    assert(fifo != NULL);
+    assert(name != NULL);
+
+    int fd = shm_open( name, O_RDWR, 0 );
+    if( fd < 0 )
+    {
+        return ( errno == ENOENT ) ? FIFO_SHM_NOT_FOUND : FIFO_SHM_SYSTEM_ERROR;
+    }
+
+    struct stat st;
+    if( fstat( fd, &st ) != 0 )
+    {
+        close( fd );
+        return FIFO_SHM_SYSTEM_ERROR;
+    }
+
+    /* Not even sized yet, the creator is still on its way or died */
+    if( (size_t)st.st_size < sizeof( fifo_shm_header_t ) )
+    {
+        close( fd );
+        return FIFO_SHM_NOT_READY;
+    }
+
+    void * segment = mmap( NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+    close( fd );
+    if( segment == MAP_FAILED )
+    {
+        return FIFO_SHM_SYSTEM_ERROR;
+    }
+
+    fifo_shm_header_t const * const header = segment;
+    fifo_shm_ret_t ret = FIFO_SHM_OK;
+
+    if( atomic_load_explicit( &header->state, memory_order_acquire ) != FIFO_SHM_READY )
+    {
+        ret = FIFO_SHM_NOT_READY;
+    }
+    else if( ( header->magic != FIFO_SHM_MAGIC ) ||
+             ( header->version != FIFO_SHM_VERSION ) ||
+             ( header->value_size != value_size ) ||
+             ( header->max < 2U ) ||
+             ( ( header->max & ( header->max - 1U ) ) != 0U ) ||
+             ( header->slot_size < ( sizeof( uint64_t ) + value_size ) ) ||
+             ( header->slots_offset < sizeof( fifo_shm_header_t ) ) ||
+             ( header->segment_size != (uint64_t)st.st_size ) ||
+             ( header->segment_size != ( header->slots_offset + ( (uint64_t)header->slot_size * header->max ) ) ) )
+    {
+        ret = FIFO_SHM_BAD_LAYOUT;
+    }
+
+    if( ret != FIFO_SHM_OK )
+    {
+        munmap( segment, (size_t)st.st_size );
+        return ret;
+    }
+
+    Map( fifo, segment );
+    return FIFO_SHM_OK;
+}
+
+extern void FIFO_SHM_Detach( fifo_shm_t * const fifo )
+{
+    assert(fifo != NULL);
+
+    if( fifo->header != NULL )
+    {
+        munmap( fifo->header, fifo->segment_size );
+        fifo->header = NULL;
+        fifo->slots = NULL;
+    }
+}
+
+extern void FIFO_SHM_Unlink( char const * const name )
+{
+    assert(name != NULL);
+    shm_unlink( name );
+}
+
+/* Copies the layout out of the segment, so a later scribble over the
+ * header cannot send this process outside its mapping */
+static void Map( fifo_shm_t * const fifo, void * const segment )
+{
+    fifo_shm_header_t * const header = segment;
+
+    fifo->header = header;
+    fifo->slots = (uint8_t *)segment + header->slots_offset;
+    fifo->max = header->max;
+    fifo->value_size = header->value_size;
+    fifo->slot_size = header->slot_size;
+    fifo->segment_size = (size_t)header->segment_size;
+}
+
+/* Identifies a live process by its pid and the low bits of its start time,
+ * so a recycled pid does not pass for the original. 0 when the process is
+ * gone, or is a zombie */
+static uint64_t Owner( pid_t pid )
+{
+    char path[ 32 ];
+    char line[ 512 ];
+
+    snprintf( path, sizeof( path ), "/proc/%d/stat", (int)pid );
+    const int fd = open( path, O_RDONLY );
+    if( fd < 0 )
+    {
+        return 0U;
+    }
+    const ssize_t len = read( fd, line, sizeof( line ) - 1U );
+    close( fd );
+    if( len <= 0 )
+    {
+        return 0U;
+    }
+    line[ len ] = '\0';
+
+    /* The command name can hold spaces and brackets, the fields after it
+     * start with the state and the start time is the 20th */
+    char const * field = strrchr( line, ')' );
+    if( ( field == NULL ) || ( field[ 1 ] != ' ' ) || ( field[ 2 ] == 'Z' ) || ( field[ 2 ] == 'X' ) )
+    {
+        return 0U;
+    }
+    field += 2;
+    for( uint32_t idx = 0U; ( idx < 19U ) && ( field != NULL ); idx++ )
+    {
+        field = strchr( field, ' ' );
+        field = ( field != NULL ) ? ( field + 1 ) : NULL;
+    }
+    if( field == NULL )
+    {
+        return 0U;
+    }
+    const uint64_t start = strtoull( field, NULL, 10 );
+
+    return ( (uint64_t)(uint32_t)pid << 32U ) | (uint32_t)start;
+}
+
+/* True once a segment has gone FIFO_SHM_STALE_MS without a change */
+static bool Expired( struct stat const * const st )
+{
+    struct timespec now;
+    clock_gettime( CLOCK_REALTIME, &now );
+
+    const int64_t age_ms = ( ( (int64_t)now.tv_sec - (int64_t)st->st_ctim.tv_sec ) * 1000 ) +
+        ( ( (int64_t)now.tv_nsec - (int64_t)st->st_ctim.tv_nsec ) / 1000000 );
+    return ( age_ms >= (int64_t)FIFO_SHM_STALE_MS );
+}
+
+/* Makes this process the owner of an existing segment if it never became
+ * ready and its owner has gone. The segment is only ever grown here, as a
+ * slower reclaimer may still be looking at the header, and is sized for
+ * the new layout once it is ours */
+static fifo_shm_ret_t Reclaim( int fd, uint64_t self )
+{
+    struct stat st;
+    if( fstat( fd, &st ) != 0 )
+    {
+        return FIFO_SHM_SYSTEM_ERROR;
+    }
+
+    if( (size_t)st.st_size < sizeof( fifo_shm_header_t ) )
+    {
+        if( !Expired( &st ) )
+        {
+            return FIFO_SHM_EXISTS;
+        }
+        if( posix_fallocate( fd, 0, (off_t)sizeof( fifo_shm_header_t ) ) != 0 )
+        {
+            return FIFO_SHM_SYSTEM_ERROR;
+        }
+    }
+
+    fifo_shm_header_t * const header = mmap( NULL, sizeof( fifo_shm_header_t ),
+            PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+    if( header == MAP_FAILED )
+    {
+        return FIFO_SHM_SYSTEM_ERROR;
+    }
+
+    fifo_shm_ret_t ret = FIFO_SHM_EXISTS;
+    uint64_t owner = atomic_load( &header->owner );
+
+    if( atomic_load_explicit( &header->state, memory_order_acquire ) == FIFO_SHM_READY )
+    {
+        /* Finished, the name is properly taken */
+    }
+    else if( ( owner == 0U ) ? !Expired( &st ) : ( Owner( (pid_t)( owner >> 32U ) ) == owner ) )
+    {
+        /* Its creator is still on its way */
+    }
+    else if( atomic_compare_exchange_strong( &header->owner, &owner, self ) )
+    {
+        ret = FIFO_SHM_OK;
+    }
+
+    munmap( header, sizeof( fifo_shm_header_t ) );
+    return ret;
+}
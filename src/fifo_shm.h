@@ -0,0 +1,209 @@
+#ifndef FIFO_SHM_
+#define FIFO_SHM_
+
+#include <assert.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/* Bounded multi producer, multi consumer FIFO whose header and slots live
+ * in a POSIX shared memory object, so processes can post events to each
+ * other's state machines. It is the same sequenced ring as fifo_mpmc, with
+ * fixed width fields so every process sees the same layout, and only the
+ * non-blocking variants, so the fast path never makes a syscall, e.g.
+ *
+ * fifo_shm_t fifo;
+ * FIFO_SHM_Create( &fifo, "/events", 256U, sizeof( event_t ) );  // owner
+ * FIFO_SHM_Attach( &fifo, "/events", sizeof( event_t ) );        // others
+ * FIFO_SHM_TryEnqueue( &fifo, &event );
+ *
+ * The creator fills in the layout before marking the header ready, so a
+ * creator that dies half way leaves a segment that Attach refuses rather
+ * than one it misreads. The creator's pid and start time are recorded as
+ * the segment's owner first thing, and a later Create takes over a segment
+ * that is still initialising once its owner has gone, rather than finding
+ * the name taken for good. An owner is only ever replaced by one atomic
+ * exchange, so two processes reclaiming at once cannot both win. A segment
+ * with no owner recorded yet is only reclaimed when it is older than
+ * FIFO_SHM_STALE_MS.
+ *
+ * A segment from another layout version, or with a different value size,
+ * is refused by Attach the same way. A process that exits between claiming
+ * and publishing a slot leaves the consumers stalled on it, which is the
+ * price of the ring not taking locks */
+
+#define FIFO_SHM_MAGIC (0x46534D51U)
+#define FIFO_SHM_VERSION (1U)
+
+/* How long a creator has to record itself as owner */
+#ifndef FIFO_SHM_STALE_MS
+#define FIFO_SHM_STALE_MS (1000U)
+#endif /* FIFO_SHM_STALE_MS */
+
+#ifndef FIFO_SHM_CACHE_LINE
+#define FIFO_SHM_CACHE_LINE (64U)
+#endif /* FIFO_SHM_CACHE_LINE */
+
+/* Atomics in the segment must not fall back to a process local lock */
+_Static_assert( ATOMIC_LLONG_LOCK_FREE == 2, "shared memory FIFO needs lock-free 64 bit atomics" );
+_Static_assert( ATOMIC_INT_LOCK_FREE == 2, "shared memory FIFO needs lock-free 32 bit atomics" );
+
+#define FIFO_SHM_TryEnqueue(f, val_ptr) FIFO_SHM_TryEnQ( (f), (val_ptr), sizeof( *(val_ptr) ) )
+#define FIFO_SHM_TryDequeue(f, out_ptr) FIFO_SHM_TryDeQ( (f), (out_ptr), sizeof( *(out_ptr) ) )
+
+typedef enum
+{
+    FIFO_SHM_OK,
+    FIFO_SHM_EXISTS,
+    FIFO_SHM_NOT_FOUND,
+    FIFO_SHM_NOT_READY,
+    FIFO_SHM_BAD_LAYOUT,
+    FIFO_SHM_SYSTEM_ERROR,
+}
+fifo_shm_ret_t;
+
+enum
+{
+    FIFO_SHM_INITIALISING,
+    FIFO_SHM_READY,
+};
+
+/* Start of the shared segment, the slots follow on the next cache line */
+typedef struct
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t max;
+    uint32_t value_size;
+    uint32_t slot_size;
+    uint32_t slots_offset;
+    uint64_t segment_size;
+    _Atomic uint32_t state;
+    _Atomic uint64_t owner;
+    _Alignas(FIFO_SHM_CACHE_LINE) _Atomic uint64_t enqueue_pos;
+    _Alignas(FIFO_SHM_CACHE_LINE) _Atomic uint64_t dequeue_pos;
+}
+fifo_shm_header_t;
+
+/* Process local view of the segment */
+typedef struct
+{
+    fifo_shm_header_t * header;
+    uint8_t * slots;
+    uint32_t max;
+    uint32_t value_size;
+    uint32_t slot_size;
+    size_t segment_size;
+}
+fifo_shm_t;
+
+extern fifo_shm_ret_t FIFO_SHM_Create( fifo_shm_t * const fifo, char const * const name, uint32_t size, uint32_t value_size );
+extern fifo_shm_ret_t FIFO_SHM_Attach( fifo_shm_t * const fifo, char const * const name, uint32_t value_size );
+extern void FIFO_SHM_Detach( fifo_shm_t * const fifo );
+extern void FIFO_SHM_Unlink( char const * const name );
+
+#ifdef UNIT_TESTS
+/* Called by Create once the owner is recorded and before the segment is
+ * marked ready, so tests can stop or kill a creator half way */
+extern void ( *FIFO_SHM_InitHook )( void );
+#endif
+
+/* Approximate while other processes are using the FIFO */
+inline static uint32_t FIFO_SHM_Fill( fifo_shm_t const * const fifo )
+{
+    assert( fifo != NULL );
+    const uint64_t dequeue_pos = atomic_load_explicit( &fifo->header->dequeue_pos, memory_order_acquire );
+    const uint64_t enqueue_pos = atomic_load_explicit( &fifo->header->enqueue_pos, memory_order_acquire );
+    return (uint32_t)( enqueue_pos - dequeue_pos );
+}
+
+inline static bool FIFO_SHM_IsEmpty( fifo_shm_t const * const fifo )
+{
+    return ( FIFO_SHM_Fill( fifo ) == 0U );
+}
+
+inline static bool FIFO_SHM_TryEnQ( fifo_shm_t * const fifo, void const * const value, size_t value_size )
+{
+    assert( fifo != NULL );
+    assert( fifo->header != NULL );
+    assert( value != NULL );
+    assert( value_size == fifo->value_size );
+    (void)value_size;
+
+    fifo_shm_header_t * const header = fifo->header;
+    uint64_t pos = atomic_load_explicit( &header->enqueue_pos, memory_order_relaxed );
+    uint8_t * slot;
+
+    while( true )
+    {
+        slot = &fifo->slots[ ( pos & ( fifo->max - 1U ) ) * fifo->slot_size ];
+        const uint64_t sequence = atomic_load_explicit( (_Atomic uint64_t *)slot, memory_order_acquire );
+        const int64_t diff = (int64_t)( sequence - pos );
+
+        if( diff == 0 )
+        {
+            if( atomic_compare_exchange_weak_explicit( &header->enqueue_pos, &pos, pos + 1U,
+                        memory_order_relaxed, memory_order_relaxed ) )
+            {
+                break;
+            }
+        }
+        else if( diff < 0 )
+        {
+            return false;
+        }
+        else
+        {
+            pos = atomic_load_explicit( &header->enqueue_pos, memory_order_relaxed );
+        }
+    }
+
+    memcpy( &slot[ sizeof( uint64_t ) ], value, fifo->value_size );
+    atomic_store_explicit( (_Atomic uint64_t *)slot, pos + 1U, memory_order_release );
+    return true;
+}
+
+inline static bool FIFO_SHM_TryDeQ( fifo_shm_t * const fifo, void * const value, size_t value_size )
+{
+    assert( fifo != NULL );
+    assert( fifo->header != NULL );
+    assert( value != NULL );
+    assert( value_size == fifo->value_size );
+    (void)value_size;
+
+    fifo_shm_header_t * const header = fifo->header;
+    uint64_t pos = atomic_load_explicit( &header->dequeue_pos, memory_order_relaxed );
+    uint8_t * slot;
+
+    while( true )
+    {
+        slot = &fifo->slots[ ( pos & ( fifo->max - 1U ) ) * fifo->slot_size ];
+        const uint64_t sequence = atomic_load_explicit( (_Atomic uint64_t *)slot, memory_order_acquire );
+        const int64_t diff = (int64_t)( sequence - ( pos + 1U ) );
+
+        if( diff == 0 )
+        {
+            if( atomic_compare_exchange_weak_explicit( &header->dequeue_pos, &pos, pos + 1U,
+                        memory_order_relaxed, memory_order_relaxed ) )
+            {
+                break;
+            }
+        }
+        else if( diff < 0 )
+        {
+            return false;
+        }
+        else
+        {
+            pos = atomic_load_explicit( &header->dequeue_pos, memory_order_relaxed );
+        }
+    }
+
+    memcpy( value, &slot[ sizeof( uint64_t ) ], fifo->value_size );
+    atomic_store_explicit( (_Atomic uint64_t *)slot, pos + fifo->max, memory_order_release );
+    return true;
+}
+
+#endif /* FIFO_SHM_ */
@@ -0,0 +1,46 @@
+#include "fifo_spsc.h"
+
+static void virtual_EnQ( fifo_spsc_base_t * const fifo );
+static void virtual_DeQ( fifo_spsc_base_t * const fifo );
+static void virtual_Peek( fifo_spsc_base_t * const fifo );
+
+extern void FIFO_SPSC_Init( fifo_spsc_base_t * const fifo, uint32_t size )
+{
+    assert(fifo != NULL);
+    assert(size > 0U);
+    assert((size & (size - 1U )) == 0U);
+    /* Free running indices must wrap on a multiple of the size */
+    assert(size <= ( 1U << 31U ));
+
+    static const fifo_spsc_vfunc_t vfunc =
+    {
+        .enq = virtual_EnQ,
+        .deq = virtual_DeQ,
+        .peek = virtual_Peek,
+    };
+
+    fifo->vfunc = &vfunc;
+    fifo->max = size;
+    atomic_init( &fifo->write_index, 0U );
+    atomic_init( &fifo->read_index, 0U );
+    fifo->cached_read = 0U;
+    fifo->cached_write = 0U;
+}
+
+static void virtual_EnQ( fifo_spsc_base_t * const fifo )
+{
+    (void)fifo;
+    assert(false);
+}
+
+static void virtual_DeQ( fifo_spsc_base_t * const fifo )
+{
+    (void)fifo;
+    assert(false);
+}
+
+static void virtual_Peek( fifo_spsc_base_t * const fifo )
+{
+    (void)fifo;
+    assert(false);
+}
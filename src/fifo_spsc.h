@@ -0,0 +1,151 @@
+#ifndef FIFO_SPSC_
+#define FIFO_SPSC_
+
+#include <assert.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Single producer, single consumer variant of fifo_base_t. The producer
+ * owns the write index and the consumer owns the read index, each on its
+ * own cache line, so there is no shared fill counter and no lock. The
+ * typed FIFO must keep in and out apart as well, e.g.
+ *
+ * typedef struct
+ * {
+ *     fifo_spsc_base_t base;
+ *     event_t queue[LEN];
+ *     _Alignas(FIFO_SPSC_CACHE_LINE) event_t in;
+ *     _Alignas(FIFO_SPSC_CACHE_LINE) event_t out;
+ * }
+ * event_spsc_fifo_t;
+ *
+ * Only the producer may call Enqueue/IsFull and only the consumer may call
+ * Dequeue/Peek/IsEmpty/Fill */
+
+#ifndef FIFO_SPSC_CACHE_LINE
+#define FIFO_SPSC_CACHE_LINE (64U)
+#endif /* FIFO_SPSC_CACHE_LINE */
+
+#define FIFO_SPSC_Enqueue(f, val) ((f)->in = (val), FIFO_SPSC_EnQ((fifo_spsc_base_t *)(f)))
+#define FIFO_SPSC_Dequeue(f) ((FIFO_SPSC_DeQ((fifo_spsc_base_t *)(f))), (f)->out)
+#define FIFO_SPSC_Peek(f) ((FIFO_SPSC_Pk((fifo_spsc_base_t *)(f))), (f)->out)
+
+/* Indices run freely and are masked on access, the store of the index is
+ * what publishes the slot to the other side */
+#define SPSC_ENQUEUE_BOILERPLATE(TYPE, BASE) \
+    { \
+        TYPE * fifo = ((TYPE *)(BASE)); \
+        const uint32_t write_index = atomic_load_explicit( &fifo->base.write_index, memory_order_relaxed ); \
+        \
+        fifo->queue[ write_index & ( fifo->base.max - 1U ) ] = fifo->in; \
+        atomic_store_explicit( &fifo->base.write_index, write_index + 1U, memory_order_release ); \
+    }
+
+#define SPSC_DEQUEUE_BOILERPLATE(TYPE, BASE) \
+    { \
+        TYPE * fifo = ((TYPE *)(BASE)); \
+        const uint32_t read_index = atomic_load_explicit( &fifo->base.read_index, memory_order_relaxed ); \
+        \
+        fifo->out = fifo->queue[ read_index & ( fifo->base.max - 1U ) ]; \
+        atomic_store_explicit( &fifo->base.read_index, read_index + 1U, memory_order_release ); \
+    }
+
+#define SPSC_PEEK_BOILERPLATE(TYPE, BASE) \
+    { \
+        TYPE * fifo = ((TYPE *)(BASE)); \
+        const uint32_t read_index = atomic_load_explicit( &fifo->base.read_index, memory_order_relaxed ); \
+        \
+        fifo->out = fifo->queue[ read_index & ( fifo->base.max - 1U ) ]; \
+    }
+
+typedef struct fifo_spsc_vfunc_t fifo_spsc_vfunc_t;
+typedef struct
+{
+    fifo_spsc_vfunc_t const * vfunc;
+    uint32_t max;
+
+    /* Producer side, with its last view of the read index */
+    _Alignas(FIFO_SPSC_CACHE_LINE) atomic_uint write_index;
+    uint32_t cached_read;
+
+    /* Consumer side, with its last view of the write index */
+    _Alignas(FIFO_SPSC_CACHE_LINE) atomic_uint read_index;
+    uint32_t cached_write;
+}
+fifo_spsc_base_t;
+
+struct fifo_spsc_vfunc_t
+{
+    void (*enq)(fifo_spsc_base_t * const base);
+    void (*deq)(fifo_spsc_base_t * const base);
+    void (*peek)(fifo_spsc_base_t * const base);
+};
+
+extern void FIFO_SPSC_Init( fifo_spsc_base_t * const fifo, uint32_t size );
+
+/* Producer side */
+inline static bool FIFO_SPSC_IsFull( fifo_spsc_base_t * const fifo )
+{
+    assert( fifo != NULL );
+
+    const uint32_t write_index = atomic_load_explicit( &fifo->write_index, memory_order_relaxed );
+    if( ( write_index - fifo->cached_read ) == fifo->max )
+    {
+        /* Only go to the consumer's cache line when the old view says full */
+        fifo->cached_read = atomic_load_explicit( &fifo->read_index, memory_order_acquire );
+    }
+    return ( ( write_index - fifo->cached_read ) == fifo->max );
+}
+
+/* Consumer side */
+inline static bool FIFO_SPSC_IsEmpty( fifo_spsc_base_t * const fifo )
+{
+    assert( fifo != NULL );
+
+    const uint32_t read_index = atomic_load_explicit( &fifo->read_index, memory_order_relaxed );
+    if( read_index == fifo->cached_write )
+    {
+        fifo->cached_write = atomic_load_explicit( &fifo->write_index, memory_order_acquire );
+    }
+    return ( read_index == fifo->cached_write );
+}
+
+/* Consumer side, a lower bound while the producer is running */
+inline static uint32_t FIFO_SPSC_Fill( fifo_spsc_base_t * const fifo )
+{
+    assert( fifo != NULL );
+
+    fifo->cached_write = atomic_load_explicit( &fifo->write_index, memory_order_acquire );
+    return fifo->cached_write - atomic_load_explicit( &fifo->read_index, memory_order_relaxed );
+}
+
+inline static void FIFO_SPSC_EnQ( fifo_spsc_base_t * const fifo )
+{
+    assert( fifo != NULL );
+    assert( fifo->vfunc != NULL );
+    assert( !FIFO_SPSC_IsFull( fifo ) );
+
+    (fifo->vfunc->enq)(fifo);
+}
+
+inline static void FIFO_SPSC_DeQ( fifo_spsc_base_t * const fifo )
+{
+    assert( fifo != NULL );
+    assert( fifo->vfunc != NULL );
+    assert( !FIFO_SPSC_IsEmpty( fifo ) );
+
+    (fifo->vfunc->deq)(fifo);
+}
+
+inline static void FIFO_SPSC_Pk( fifo_spsc_base_t * const fifo )
+{
+    assert( fifo != NULL );
+    assert( fifo->vfunc != NULL );
+    assert( !FIFO_SPSC_IsEmpty( fifo ) );
+
+    (fifo->vfunc->peek)(fifo);
+}
+
+#endif /* FIFO_SPSC_ */
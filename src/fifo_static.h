@@ -0,0 +1,149 @@
+#ifndef FIFO_STATIC_H
+#define FIFO_STATIC_H
+
+#include "fifo_base.h"
+
+/* Statically typed FIFO, e.g.
+ *
+ * GENERATE_FIFO( event_fifo, event_t, 32U );
+ *
+ * declares event_fifo_t along with event_fifo_Init, _Post,
+ * _PushUnchecked, _Pop, _Peek, _Flush, _IsEmpty, _IsFull and _Fill, plus
+ * _Reserve/_Commit and _Front/_Release for building and consuming slots in
+ * place. Post applies the FIFO's overflow policy. PushUnchecked only
+ * asserts there is room and overruns the ring under NDEBUG, so it is for
+ * callers that have already checked _IsFull. These take and return values directly and use CAPACITY as
+ * the mask, so nothing goes through the vfunc. The layout matches the
+ * hand written FIFOs, and Init installs a vfunc built from the
+ * boilerplate macros, so &fifo->base still works with
+ * FIFO_Enqueue/FIFO_Dequeue etc for polymorphic users. */
+#define GENERATE_FIFO( NAME, TYPE, CAPACITY ) \
+    typedef struct \
+    { \
+        fifo_base_t base; \
+        TYPE queue[ (CAPACITY) ]; \
+        TYPE in; \
+        TYPE out; \
+    } \
+    NAME##_t; \
+    \
+    static inline void NAME##_BaseEnqueue( fifo_base_t * const base ) ENQUEUE_BOILERPLATE( NAME##_t, base ) \
+    static inline void NAME##_BaseDequeue( fifo_base_t * const base ) DEQUEUE_BOILERPLATE( NAME##_t, base ) \
+    static inline void NAME##_BasePeek( fifo_base_t * const base ) PEEK_BOILERPLATE( NAME##_t, base ) \
+    static inline void NAME##_BaseFlush( fifo_base_t * const base ) FLUSH_BOILERPLATE( NAME##_t, base ) \
+    static inline uint32_t NAME##_BaseEnqueueN( fifo_base_t * const base, void const * const values, uint32_t count ) \
+        ENQUEUE_N_BOILERPLATE( NAME##_t, base, values, count ) \
+    static inline uint32_t NAME##_BaseDequeueN( fifo_base_t * const base, void * const values, uint32_t count ) \
+        DEQUEUE_N_BOILERPLATE( NAME##_t, base, values, count ) \
+    static inline bool NAME##_BaseContains( fifo_base_t const * const base, void const * const value ) \
+        CONTAINS_BOILERPLATE( NAME##_t, base, value ) \
+    \
+    static inline void NAME##_Init( NAME##_t * const fifo ) \
+    { \
+        static const fifo_vfunc_t vfunc = \
+        { \
+            .enq = NAME##_BaseEnqueue, \
+            .deq = NAME##_BaseDequeue, \
+            .peek = NAME##_BasePeek, \
+            .flush = NAME##_BaseFlush, \
+            .enq_n = NAME##_BaseEnqueueN, \
+            .deq_n = NAME##_BaseDequeueN, \
+            .contains = NAME##_BaseContains, \
+        }; \
+        assert( fifo != NULL ); \
+        memset( fifo, 0x00, sizeof( *fifo ) ); \
+        FIFO_Init( &fifo->base, (CAPACITY) ); \
+        fifo->base.vfunc = &vfunc; \
+    } \
+    \
+    static inline uint32_t NAME##_Fill( NAME##_t const * const fifo ) \
+    { \
+        return fifo->base.fill; \
+    } \
+    \
+    static inline bool NAME##_IsEmpty( NAME##_t const * const fifo ) \
+    { \
+        return ( fifo->base.fill == 0U ); \
+    } \
+    \
+    static inline bool NAME##_IsFull( NAME##_t const * const fifo ) \
+    { \
+        return ( fifo->base.fill == (CAPACITY) ); \
+    } \
+    \
+    static inline void NAME##_PushUnchecked( NAME##_t * const fifo, TYPE value ) \
+    { \
+        assert( fifo->base.fill < (CAPACITY) ); \
+        fifo->queue[ fifo->base.write_index ] = value; \
+        fifo->base.write_index = ( fifo->base.write_index + 1U ) & ( (CAPACITY) - 1U ); \
+        fifo->base.fill++; \
+        FIFO_HighWater( &fifo->base ); \
+    } \
+    \
+    static inline bool NAME##_Post( NAME##_t * const fifo, TYPE value ) \
+    { \
+        if( fifo->base.fill == (CAPACITY) ) \
+        { \
+            const fifo_overflow_ret_t ret = FIFO_Overflow( &fifo->base, &value ); \
+            if( ret != FIFO_OVERFLOW_ROOM ) \
+            { \
+                return ( ret == FIFO_OVERFLOW_MERGED ); \
+            } \
+        } \
+        NAME##_PushUnchecked( fifo, value ); \
+        return true; \
+    } \
+    \
+    static inline TYPE NAME##_Pop( NAME##_t * const fifo ) \
+    { \
+        assert( fifo->base.fill > 0U ); \
+        TYPE value = fifo->queue[ fifo->base.read_index ]; \
+        fifo->base.read_index = ( fifo->base.read_index + 1U ) & ( (CAPACITY) - 1U ); \
+        fifo->base.fill--; \
+        return value; \
+    } \
+    \
+    static inline TYPE NAME##_Peek( NAME##_t const * const fifo ) \
+    { \
+        assert( fifo->base.fill > 0U ); \
+        return fifo->queue[ fifo->base.read_index ]; \
+    } \
+    \
+    /* NULL when full and the overflow policy cannot make room */ \
+    static inline TYPE * NAME##_Reserve( NAME##_t * const fifo ) \
+    { \
+        return FIFO_Rsv( &fifo->base ) ? &fifo->queue[ fifo->base.write_index ] : NULL; \
+    } \
+    \
+    static inline void NAME##_Commit( NAME##_t * const fifo ) \
+    { \
+        assert( fifo->base.fill < (CAPACITY) ); \
+        fifo->base.write_index = ( fifo->base.write_index + 1U ) & ( (CAPACITY) - 1U ); \
+        fifo->base.fill++; \
+        FIFO_HighWater( &fifo->base ); \
+    } \
+    \
+    static inline TYPE * NAME##_Front( NAME##_t * const fifo ) \
+    { \
+        assert( fifo->base.fill > 0U ); \
+        return &fifo->queue[ fifo->base.read_index ]; \
+    } \
+    \
+    static inline void NAME##_Release( NAME##_t * const fifo ) \
+    { \
+        assert( fifo->base.fill > 0U ); \
+        fifo->base.read_index = ( fifo->base.read_index + 1U ) & ( (CAPACITY) - 1U ); \
+        fifo->base.fill--; \
+    } \
+    \
+    static inline void NAME##_Flush( NAME##_t * const fifo ) \
+    { \
+        fifo->base.read_index = 0U; \
+        fifo->base.write_index = 0U; \
+        fifo->base.fill = 0U; \
+    } \
+    \
+    _Static_assert( ( (CAPACITY) > 0U ) && ( ( (CAPACITY) & ( (CAPACITY) - 1U ) ) == 0U ), \
+        #NAME " capacity must be a power of 2" )
+
+#endif /* FIFO_STATIC_H */
@@ -0,0 +1,269 @@
+#include "fifo_wait.h"
+#include <errno.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+
+static void Signal( fifo_wait_t * const wait );
+static int64_t NowMs( void );
+static bool WaitNotFull( fifo_wait_t * const wait );
+
+extern bool FIFO_WAIT_InitQueue( fifo_wait_t * const wait, fifo_base_t * const fifo, size_t size )
+{
+    assert(wait != NULL);
+    assert(fifo != NULL);
+    assert(fifo->vfunc != NULL);
+    /* Values are only ever copied with the span entries */
+    assert(fifo->vfunc->enq_n != NULL);
+    assert(fifo->vfunc->deq_n != NULL);
+
+    wait->fd = eventfd( 0U, EFD_NONBLOCK | EFD_CLOEXEC );
+    if( wait->fd < 0 )
+    {
+        return false;
+    }
+
+    wait->fifo = fifo;
+    wait->size = size;
+    pthread_mutex_init( &wait->lock, NULL );
+
+    pthread_condattr_t attr;
+    pthread_condattr_init( &attr );
+    pthread_condattr_setclock( &attr, CLOCK_MONOTONIC );
+    pthread_cond_init( &wait->not_full, &attr );
+    pthread_condattr_destroy( &attr );
+    wait->producers_waiting = 0U;
+    atomic_init( &wait->woken, false );
+    wait->signals = 0U;
+
+    return true;
+}
+
+extern void FIFO_WAIT_Destroy( fifo_wait_t * const wait )
+{
+    assert(wait != NULL);
+
+    close( wait->fd );
+    wait->fd = -1;
+    pthread_cond_destroy( &wait->not_full );
+    pthread_mutex_destroy( &wait->lock );
+}
+
+extern bool FIFO_WAIT_Post( fifo_wait_t * const wait, void const * const value )
+{
+    assert(wait != NULL);
+    assert(value != NULL);
+
+    fifo_base_t * const fifo = wait->fifo;
+
+    pthread_mutex_lock( &wait->lock );
+    if( FIFO_IsFull( fifo ) )
+    {
+        fifo_overflow_ret_t ret = FIFO_OVERFLOW_ROOM;
+        if( ( fifo->overflow.policy != FIFO_OVERFLOW_BLOCK ) || !WaitNotFull( wait ) )
+        {
+            ret = FIFO_Overflow( fifo, value );
+        }
+
+        if( ret != FIFO_OVERFLOW_ROOM )
+        {
+            pthread_mutex_unlock( &wait->lock );
+            return ( ret == FIFO_OVERFLOW_MERGED );
+        }
+    }
+
+    /* Dropping or overwriting leaves the FIFO non-empty, so only a post
+     * into a FIFO with room can be the edge */
+    const bool edge = FIFO_IsEmpty( fifo );
+    (void)FIFO_EnQN( fifo, value, 1U, wait->size );
+    if( edge )
+    {
+        wait->signals++;
+    }
+    pthread_mutex_unlock( &wait->lock );
+
+    if( edge )
+    {
+        Signal( wait );
+    }
+
+    return true;
+}
+
+extern uint32_t FIFO_WAIT_PostN( fifo_wait_t * const wait, void const * const values, uint32_t count )
+{
+    assert(wait != NULL);
+
+    pthread_mutex_lock( &wait->lock );
+    const bool was_empty = FIFO_IsEmpty( wait->fifo );
+    const uint32_t moved = FIFO_EnQN( wait->fifo, values, count, wait->size );
+    const bool edge = was_empty && ( moved > 0U );
+    if( edge )
+    {
+        wait->signals++;
+    }
+    pthread_mutex_unlock( &wait->lock );
+
+    /* A consumer only sleeps on an empty FIFO, so this is the one post it
+     * can be waiting for */
+    if( edge )
+    {
+        Signal( wait );
+    }
+
+    return moved;
+}
+
+extern bool FIFO_WAIT_TryTake( fifo_wait_t * const wait, void * const value )
+{
+    return ( FIFO_WAIT_TakeN( wait, value, 1U ) == 1U );
+}
+
+extern uint32_t FIFO_WAIT_TakeN( fifo_wait_t * const wait, void * const values, uint32_t count )
+{
+    assert(wait != NULL);
+
+    pthread_mutex_lock( &wait->lock );
+    const uint32_t moved = FIFO_DeQN( wait->fifo, values, count );
+    if( ( moved > 0U ) && ( wait->producers_waiting > 0U ) )
+    {
+        pthread_cond_broadcast( &wait->not_full );
+    }
+    pthread_mutex_unlock( &wait->lock );
+
+    return moved;
+}
+
+extern bool FIFO_WAIT_IsEmpty( fifo_wait_t * const wait )
+{
+    assert(wait != NULL);
+
+    pthread_mutex_lock( &wait->lock );
+    const bool empty = FIFO_IsEmpty( wait->fifo );
+    pthread_mutex_unlock( &wait->lock );
+
+    return empty;
+}
+
+extern bool FIFO_WAIT_Wait( fifo_wait_t * const wait, int32_t timeout_ms )
+{
+    assert(wait != NULL);
+
+    const int64_t deadline = NowMs() + timeout_ms;
+
+    while( true )
+    {
+        if( !FIFO_WAIT_IsEmpty( wait ) )
+        {
+            return true;
+        }
+
+        if( atomic_exchange( &wait->woken, false ) )
+        {
+            return false;
+        }
+
+        int remaining = -1;
+        if( timeout_ms >= 0 )
+        {
+            const int64_t left = deadline - NowMs();
+            if( left <= 0 )
+            {
+                return false;
+            }
+            remaining = (int)left;
+        }
+
+        /* The counter can be left over from an edge the consumer already
+         * drained without waiting, so readiness is only a hint to look
+         * again */
+        struct pollfd pfd = { .fd = wait->fd, .events = POLLIN, .revents = 0 };
+        if( poll( &pfd, 1U, remaining ) > 0 )
+        {
+            FIFO_WAIT_Acknowledge( wait );
+        }
+    }
+}
+
+extern void FIFO_WAIT_Wake( fifo_wait_t * const wait )
+{
+    assert(wait != NULL);
+
+    atomic_store( &wait->woken, true );
+    Signal( wait );
+}
+
+extern int FIFO_WAIT_Fd( fifo_wait_t const * const wait )
+{
+    assert(wait != NULL);
+    return wait->fd;
+}
+
+extern void FIFO_WAIT_Acknowledge( fifo_wait_t * const wait )
+{
+    assert(wait != NULL);
+
+    uint64_t count;
+    while( ( read( wait->fd, &count, sizeof( count ) ) < 0 ) && ( errno == EINTR ) )
+    {
+    }
+}
+
+static void Signal( fifo_wait_t * const wait )
+{
+    const uint64_t one = 1U;
+
+    /* Only fails with EAGAIN if the counter is saturated, which still
+     * leaves the fd readable */
+    while( ( write( wait->fd, &one, sizeof( one ) ) < 0 ) && ( errno == EINTR ) )
+    {
+    }
+}
+
+/* Called with the lock held and the FIFO full, returns false if it is
+ * still full once the policy timeout has passed */
+static bool WaitNotFull( fifo_wait_t * const wait )
+{
+    fifo_base_t * const fifo = wait->fifo;
+    const int32_t timeout_ms = fifo->overflow.timeout_ms;
+
+    struct timespec deadline;
+    clock_gettime( CLOCK_MONOTONIC, &deadline );
+    deadline.tv_sec += timeout_ms / 1000;
+    deadline.tv_nsec += (long)( timeout_ms % 1000 ) * 1000000L;
+    if( deadline.tv_nsec >= 1000000000L )
+    {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    fifo->overflow.blocked++;
+    wait->producers_waiting++;
+    while( FIFO_IsFull( fifo ) )
+    {
+        if( timeout_ms < 0 )
+        {
+            pthread_cond_wait( &wait->not_full, &wait->lock );
+        }
+        else if( pthread_cond_timedwait( &wait->not_full, &wait->lock, &deadline ) == ETIMEDOUT )
+        {
+            break;
+        }
+    }
+    wait->producers_waiting--;
+
+    if( FIFO_IsFull( fifo ) )
+    {
+        fifo->overflow.timeouts++;
+        return false;
+    }
+    return true;
+}
+
+static int64_t NowMs( void )
+{
+    struct timespec now;
+    clock_gettime( CLOCK_MONOTONIC, &now );
+    return ( (int64_t)now.tv_sec * 1000 ) + ( now.tv_nsec / 1000000 );
+}
@@ -0,0 +1,66 @@
+#ifndef FIFO_WAIT_
+#define FIFO_WAIT_
+
+#include <assert.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "fifo_base.h"
+
+/* Waitable wrapper around a FIFO base class, so consumer threads can sleep
+ * until there is something to take rather than poll FIFO_IsEmpty. The
+ * wrapper owns an eventfd that is only written on the empty to non-empty
+ * edge, bursts into a non-empty FIFO cost nothing beyond the lock.
+ *
+ * Values are copied with the span vfunc entries (enq_n/deq_n), which any
+ * FIFO from GENERATE_FIFO provides. The wrapped FIFO must only be used
+ * through the wrapper once it has been attached.
+ *
+ * FIFO_WAIT_Post applies the FIFO's overflow policy. With
+ * FIFO_OVERFLOW_BLOCK it waits up to the policy timeout for a consumer to
+ * make room before rejecting. FIFO_WAIT_PostN applies it to whatever does
+ * not fit, except that it never blocks.
+ *
+ * From an epoll loop, register FIFO_WAIT_Fd for EPOLLIN and, when it is
+ * readable, call FIFO_WAIT_Acknowledge before draining with
+ * FIFO_WAIT_TakeN until it returns 0 */
+
+typedef struct
+{
+    fifo_base_t * fifo;
+    size_t size;
+    pthread_mutex_t lock;
+    pthread_cond_t not_full;
+    uint32_t producers_waiting;
+    int fd;
+    atomic_bool woken;
+    uint64_t signals;
+}
+fifo_wait_t;
+
+/* Returns false if the eventfd could not be created */
+#define FIFO_WAIT_Init( w, f ) FIFO_WAIT_InitQueue( (w), &(f)->base, sizeof( (f)->queue[0] ) )
+
+extern bool FIFO_WAIT_InitQueue( fifo_wait_t * const wait, fifo_base_t * const fifo, size_t size );
+extern void FIFO_WAIT_Destroy( fifo_wait_t * const wait );
+
+/* Return whether the value was accepted / the number of values accepted.
+ * PostN never waits, under FIFO_OVERFLOW_BLOCK what does not fit is
+ * rejected */
+extern bool FIFO_WAIT_Post( fifo_wait_t * const wait, void const * const value );
+extern uint32_t FIFO_WAIT_PostN( fifo_wait_t * const wait, void const * const values, uint32_t count );
+extern bool FIFO_WAIT_TryTake( fifo_wait_t * const wait, void * const value );
+extern uint32_t FIFO_WAIT_TakeN( fifo_wait_t * const wait, void * const values, uint32_t count );
+
+/* Sleeps until the FIFO is not empty, returning false if it is still empty
+ * after timeout_ms (negative waits forever) or FIFO_WAIT_Wake was called */
+extern bool FIFO_WAIT_Wait( fifo_wait_t * const wait, int32_t timeout_ms );
+extern void FIFO_WAIT_Wake( fifo_wait_t * const wait );
+
+extern int FIFO_WAIT_Fd( fifo_wait_t const * const wait );
+extern void FIFO_WAIT_Acknowledge( fifo_wait_t * const wait );
+extern bool FIFO_WAIT_IsEmpty( fifo_wait_t * const wait );
+
+#endif /* FIFO_WAIT_ */
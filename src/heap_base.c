@@ -57,6 +57,75 @@ extern void Heap_Push(heap_t * heap, uint32_t data)
     heap->fill++; 
 }
 
+/* Sink idx until both children are larger or it reaches the bottom */
+static void Sink(heap_t * heap, uint32_t idx)
+{
+    uint32_t jdx = (idx << 1U) + 1U;
+
+    while(jdx < heap->fill)
+    {
+        if( ( (jdx + 1U) < heap->fill ) && (heap->heap[jdx] > heap->heap[jdx+1]) )
+        {
+            jdx++;
+        }
+
+        if(heap->heap[idx] <= heap->heap[jdx])
+        {
+            break;
+        }
+        swap(&heap->heap[idx], &heap->heap[jdx]);
+        idx = jdx;
+        jdx = (idx << 1U) + 1U;
+    }
+}
+
+/* Floyd's construction, every parent from the last one up to the root
+ * is sunk into the heaps below it. O(n) rather than O(n log n) for n
+ * pushes, and it walks the array backwards instead of hopping */
+static void Heapify(heap_t * heap)
+{
+    for( uint32_t idx = heap->fill >> 1U; idx > 0U; idx-- )
+    {
+        Sink(heap, idx - 1U);
+    }
+}
+
+/* Replaces the contents with len values */
+extern void Heap_Build(heap_t * heap, uint32_t const * data, uint32_t len)
+{
+    assert(heap != NULL);
+    assert(data != NULL);
+    assert(len <= heap->max);
+
+    memcpy(heap->heap, data, sizeof(uint32_t) * len);
+    memset(&heap->heap[len], 0xFF, sizeof(uint32_t) * (heap->max - len));
+    heap->fill = len;
+    Heapify(heap);
+}
+
+/* Adds len values. When they at least match what is already there it is
+ * cheaper to append them all and heapify the lot than to swim each one */
+extern void Heap_PushN(heap_t * heap, uint32_t const * data, uint32_t len)
+{
+    assert(heap != NULL);
+    assert(data != NULL);
+    assert((heap->fill + len) <= heap->max);
+
+    if( len < heap->fill )
+    {
+        for( uint32_t idx = 0U; idx < len; idx++ )
+        {
+            Heap_Push(heap, data[idx]);
+        }
+    }
+    else
+    {
+        memcpy(&heap->heap[heap->fill], data, sizeof(uint32_t) * len);
+        heap->fill += len;
+        Heapify(heap);
+    }
+}
+
 extern uint32_t Heap_Peek(heap_t * heap)
 {
     assert(heap != NULL);
@@ -15,6 +15,8 @@ heap_t;
 
 extern void Heap_Init(heap_t * heap);
 extern void Heap_Push(heap_t * heap, uint32_t data);
+extern void Heap_Build(heap_t * heap, uint32_t const * data, uint32_t len);
+extern void Heap_PushN(heap_t * heap, uint32_t const * data, uint32_t len);
 extern uint32_t Heap_Pop(heap_t * heap);
 extern uint32_t Heap_Peek(heap_t * heap);
 extern bool Heap_IsEmpty(heap_t * heap);
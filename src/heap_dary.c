@@ -0,0 +1,227 @@
+#include "heap_dary.h"
+#include <pthread.h>
+#include <string.h>
+
+#if defined( __x86_64__ ) || defined( __i386__ )
+#include <immintrin.h>
+#define HEAP_DARY_X86
+#endif
+
+_Static_assert( ( HEAP_DARY_D == 4U ) || ( HEAP_DARY_D == 8U ), "d-ary heap supports D of 4 or 8" );
+_Static_assert( ( HEAP_DARY_D * sizeof( uint32_t ) ) <= HEAP_DARY_ALIGN, "sibling group must fit a cache line" );
+
+/* Sift down with the group minimum inlined, one copy per backend. k is
+ * offset so that k[0] is the root and the children of i are
+ * k[D * i + 1] .. k[D * i + D] */
+#define SIFT_DOWN( NAME, MIN_CHILD, ATTR ) \
+    ATTR static uint32_t NAME( heap_dary_t * const heap ) \
+    { \
+        uint32_t * const k = &heap->key[ HEAP_DARY_D - 1U ]; \
+        const uint32_t top = k[ 0U ]; \
+        const uint32_t fill = --heap->fill; \
+        const uint32_t last = k[ fill ]; \
+        \
+        k[ fill ] = UINT32_MAX; \
+        uint32_t idx = 0U; \
+        uint32_t first = 1U; \
+        while( first < fill ) \
+        { \
+            const uint32_t child = first + MIN_CHILD( &k[ first ] ); \
+            if( ( child >= fill ) || ( k[ child ] >= last ) ) \
+            { \
+                break; \
+            } \
+            k[ idx ] = k[ child ]; \
+            idx = child; \
+            first = ( HEAP_DARY_D * idx ) + 1U; \
+        } \
+        if( fill > 0U ) \
+        { \
+            k[ idx ] = last; \
+        } \
+        return top; \
+    }
+
+static inline uint32_t MinChildScalar( uint32_t const * const group )
+{
+    uint32_t min = 0U;
+    for( uint32_t idx = 1U; idx < HEAP_DARY_D; idx++ )
+    {
+        if( group[ idx ] < group[ min ] )
+        {
+            min = idx;
+        }
+    }
+    return min;
+}
+
+SIFT_DOWN( PopScalar, MinChildScalar, )
+
+#ifdef HEAP_DARY_X86
+/* Lowest lane holding the minimum, ties go to the lowest index so real
+ * children win over the UINT32_MAX padding */
+__attribute__(( target( "sse4.1" ) ))
+static inline uint32_t MinChildSSE41( uint32_t const * const group )
+{
+#if HEAP_DARY_D == 8U
+    const __m128i lo = _mm_load_si128( (__m128i const *)group );
+    const __m128i hi = _mm_load_si128( (__m128i const *)&group[ 4U ] );
+    __m128i min = _mm_min_epu32( lo, hi );
+#else
+    const __m128i lo = _mm_load_si128( (__m128i const *)group );
+    __m128i min = lo;
+#endif
+    min = _mm_min_epu32( min, _mm_shuffle_epi32( min, 0x4E ) );
+    min = _mm_min_epu32( min, _mm_shuffle_epi32( min, 0xB1 ) );
+
+    uint32_t mask = (uint32_t)_mm_movemask_ps( _mm_castsi128_ps( _mm_cmpeq_epi32( lo, min ) ) );
+#if HEAP_DARY_D == 8U
+    mask |= (uint32_t)_mm_movemask_ps( _mm_castsi128_ps( _mm_cmpeq_epi32( hi, min ) ) ) << 4U;
+#endif
+    return (uint32_t)__builtin_ctz( mask );
+}
+
+SIFT_DOWN( PopSSE41, MinChildSSE41, __attribute__(( target( "sse4.1" ) )) )
+
+__attribute__(( target( "avx2" ) ))
+static inline uint32_t MinChildAVX2( uint32_t const * const group )
+{
+#if HEAP_DARY_D == 8U
+    const __m256i keys = _mm256_load_si256( (__m256i const *)group );
+    __m256i min = _mm256_min_epu32( keys, _mm256_permute2x128_si256( keys, keys, 0x01 ) );
+    min = _mm256_min_epu32( min, _mm256_shuffle_epi32( min, 0x4E ) );
+    min = _mm256_min_epu32( min, _mm256_shuffle_epi32( min, 0xB1 ) );
+    const uint32_t mask = (uint32_t)_mm256_movemask_ps( _mm256_castsi256_ps( _mm256_cmpeq_epi32( keys, min ) ) );
+    return (uint32_t)__builtin_ctz( mask );
+#else
+    return MinChildSSE41( group );
+#endif
+}
+
+SIFT_DOWN( PopAVX2, MinChildAVX2, __attribute__(( target( "avx2" ) )) )
+#endif /* HEAP_DARY_X86 */
+
+static bool Select( heap_dary_backend_t selected );
+static void SelectAuto( void );
+
+/* The automatic pick runs exactly once, on the first Init or selection
+ * from any thread, so concurrent Inits never race on pop and backend */
+static pthread_once_t selected_once = PTHREAD_ONCE_INIT;
+static heap_dary_backend_t backend = HEAP_DARY_AUTO;
+static uint32_t ( *pop )( heap_dary_t * const heap ) = NULL;
+
+extern bool HeapDary_SelectBackend( heap_dary_backend_t selected )
+{
+    (void)pthread_once( &selected_once, SelectAuto );
+    return Select( selected );
+}
+
+static void SelectAuto( void )
+{
+    (void)Select( HEAP_DARY_AUTO );
+}
+
+static bool Select( heap_dary_backend_t selected )
+{
+    bool supported = true;
+
+#ifdef HEAP_DARY_X86
+    __builtin_cpu_init();
+    const bool avx2 = __builtin_cpu_supports( "avx2" );
+    const bool sse41 = __builtin_cpu_supports( "sse4.1" );
+#else
+    const bool avx2 = false;
+    const bool sse41 = false;
+#endif
+
+    /* The AVX2 group is one load but needs a cross lane permute before
+     * the in lane shuffles, which measures slower than two SSE4.1 loads
+     * for 8 keys, so auto only falls back to it without SSE4.1 */
+    if( selected == HEAP_DARY_AUTO )
+    {
+        selected = sse41 ? HEAP_DARY_SSE41 : ( avx2 ? HEAP_DARY_AVX2 : HEAP_DARY_SCALAR );
+    }
+
+    switch( selected )
+    {
+#ifdef HEAP_DARY_X86
+        case HEAP_DARY_AVX2:
+            supported = avx2;
+            if( supported )
+            {
+                pop = PopAVX2;
+            }
+            break;
+        case HEAP_DARY_SSE41:
+            supported = sse41;
+            if( supported )
+            {
+                pop = PopSSE41;
+            }
+            break;
+#endif
+        case HEAP_DARY_SCALAR:
+            pop = PopScalar;
+            break;
+        default:
+            supported = false;
+            break;
+    }
+
+    if( supported )
+    {
+        backend = selected;
+    }
+    return supported;
+}
+
+extern heap_dary_backend_t HeapDary_Backend( void )
+{
+    (void)pthread_once( &selected_once, SelectAuto );
+    return backend;
+}
+
+extern void HeapDary_Init( heap_dary_t * const heap, uint32_t * const storage, uint32_t capacity )
+{
+    assert( heap != NULL );
+    assert( storage != NULL );
+    assert( capacity > 0U );
+    assert( ( (uintptr_t)storage % HEAP_DARY_ALIGN ) == 0U );
+
+    (void)pthread_once( &selected_once, SelectAuto );
+
+    heap->key = storage;
+    heap->fill = 0U;
+    heap->max = capacity;
+    memset( storage, 0xFF, HEAP_DARY_STORAGE_LEN( capacity ) * sizeof( uint32_t ) );
+}
+
+extern void HeapDary_Push( heap_dary_t * const heap, uint32_t key )
+{
+    assert( heap != NULL );
+    assert( heap->fill < heap->max );
+
+    uint32_t * const k = &heap->key[ HEAP_DARY_D - 1U ];
+    uint32_t idx = heap->fill++;
+
+    while( idx > 0U )
+    {
+        const uint32_t parent = ( idx - 1U ) / HEAP_DARY_D;
+        if( k[ parent ] <= key )
+        {
+            break;
+        }
+        k[ idx ] = k[ parent ];
+        idx = parent;
+    }
+    k[ idx ] = key;
+}
+
+extern uint32_t HeapDary_Pop( heap_dary_t * const heap )
+{
+    assert( heap != NULL );
+    assert( heap->fill > 0U );
+    assert( pop != NULL );
+
+    return pop( heap );
+}
@@ -0,0 +1,78 @@
+#ifndef HEAP_DARY_H
+#define HEAP_DARY_H
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* d-ary min-heap of uint32_t keys for large timer sets. The keys are
+ * stored offset by D - 1 so the D children of every node start on a
+ * multiple of D, and with D * 4 bytes <= 64 a whole sibling group sits in
+ * one cache line. Sift down then touches one line per level, with a third
+ * of the levels of a binary heap for D = 8.
+ *
+ * The minimum of a sibling group is found with SSE4.1 or AVX2 when the
+ * CPU has them, or a scalar loop otherwise. The backend is picked once at
+ * run time, on first use from any thread, and can be forced with
+ * HeapDary_SelectBackend before heaps are shared between threads.
+ * Slots past the end hold UINT32_MAX so a partial group can be compared
+ * as a whole. Storage is provided by the caller, e.g.
+ *
+ * HEAP_DARY_STORAGE( timers, 4096U );
+ * HeapDary_Init( &heap, timers, 4096U ); */
+
+#ifndef HEAP_DARY_D
+#define HEAP_DARY_D (8U)
+#endif /* HEAP_DARY_D */
+
+#define HEAP_DARY_ALIGN (64U)
+#define HEAP_DARY_STORAGE_LEN( CAPACITY ) ( (CAPACITY) + ( 2U * HEAP_DARY_D ) )
+#define HEAP_DARY_STORAGE( NAME, CAPACITY ) \
+    static _Alignas( HEAP_DARY_ALIGN ) uint32_t NAME[ HEAP_DARY_STORAGE_LEN( CAPACITY ) ]
+
+typedef enum
+{
+    HEAP_DARY_AUTO,
+    HEAP_DARY_SCALAR,
+    HEAP_DARY_SSE41,
+    HEAP_DARY_AVX2,
+}
+heap_dary_backend_t;
+
+typedef struct
+{
+    uint32_t * key;
+    uint32_t fill;
+    uint32_t max;
+}
+heap_dary_t;
+
+extern void HeapDary_Init( heap_dary_t * const heap, uint32_t * const storage, uint32_t capacity );
+extern void HeapDary_Push( heap_dary_t * const heap, uint32_t key );
+extern uint32_t HeapDary_Pop( heap_dary_t * const heap );
+
+/* Returns false, leaving the backend alone, if the CPU lacks it */
+extern bool HeapDary_SelectBackend( heap_dary_backend_t backend );
+extern heap_dary_backend_t HeapDary_Backend( void );
+
+inline static uint32_t HeapDary_Peek( heap_dary_t const * const heap )
+{
+    assert( heap != NULL );
+    assert( heap->fill > 0U );
+    return heap->key[ HEAP_DARY_D - 1U ];
+}
+
+inline static bool HeapDary_IsEmpty( heap_dary_t const * const heap )
+{
+    assert( heap != NULL );
+    return ( heap->fill == 0U );
+}
+
+inline static bool HeapDary_IsFull( heap_dary_t const * const heap )
+{
+    assert( heap != NULL );
+    return ( heap->fill == heap->max );
+}
+
+#endif /* HEAP_DARY_H */
@@ -0,0 +1,254 @@
+#ifndef HEAP_INDEXED_H
+#define HEAP_INDEXED_H
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Handle to an element of an indexed heap, stays valid until the element
+ * is popped or removed. A stale handle is detected rather than aliasing
+ * whichever element reused its slot, until that slot has been reused 2^32
+ * times */
+typedef uint64_t heap_handle_t;
+
+#define HEAP_HANDLE_INVALID ( UINT64_MAX )
+#define HEAP_INDEXED_FREE ( 0x80000000U )
+
+/* Binary min-heap with stable handles, e.g.
+ *
+ * #define DEADLINE_LESS( a, b ) ( (a)->deadline < (b)->deadline )
+ * GENERATE_INDEXED_HEAP( timers, deadline_t, 1024U, DEADLINE_LESS );
+ *
+ * declares timers_t along with timers_Init, _Push, _Pop, _Peek,
+ * _PeekHandle, _Get, _Contains, _Remove, _Update, _IsEmpty, _IsFull and
+ * _Fill. Push returns a handle that can later cancel the element with
+ * Remove or reschedule it with Update, both O(log n), so nothing has to
+ * be left behind as a tombstone.
+ *
+ * Elements stay in a slot array and the heap orders slot numbers, with
+ * pos mapping each slot back to its heap index, so sifting moves 4 byte
+ * indices however large TYPE is. Each slot has a generation that is
+ * bumped when it is freed, and a handle is the slot in the low 32 bits and
+ * its generation in the high 32. Free slots are chained through pos with
+ * HEAP_INDEXED_FREE set */
+#define GENERATE_INDEXED_HEAP( NAME, TYPE, CAPACITY, LESS ) \
+    typedef struct \
+    { \
+        uint32_t fill; \
+        uint32_t free; \
+        uint32_t heap[ (CAPACITY) ]; \
+        uint32_t pos[ (CAPACITY) ]; \
+        uint32_t generation[ (CAPACITY) ]; \
+        TYPE item[ (CAPACITY) ]; \
+    } \
+    NAME##_t; \
+    \
+    static inline void NAME##_Init( NAME##_t * const heap ) \
+    { \
+        assert( heap != NULL ); \
+        heap->fill = 0U; \
+        heap->free = 0U; \
+        for( uint32_t slot = 0U; slot < (CAPACITY); slot++ ) \
+        { \
+            heap->pos[ slot ] = HEAP_INDEXED_FREE | ( slot + 1U ); \
+            heap->generation[ slot ] = 0U; \
+        } \
+    } \
+    \
+    static inline uint32_t NAME##_Fill( NAME##_t const * const heap ) \
+    { \
+        return heap->fill; \
+    } \
+    \
+    static inline bool NAME##_IsEmpty( NAME##_t const * const heap ) \
+    { \
+        return ( heap->fill == 0U ); \
+    } \
+    \
+    static inline bool NAME##_IsFull( NAME##_t const * const heap ) \
+    { \
+        return ( heap->fill == (CAPACITY) ); \
+    } \
+    \
+    static inline heap_handle_t NAME##_Handle( NAME##_t const * const heap, uint32_t slot ) \
+    { \
+        return ( (uint64_t)heap->generation[ slot ] << 32U ) | slot; \
+    } \
+    \
+    /* Slot of a live handle, or CAPACITY when stale or invalid */ \
+    static inline uint32_t NAME##_Slot( NAME##_t const * const heap, heap_handle_t handle ) \
+    { \
+        const uint32_t slot = (uint32_t)handle; \
+        if( ( slot >= (CAPACITY) ) || \
+            ( heap->pos[ slot ] & HEAP_INDEXED_FREE ) || \
+            ( heap->generation[ slot ] != (uint32_t)( handle >> 32U ) ) ) \
+        { \
+            return (CAPACITY); \
+        } \
+        return slot; \
+    } \
+    \
+    static inline bool NAME##_Less( NAME##_t const * const heap, uint32_t a, uint32_t b ) \
+    { \
+        return LESS( &heap->item[ a ], &heap->item[ b ] ); \
+    } \
+    \
+    static inline void NAME##_Place( NAME##_t * const heap, uint32_t idx, uint32_t slot ) \
+    { \
+        heap->heap[ idx ] = slot; \
+        heap->pos[ slot ] = idx; \
+    } \
+    \
+    static inline void NAME##_SiftUp( NAME##_t * const heap, uint32_t idx ) \
+    { \
+        const uint32_t slot = heap->heap[ idx ]; \
+        while( idx > 0U ) \
+        { \
+            const uint32_t parent = ( idx - 1U ) >> 1U; \
+            if( !NAME##_Less( heap, slot, heap->heap[ parent ] ) ) \
+            { \
+                break; \
+            } \
+            NAME##_Place( heap, idx, heap->heap[ parent ] ); \
+            idx = parent; \
+        } \
+        NAME##_Place( heap, idx, slot ); \
+    } \
+    \
+    static inline void NAME##_SiftDown( NAME##_t * const heap, uint32_t idx ) \
+    { \
+        const uint32_t slot = heap->heap[ idx ]; \
+        const uint32_t fill = heap->fill; \
+        uint32_t child = ( idx << 1U ) + 1U; \
+        while( child < fill ) \
+        { \
+            if( ( ( child + 1U ) < fill ) && NAME##_Less( heap, heap->heap[ child + 1U ], heap->heap[ child ] ) ) \
+            { \
+                child++; \
+            } \
+            if( !NAME##_Less( heap, heap->heap[ child ], slot ) ) \
+            { \
+                break; \
+            } \
+            NAME##_Place( heap, idx, heap->heap[ child ] ); \
+            idx = child; \
+            child = ( idx << 1U ) + 1U; \
+        } \
+        NAME##_Place( heap, idx, slot ); \
+    } \
+    \
+    /* Takes the element at heap index idx out and frees its slot */ \
+    static inline TYPE NAME##_RemoveAt( NAME##_t * const heap, uint32_t idx ) \
+    { \
+        const uint32_t slot = heap->heap[ idx ]; \
+        const TYPE value = heap->item[ slot ]; \
+        const uint32_t fill = --heap->fill; \
+        \
+        if( idx < fill ) \
+        { \
+            NAME##_Place( heap, idx, heap->heap[ fill ] ); \
+            if( ( idx > 0U ) && NAME##_Less( heap, heap->heap[ idx ], heap->heap[ ( idx - 1U ) >> 1U ] ) ) \
+            { \
+                NAME##_SiftUp( heap, idx ); \
+            } \
+            else \
+            { \
+                NAME##_SiftDown( heap, idx ); \
+            } \
+        } \
+        \
+        heap->generation[ slot ]++; \
+        heap->pos[ slot ] = HEAP_INDEXED_FREE | heap->free; \
+        heap->free = slot; \
+        return value; \
+    } \
+    \
+    static inline heap_handle_t NAME##_Push( NAME##_t * const heap, TYPE value ) \
+    { \
+        assert( heap != NULL ); \
+        assert( heap->fill < (CAPACITY) ); \
+        \
+        const uint32_t slot = heap->free; \
+        heap->free = heap->pos[ slot ] & ~HEAP_INDEXED_FREE; \
+        heap->item[ slot ] = value; \
+        NAME##_Place( heap, heap->fill, slot ); \
+        NAME##_SiftUp( heap, heap->fill++ ); \
+        return NAME##_Handle( heap, slot ); \
+    } \
+    \
+    static inline TYPE const * NAME##_Peek( NAME##_t const * const heap ) \
+    { \
+        assert( heap != NULL ); \
+        assert( heap->fill > 0U ); \
+        return &heap->item[ heap->heap[ 0U ] ]; \
+    } \
+    \
+    static inline heap_handle_t NAME##_PeekHandle( NAME##_t const * const heap ) \
+    { \
+        assert( heap != NULL ); \
+        assert( heap->fill > 0U ); \
+        return NAME##_Handle( heap, heap->heap[ 0U ] ); \
+    } \
+    \
+    static inline TYPE NAME##_Pop( NAME##_t * const heap ) \
+    { \
+        assert( heap != NULL ); \
+        assert( heap->fill > 0U ); \
+        return NAME##_RemoveAt( heap, 0U ); \
+    } \
+    \
+    static inline bool NAME##_Contains( NAME##_t const * const heap, heap_handle_t handle ) \
+    { \
+        assert( heap != NULL ); \
+        return ( NAME##_Slot( heap, handle ) < (CAPACITY) ); \
+    } \
+    \
+    /* NULL when the handle is stale */ \
+    static inline TYPE const * NAME##_Get( NAME##_t const * const heap, heap_handle_t handle ) \
+    { \
+        assert( heap != NULL ); \
+        const uint32_t slot = NAME##_Slot( heap, handle ); \
+        return ( slot < (CAPACITY) ) ? &heap->item[ slot ] : NULL; \
+    } \
+    \
+    /* False, and nothing removed, when the handle is stale */ \
+    static inline bool NAME##_Remove( NAME##_t * const heap, heap_handle_t handle ) \
+    { \
+        assert( heap != NULL ); \
+        const uint32_t slot = NAME##_Slot( heap, handle ); \
+        if( slot == (CAPACITY) ) \
+        { \
+            return false; \
+        } \
+        (void)NAME##_RemoveAt( heap, heap->pos[ slot ] ); \
+        return true; \
+    } \
+    \
+    /* Replaces the element, moving it up or down as the new key needs. The \
+     * handle stays the same. False when the handle is stale */ \
+    static inline bool NAME##_Update( NAME##_t * const heap, heap_handle_t handle, TYPE value ) \
+    { \
+        assert( heap != NULL ); \
+        const uint32_t slot = NAME##_Slot( heap, handle ); \
+        if( slot == (CAPACITY) ) \
+        { \
+            return false; \
+        } \
+        const bool up = LESS( &value, &heap->item[ slot ] ); \
+        heap->item[ slot ] = value; \
+        if( up ) \
+        { \
+            NAME##_SiftUp( heap, heap->pos[ slot ] ); \
+        } \
+        else \
+        { \
+            NAME##_SiftDown( heap, heap->pos[ slot ] ); \
+        } \
+        return true; \
+    } \
+    \
+    _Static_assert( ( (CAPACITY) > 0U ) && ( (CAPACITY) < HEAP_INDEXED_FREE ), \
+        #NAME " capacity must be non-zero and below 2^31" )
+
+#endif /* HEAP_INDEXED_H */
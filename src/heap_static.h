@@ -0,0 +1,159 @@
+#ifndef HEAP_STATIC_H
+#define HEAP_STATIC_H
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/* Statically typed binary min-heap over any record type, e.g.
+ *
+ * typedef struct { uint64_t deadline; event_t event; } deadline_t;
+ * #define DEADLINE_LESS( a, b ) ( (a)->deadline < (b)->deadline )
+ * GENERATE_HEAP( deadline_heap, deadline_t, 1024U, DEADLINE_LESS );
+ *
+ * declares deadline_heap_t along with deadline_heap_Init, _Push, _Pop,
+ * _Peek, _Build, _PushN, _IsEmpty, _IsFull and _Fill. LESS is a function
+ * or function-like macro given two TYPE const pointers, and is expanded
+ * inline so the compare costs no call. Elements are moved into the hole
+ * left on the way up or down rather than swapped. Ties come out in no
+ * particular order */
+#define GENERATE_HEAP( NAME, TYPE, CAPACITY, LESS ) \
+    typedef struct \
+    { \
+        uint32_t fill; \
+        TYPE heap[ (CAPACITY) ]; \
+    } \
+    NAME##_t; \
+    \
+    static inline void NAME##_Init( NAME##_t * const heap ) \
+    { \
+        assert( heap != NULL ); \
+        heap->fill = 0U; \
+    } \
+    \
+    static inline uint32_t NAME##_Fill( NAME##_t const * const heap ) \
+    { \
+        return heap->fill; \
+    } \
+    \
+    static inline bool NAME##_IsEmpty( NAME##_t const * const heap ) \
+    { \
+        return ( heap->fill == 0U ); \
+    } \
+    \
+    static inline bool NAME##_IsFull( NAME##_t const * const heap ) \
+    { \
+        return ( heap->fill == (CAPACITY) ); \
+    } \
+    \
+    static inline void NAME##_Push( NAME##_t * const heap, TYPE value ) \
+    { \
+        assert( heap != NULL ); \
+        assert( heap->fill < (CAPACITY) ); \
+        \
+        uint32_t idx = heap->fill++; \
+        while( idx > 0U ) \
+        { \
+            const uint32_t parent = ( idx - 1U ) >> 1U; \
+            if( !LESS( &value, &heap->heap[ parent ] ) ) \
+            { \
+                break; \
+            } \
+            heap->heap[ idx ] = heap->heap[ parent ]; \
+            idx = parent; \
+        } \
+        heap->heap[ idx ] = value; \
+    } \
+    \
+    /* Sinks the element at idx, moving smaller children up into the hole */ \
+    static inline void NAME##_Sink( NAME##_t * const heap, uint32_t idx ) \
+    { \
+        const TYPE value = heap->heap[ idx ]; \
+        const uint32_t fill = heap->fill; \
+        uint32_t child = ( idx << 1U ) + 1U; \
+        while( child < fill ) \
+        { \
+            if( ( ( child + 1U ) < fill ) && LESS( &heap->heap[ child + 1U ], &heap->heap[ child ] ) ) \
+            { \
+                child++; \
+            } \
+            if( !LESS( &heap->heap[ child ], &value ) ) \
+            { \
+                break; \
+            } \
+            heap->heap[ idx ] = heap->heap[ child ]; \
+            idx = child; \
+            child = ( idx << 1U ) + 1U; \
+        } \
+        heap->heap[ idx ] = value; \
+    } \
+    \
+    /* Floyd's bottom up construction over the current fill, O(n) */ \
+    static inline void NAME##_Heapify( NAME##_t * const heap ) \
+    { \
+        for( uint32_t idx = heap->fill >> 1U; idx > 0U; idx-- ) \
+        { \
+            NAME##_Sink( heap, idx - 1U ); \
+        } \
+    } \
+    \
+    /* Replaces the contents with count values */ \
+    static inline void NAME##_Build( NAME##_t * const heap, TYPE const * const values, uint32_t count ) \
+    { \
+        assert( heap != NULL ); \
+        assert( values != NULL ); \
+        assert( count <= (CAPACITY) ); \
+        memcpy( heap->heap, values, sizeof( TYPE ) * count ); \
+        heap->fill = count; \
+        NAME##_Heapify( heap ); \
+    } \
+    \
+    /* Appends and heapifies when count is at least the current fill, \
+     * otherwise pushes one at a time */ \
+    static inline void NAME##_PushN( NAME##_t * const heap, TYPE const * const values, uint32_t count ) \
+    { \
+        assert( heap != NULL ); \
+        assert( values != NULL ); \
+        assert( ( heap->fill + count ) <= (CAPACITY) ); \
+        if( count < heap->fill ) \
+        { \
+            for( uint32_t idx = 0U; idx < count; idx++ ) \
+            { \
+                NAME##_Push( heap, values[ idx ] ); \
+            } \
+        } \
+        else \
+        { \
+            memcpy( &heap->heap[ heap->fill ], values, sizeof( TYPE ) * count ); \
+            heap->fill += count; \
+            NAME##_Heapify( heap ); \
+        } \
+    } \
+    \
+    static inline TYPE const * NAME##_Peek( NAME##_t const * const heap ) \
+    { \
+        assert( heap != NULL ); \
+        assert( heap->fill > 0U ); \
+        return &heap->heap[ 0U ]; \
+    } \
+    \
+    static inline TYPE NAME##_Pop( NAME##_t * const heap ) \
+    { \
+        assert( heap != NULL ); \
+        assert( heap->fill > 0U ); \
+        \
+        const TYPE top = heap->heap[ 0U ]; \
+        const uint32_t fill = --heap->fill; \
+        if( fill > 0U ) \
+        { \
+            heap->heap[ 0U ] = heap->heap[ fill ]; \
+            NAME##_Sink( heap, 0U ); \
+        } \
+        return top; \
+    } \
+    \
+    _Static_assert( (CAPACITY) > 0U, #NAME " capacity must be non-zero" )
+
+#endif /* HEAP_STATIC_H */
@@ -0,0 +1,198 @@
+#include "scheduler.h"
+
+_Static_assert( SCHEDULER_PRIORITIES <= 32U, "Ready set is a 32-bit bitmap" );
+
+extern void ActiveObject_InitQueue( active_object_t * const ao, 
+        state_t * const state, 
+        fifo_base_t * const fifo,
+        event_t * const queue )
+{
+    assert( ao != NULL );
+    assert( state != NULL );
+    assert( fifo != NULL );
+    assert( queue != NULL );
+
+    ao->state = state;
+    ao->fifo = fifo;
+    ao->queue = queue;
+    ao->lanes = NULL;
+    ao->priority = 0U;
+    ao->posted = 0U;
+    ao->dispatched = 0U;
+    ao->dropped = 0U;
+    ao->high_water = 0U;
+}
+
+extern void ActiveObject_InitLanes( active_object_t * const ao,
+        state_t * const state,
+        fifo_priority_t * const lanes )
+{
+    assert( ao != NULL );
+    assert( state != NULL );
+    assert( lanes != NULL );
+
+    ao->state = state;
+    ao->fifo = NULL;
+    ao->queue = NULL;
+    ao->lanes = lanes;
+    ao->priority = 0U;
+    ao->posted = 0U;
+    ao->dispatched = 0U;
+    ao->dropped = 0U;
+    ao->high_water = 0U;
+}
+
+static bool HasEvents( active_object_t const * const ao )
+{
+    return ( ao->lanes != NULL ) ? !FIFO_PRIORITY_IsEmpty( ao->lanes ) : !FIFO_IsEmpty( ao->fifo );
+}
+
+/* Accounting shared by both kinds of post, fifo is the queue that was
+ * posted to. Called with the critical section held */
+static void Posted( scheduler_t * const sched, active_object_t * const ao, fifo_base_t const * const fifo, bool success )
+{
+    if( success )
+    {
+        ao->posted++;
+        if( fifo->fill > ao->high_water )
+        {
+            ao->high_water = fifo->fill;
+        }
+        sched->ready |= ( 1U << ao->priority );
+    }
+    else
+    {
+        ao->dropped++;
+    }
+}
+
+extern void Scheduler_Init( scheduler_t * const sched )
+{
+    assert( sched != NULL );
+
+    for( uint32_t idx = 0U; idx < SCHEDULER_PRIORITIES; idx++ )
+    {
+        sched->object[idx] = NULL;
+    }
+    sched->ready = 0U;
+    sched->idle = NULL;
+    sched->idle_arg = NULL;
+}
+
+extern void Scheduler_SetIdle( scheduler_t * const sched, scheduler_idle_t idle, void * arg )
+{
+    assert( sched != NULL );
+    
+    sched->idle = idle;
+    sched->idle_arg = arg;
+}
+
+extern void Scheduler_Register( scheduler_t * const sched, active_object_t * const ao, uint32_t priority )
+{
+    assert( sched != NULL );
+    assert( ao != NULL );
+    assert( priority < SCHEDULER_PRIORITIES );
+    /* Priorities are unique */
+    assert( sched->object[priority] == NULL );
+
+    ao->priority = priority;
+    sched->object[priority] = ao;
+
+    if( HasEvents( ao ) )
+    {
+        sched->ready |= ( 1U << priority );
+    }
+}
+
+extern bool Scheduler_Post( scheduler_t * const sched, active_object_t * const ao, event_t event )
+{
+    assert( sched != NULL );
+    assert( ao != NULL );
+    assert( sched->object[ao->priority] == ao );
+
+    if( ao->lanes != NULL )
+    {
+        return Scheduler_PostLane( sched, ao, 0U, event );
+    }
+
+    SCHEDULER_CRITICAL_ENTER();
+    const bool success = FIFO_Post( ao->fifo, ao->queue, &event, sizeof( event ) );
+    Posted( sched, ao, ao->fifo, success );
+    SCHEDULER_CRITICAL_EXIT();
+
+    return success;
+}
+
+extern bool Scheduler_PostLane( scheduler_t * const sched, active_object_t * const ao, uint32_t lane, event_t event )
+{
+    assert( sched != NULL );
+    assert( ao != NULL );
+    assert( ao->lanes != NULL );
+    assert( sched->object[ao->priority] == ao );
+
+    SCHEDULER_CRITICAL_ENTER();
+    const bool success = FIFO_PRIORITY_Post( ao->lanes, lane, event );
+    Posted( sched, ao, ao->lanes->lane[lane].fifo, success );
+    SCHEDULER_CRITICAL_EXIT();
+
+    return success;
+}
+
+extern bool Scheduler_RunOnce( scheduler_t * const sched )
+{
+    assert( sched != NULL );
+
+    SCHEDULER_CRITICAL_ENTER();
+    const uint32_t ready = sched->ready;
+    SCHEDULER_CRITICAL_EXIT();
+
+    bool ran = false;
+    if( ready == 0U )
+    {
+        if( sched->idle != NULL )
+        {
+            sched->idle( sched->idle_arg );
+        }
+    }
+    else
+    {
+        const uint32_t priority = 31U - (uint32_t)__builtin_clz( ready );
+        active_object_t * const ao = sched->object[priority];
+        assert( ao != NULL );
+
+        /* Run to completion step of a single event, priorities are
+         * re-evaluated before the next one */
+        SCHEDULER_CRITICAL_ENTER();
+        event_t event;
+        const bool taken = ( ao->lanes != NULL ) ?
+            FIFO_PRIORITY_Take( ao->lanes, &event ) :
+            FIFO_Take( ao->fifo, ao->queue, &event, sizeof( event ) );
+
+        /* Nothing taken means the ready bit was stale, e.g. the queue was
+         * flushed, so it is cleared and nothing dispatched */
+        if( !taken || !HasEvents( ao ) )
+        {
+            sched->ready &= ~( 1U << priority );
+        }
+        SCHEDULER_CRITICAL_EXIT();
+
+        if( taken )
+        {
+            STATEMACHINE_Dispatch( ao->state, event );
+            ao->dispatched++;
+            ran = true;
+        }
+    }
+
+    return ran;
+}
+
+extern void Scheduler_Run( scheduler_t * const sched )
+{
+    assert( sched != NULL );
+
+    while( true )
+    {
+        (void)Scheduler_RunOnce( sched );
+    }
+}
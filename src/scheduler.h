@@ -0,0 +1,76 @@
+#ifndef SCHEDULER_H_
+#define SCHEDULER_H_
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "state.h"
+#include "fifo_base.h"
+#include "fifo_priority.h"
+
+/* One active object per priority, higher numbers run first */
+#define SCHEDULER_PRIORITIES (32U)
+
+/* Posting from an interrupt requires the ready set and queue to be
+ * protected, override these for the target */
+#ifndef SCHEDULER_CRITICAL_ENTER
+#define SCHEDULER_CRITICAL_ENTER()
+#endif /* SCHEDULER_CRITICAL_ENTER */
+
+#ifndef SCHEDULER_CRITICAL_EXIT
+#define SCHEDULER_CRITICAL_EXIT()
+#endif /* SCHEDULER_CRITICAL_EXIT */
+
+#define ActiveObject_Init( ao, s, f ) \
+    ActiveObject_InitQueue( (ao), (s), &(f)->base, (f)->queue )
+
+/* An active object either owns a single FIFO, or a set of priority lanes
+ * (ActiveObject_InitLanes), in which case fifo and queue are NULL. Posts
+ * follow the FIFO's overflow policy, anything turned away counts as
+ * dropped. high_water is the deepest the FIFO, or any one lane, has been */
+typedef struct
+{
+    state_t * state;
+    fifo_base_t * fifo;
+    event_t * queue;
+    fifo_priority_t * lanes;
+    uint32_t priority;
+    uint32_t posted;
+    uint32_t dispatched;
+    uint32_t dropped;
+    uint32_t high_water;
+}
+active_object_t;
+
+typedef void ( *scheduler_idle_t ) ( void * arg );
+
+typedef struct
+{
+    active_object_t * object[SCHEDULER_PRIORITIES];
+    uint32_t ready;
+    scheduler_idle_t idle;
+    void * idle_arg;
+}
+scheduler_t;
+
+extern void ActiveObject_InitQueue( active_object_t * const ao, 
+        state_t * const state, 
+        fifo_base_t * const fifo,
+        event_t * const queue );
+
+extern void ActiveObject_InitLanes( active_object_t * const ao,
+        state_t * const state,
+        fifo_priority_t * const lanes );
+
+extern void Scheduler_Init( scheduler_t * const sched );
+extern void Scheduler_SetIdle( scheduler_t * const sched, scheduler_idle_t idle, void * arg );
+extern void Scheduler_Register( scheduler_t * const sched, active_object_t * const ao, uint32_t priority );
+extern bool Scheduler_Post( scheduler_t * const sched, active_object_t * const ao, event_t event );
+
+/* Objects with lanes take Scheduler_Post on lane 0 */
+extern bool Scheduler_PostLane( scheduler_t * const sched, active_object_t * const ao, uint32_t lane, event_t event );
+extern bool Scheduler_RunOnce( scheduler_t * const sched );
+extern void Scheduler_Run( scheduler_t * const sched );
+
+#endif /* SCHEDULER_H_ */
@@ -8,6 +8,7 @@
 
 #include "assert_bp.h"
 #include "state.h"
+#include "state_trace.h"
 #include <stddef.h>
 
 _Static_assert( MAX_NESTED_STATES > 0U, "Max number of nested states must be greater than 0" );
@@ -15,6 +16,12 @@ _Static_assert( MAX_NESTED_STATES > 0U, "Max number of nested states must be gre
 #define STATES_BUFFER_LEN (MAX_NESTED_STATES + 1U)
 
 _Static_assert( STATES_BUFFER_LEN > 0U, "Max number of nested states must be greater than 0" );
+_Static_assert( ( STATE_REGISTRY_LEN & ( STATE_REGISTRY_LEN - 1U ) ) == 0U, "State registry length must be a power of 2" );
+_Static_assert( STATE_CACHE_LEN > 0U, "Transition cache length must be greater than 0" );
+_Static_assert( ( STATE_CACHE_LEN & ( STATE_CACHE_LEN - 1U ) ) == 0U, "Transition cache length must be a power of 2" );
+
+/* Number of slots searched before giving up on a lookup or insertion */
+#define STATE_CACHE_PROBES ( 8U )
 
 #define EVENTS(EVNT)
 GENERATE_EVENTS(EVENTS);
@@ -40,31 +47,79 @@ typedef struct
 }
 transition_t;
 
+typedef struct
+{
+    state_func_t state;
+    state_hierarchy_t const * hierarchy;
+    uint32_t id;
+    /* Decided at init, so flat transitions never touch the table */
+    bool top_level;
+}
+registry_entry_t;
+
 /*Handling a HSM transition requires an FSM */
 static state_ret_t State_TransitionStart( state_t * this, event_t s );
 static state_ret_t State_TransitionExiting( state_t * this, event_t s );
 static state_ret_t State_TransitionEntering( state_t * this, event_t s );
 
 static inline uint32_t TraverseToRoot( state_t * const source, state_func_t path[ STATES_BUFFER_LEN ] );
+static inline uint32_t TraverseHierarchy( state_hierarchy_t const * const hierarchy,
+        uint32_t node,
+        state_func_t path[ STATES_BUFFER_LEN ] );
 
 static lca_t DetermineLCA( uint32_t in_depth, 
         state_func_t in_path[ STATES_BUFFER_LEN ], 
         uint32_t out_depth,
         state_func_t out_path[ STATES_BUFFER_LEN ] );
 
-/* These macros are for recording history of state executions, transitions etc for unit testing */
+static inline void DispatchEvent( state_t * const state, event_t s );
+static inline bool IsTopLevel( state_func_t const handler );
+static void FlatTransition( state_t * const state, state_func_t const source, state_func_t const target );
+static void HierarchicalTransition( state_t * const state, state_func_t const source, state_func_t const target );
+
+/* Per thread, so concurrent workers never share entries or counters */
+static _Thread_local state_cache_t * thread_cache = NULL;
+
+/* Handler to node lookup for every declared hierarchy, only written by
+ * STATEMACHINE_HierarchyInit during start up and read without locking */
+static registry_entry_t registry[ STATE_REGISTRY_LEN ];
+static uint32_t registry_fill = 0U;
+
+static inline registry_entry_t const * RegistryLookup( state_func_t const state );
+static void RegistryInsert( state_func_t const state, state_hierarchy_t const * const hierarchy, uint32_t id, bool top_level );
+
+static bool CacheLookup( state_cache_t * const cache, transition_t * const transition );
+static void CacheInsert( state_cache_t * const cache, transition_t const * const transition );
+
+/* Unit test history and the trace hook both sit on STATE_EXECUTE, with
+ * neither enabled it is a plain call through the handler */
 #ifdef UNIT_TESTS
-    static history_fifo_t state_history;
-    static state_history_data_t hist;
+    /* History is per thread, and only recorded on threads that have called
+     * STATE_UnitTestInit, until it fills up */
+    static _Thread_local history_fifo_t state_history;
     extern void STATE_UnitTestInit( void );
-    #define STATE_EXECUTE( current_state, current_event ) \
-        ( (hist.state=(current_state)->state, hist.event=(current_event),\
-          FIFO_Enqueue(&state_history, hist) ),\
-          (current_state)->state( (current_state), (current_event))) 
+    #define STATE_HISTORY_RECORD( current_state, current_event ) \
+        ( ( state_history.base.vfunc != NULL ) && !history_fifo_IsFull( &state_history ) ) ? \
+          history_fifo_PushUnchecked( &state_history, \
+            (state_history_data_t){ .state = (current_state)->state, .event = (current_event) } ) : (void)0
 #else
-    #define STATE_EXECUTE( current_state, current_event ) (current_state)->state( (current_state), (current_event) )
+    #define STATE_HISTORY_RECORD( current_state, current_event ) ( (void)0 )
 #endif
 
+static inline state_ret_t Execute( state_t * const state, event_t s )
+{
+    state_func_t const handler = state->state;
+
+    STATE_HISTORY_RECORD( state, s );
+    state_ret_t ret = handler( state, s );
+    STATE_TRACE_RECORD( state, handler, s, ret );
+    (void)handler;
+
+    return ret;
+}
+
+#define STATE_EXECUTE( current_state, current_event ) Execute( (current_state), (current_event) )
+
 extern void STATEMACHINE_Init( state_t * state,  state_ret_t (*initial_state) ( state_t * this, event_t s ) )
 {
     ASSERT( state != NULL );
@@ -111,11 +166,279 @@ static void Dispatch( state_t * state, event_t s )
     }
 }
 
+extern bool STATEMACHINE_HierarchyInit( state_hierarchy_t * const hierarchy )
+{
+    ASSERT( hierarchy != NULL );
+    ASSERT( hierarchy->node != NULL );
+    ASSERT( hierarchy->num_states > 0U );
+
+    const uint32_t root = hierarchy->num_states;
+    bool valid = ( hierarchy->node[ root ].state == NULL );
+    bool flat = true;
+    uint32_t unregistered = 0U;
+
+    hierarchy->valid = false;
+
+    /* Checked rather than asserted, a bad table would otherwise index past
+     * its end or chase a cycle forever once asserts are compiled out */
+    for( uint32_t idx = 0U; ( idx < root ) && valid; idx++ )
+    {
+        state_node_t * const node = &hierarchy->node[ idx ];
+        valid = ( node->state != NULL ) && ( node->parent <= root );
+
+        /* Depth of a top level state is 1, the root is 0. A cycle never
+         * reaches the root so shows up as nesting too deep */
+        uint32_t depth = 1U;
+        for( uint32_t parent = node->parent; valid && ( parent != root ); parent = hierarchy->node[ parent ].parent )
+        {
+            depth++;
+            valid = ( depth <= MAX_NESTED_STATES ) && ( hierarchy->node[ parent ].parent <= root );
+        }
+
+        if( valid )
+        {
+            node->depth = depth;
+            flat = flat && ( depth == 1U );
+
+            /* Declared parent must match what the handler returns */
+            state_t probe = { .state = node->state };
+            state_ret_t ret = node->state( &probe, EVENT( None ) );
+            valid = ( ret == RETURN( Unhandled ) ) && ( probe.state == hierarchy->node[ node->parent ].state );
+
+            /* Registered by another table would leave it ambiguous which
+             * one a machine in that state walks */
+            registry_entry_t const * const entry = RegistryLookup( node->state );
+            if( entry == NULL )
+            {
+                unregistered++;
+            }
+            else
+            {
+                valid = ( entry->hierarchy == hierarchy );
+            }
+        }
+    }
+
+    /* One slot is always left empty to end unsuccessful lookups */
+    valid = valid && ( ( registry_fill + unregistered ) < STATE_REGISTRY_LEN );
+
+    if( valid )
+    {
+        for( uint32_t idx = 0U; idx < root; idx++ )
+        {
+            state_node_t const * const node = &hierarchy->node[ idx ];
+            RegistryInsert( node->state, hierarchy, idx, flat || ( node->depth == 1U ) );
+        }
+        hierarchy->flat = flat;
+        hierarchy->valid = true;
+    }
+
+    return valid;
+}
+
+extern state_hierarchy_t const * STATEMACHINE_GetHierarchy( state_func_t const state )
+{
+    registry_entry_t const * const entry = RegistryLookup( state );
+    return ( entry != NULL ) ? entry->hierarchy : NULL;
+}
+
+static inline uint32_t RegistryHash( state_func_t const state )
+{
+    const uint64_t key = (uint64_t)(uintptr_t)state * 0x9E3779B97F4A7C15ULL;
+    return (uint32_t)( key >> 32U ) & ( STATE_REGISTRY_LEN - 1U );
+}
+
+static inline registry_entry_t const * RegistryLookup( state_func_t const state )
+{
+    registry_entry_t const * found = NULL;
+
+    if( ( state != NULL ) && ( registry_fill > 0U ) )
+    {
+        /* Never full, so the probe always meets the handler or a gap */
+        uint32_t slot = RegistryHash( state );
+        while( registry[ slot ].state != NULL )
+        {
+            if( registry[ slot ].state == state )
+            {
+                found = &registry[ slot ];
+                break;
+            }
+            slot = ( slot + 1U ) & ( STATE_REGISTRY_LEN - 1U );
+        }
+    }
+
+    return found;
+}
+
+static void RegistryInsert( state_func_t const state, state_hierarchy_t const * const hierarchy, uint32_t id, bool top_level )
+{
+    ASSERT( state != NULL );
+
+    uint32_t slot = RegistryHash( state );
+    while( ( registry[ slot ].state != NULL ) && ( registry[ slot ].state != state ) )
+    {
+        slot = ( slot + 1U ) & ( STATE_REGISTRY_LEN - 1U );
+    }
+
+    if( registry[ slot ].state == NULL )
+    {
+        registry_fill++;
+        ASSERT( registry_fill < STATE_REGISTRY_LEN );
+    }
+    registry[ slot ].state = state;
+    registry[ slot ].hierarchy = hierarchy;
+    registry[ slot ].id = id;
+    registry[ slot ].top_level = top_level;
+}
+
+extern void STATEMACHINE_CacheInit( state_cache_t * const cache )
+{
+    ASSERT( cache != NULL );
+
+    for( uint32_t idx = 0U; idx < STATE_CACHE_LEN; idx++ )
+    {
+        cache->entry[ idx ].source = NULL;
+        cache->entry[ idx ].target = NULL;
+    }
+    cache->fill = 0U;
+    cache->hits = 0U;
+    cache->misses = 0U;
+    cache->rejected = 0U;
+}
+
+extern void STATEMACHINE_SetCache( state_cache_t * const cache )
+{
+    thread_cache = cache;
+}
+
+extern state_cache_t * STATEMACHINE_GetCache( void )
+{
+    return thread_cache;
+}
+
+static inline uint32_t CacheHash( state_func_t const source, state_func_t const target )
+{
+    uint64_t key = ( (uint64_t)(uintptr_t)source * 31U ) ^ (uint64_t)(uintptr_t)target;
+    key *= 0x9E3779B97F4A7C15ULL;
+    return (uint32_t)( key >> 32U ) & ( STATE_CACHE_LEN - 1U );
+}
+
+static bool CacheLookup( state_cache_t * const cache, transition_t * const transition )
+{
+    ASSERT( cache != NULL );
+    ASSERT( transition != NULL );
+
+    uint32_t slot = CacheHash( transition->source, transition->target );
+    bool found = false;
+
+    for( uint32_t probe = 0U; probe < STATE_CACHE_PROBES; probe++ )
+    {
+        state_cache_entry_t const * const entry = &cache->entry[ slot ];
+        if( entry->target == NULL )
+        {
+            /* Empty slot terminates the probe sequence */
+            break;
+        }
+        else if( ( entry->source == transition->source ) && ( entry->target == transition->target ) )
+        {
+            for( uint32_t idx = 0U; idx < STATES_BUFFER_LEN; idx++ )
+            {
+                transition->path_in[ idx ] = entry->path_in[ idx ];
+                transition->path_out[ idx ] = entry->path_out[ idx ];
+            }
+            transition->in_depth = entry->in_depth;
+            transition->out_depth = entry->out_depth;
+            transition->lca.in = entry->lca_in;
+            transition->lca.out = entry->lca_out;
+            found = true;
+            break;
+        }
+        slot = ( slot + 1U ) & ( STATE_CACHE_LEN - 1U );
+    }
+
+    if( found )
+    {
+        cache->hits++;
+    }
+    else
+    {
+        cache->misses++;
+    }
+
+    return found;
+}
+
+static void CacheInsert( state_cache_t * const cache, transition_t const * const transition )
+{
+    ASSERT( cache != NULL );
+    ASSERT( transition != NULL );
+    ASSERT( transition->target != NULL );
+
+    uint32_t slot = CacheHash( transition->source, transition->target );
+    bool inserted = false;
+
+    for( uint32_t probe = 0U; probe < STATE_CACHE_PROBES; probe++ )
+    {
+        state_cache_entry_t * const entry = &cache->entry[ slot ];
+        if( entry->target == NULL )
+        {
+            for( uint32_t idx = 0U; idx < STATES_BUFFER_LEN; idx++ )
+            {
+                entry->path_in[ idx ] = transition->path_in[ idx ];
+                entry->path_out[ idx ] = transition->path_out[ idx ];
+            }
+            entry->in_depth = transition->in_depth;
+            entry->out_depth = transition->out_depth;
+            entry->lca_in = transition->lca.in;
+            entry->lca_out = transition->lca.out;
+            entry->source = transition->source;
+            entry->target = transition->target;
+            cache->fill++;
+            inserted = true;
+            break;
+        }
+        slot = ( slot + 1U ) & ( STATE_CACHE_LEN - 1U );
+    }
+
+    if( !inserted )
+    {
+        /* Probe sequence exhausted, the cache needs to be larger */
+        cache->rejected++;
+    }
+}
+
+static inline uint32_t TraverseHierarchy( state_hierarchy_t const * const hierarchy,
+        uint32_t node,
+        state_func_t path[ STATES_BUFFER_LEN ] )
+{
+    ASSERT( hierarchy != NULL );
+    ASSERT( path != NULL );
+    ASSERT( node < hierarchy->num_states );
+
+    const uint32_t depth = hierarchy->node[ node ].depth;
+    ASSERT( depth < STATES_BUFFER_LEN );
+
+    for( uint32_t idx = 0U; idx < depth; idx++ )
+    {
+        path[ idx ] = hierarchy->node[ node ].state;
+        node = hierarchy->node[ node ].parent;
+    }
+    path[ depth ] = NULL;
+
+    return depth;
+}
+
 static inline uint32_t TraverseToRoot( state_t * const source, state_func_t path[ STATES_BUFFER_LEN ] )
 {
     ASSERT( source != NULL );
     ASSERT( path != NULL );
 
+    registry_entry_t const * const entry = RegistryLookup( source->state );
+    if( entry != NULL )
+    {
+        return TraverseHierarchy( entry->hierarchy, entry->id, path );
+    }
+
     state_ret_t ret;
     uint32_t path_length = 0U;
     
@@ -211,18 +534,27 @@ static state_ret_t State_TransitionStart( state_t * this, event_t s )
     {
         case EVENT( Enter ):
         {
-            for( uint32_t idx = 0; idx < STATES_BUFFER_LEN; idx++ )
+            state_cache_t * const cache = thread_cache;
+            if( ( cache == NULL ) || !CacheLookup( cache, transition ) )
             {
-                transition->path_in[idx] = NULL;
-                transition->path_out[idx] = NULL;
+                for( uint32_t idx = 0; idx < STATES_BUFFER_LEN; idx++ )
+                {
+                    transition->path_in[idx] = NULL;
+                    transition->path_out[idx] = NULL;
+                }
+                /* Determine paths to root */
+                transition->state.state = *transition->target;
+                transition->in_depth = TraverseToRoot( &transition->state, transition->path_in );
+                transition->state.state = *transition->source;
+                transition->out_depth = TraverseToRoot( &transition->state, transition->path_out );
+                /* Find common ancestor */
+                transition->lca = DetermineLCA( transition->in_depth, transition->path_in, transition->out_depth, transition->path_out );
+
+                if( cache != NULL )
+                {
+                    CacheInsert( cache, transition );
+                }
             }
-            /* Determine paths to root */
-            transition->state.state = *transition->target;
-            transition->in_depth = TraverseToRoot( &transition->state, transition->path_in );
-            transition->state.state = *transition->source;
-            transition->out_depth = TraverseToRoot( &transition->state, transition->path_out );
-            /* Find common ancestor */
-            transition->lca = DetermineLCA( transition->in_depth, transition->path_in, transition->out_depth, transition->path_out );
             /* Begin exiting */
             ret = TRANSITION( this, STATE(TransitionExiting) );
         }
@@ -335,6 +667,72 @@ extern void STATEMACHINE_Dispatch( state_t * state, event_t s )
     ASSERT( state != NULL );
     ASSERT( s != (event_t)EVENT( None ) );
 
+    DispatchEvent( state, s );
+}
+
+extern uint32_t STATEMACHINE_DispatchSpan( state_t * const state, 
+        event_t const * const events,
+        uint32_t num_events,
+        state_batch_stop_t stop,
+        void * const arg )
+{
+    ASSERT( state != NULL );
+    ASSERT( state->state != NULL );
+    ASSERT( ( events != NULL ) || ( num_events == 0U ) );
+
+    uint32_t consumed = 0U;
+    while( consumed < num_events )
+    {
+        const event_t s = events[ consumed ];
+        ASSERT( s != (event_t)EVENT( None ) );
+        
+        DispatchEvent( state, s );
+        consumed++;
+
+        if( ( stop != NULL ) && stop( state, s, arg ) )
+        {
+            break;
+        }
+    }
+
+    return consumed;
+}
+
+extern uint32_t STATEMACHINE_DispatchQueue( state_t * const state, 
+        fifo_base_t * const fifo,
+        event_t const * const queue,
+        uint32_t max,
+        state_batch_stop_t stop,
+        void * const arg )
+{
+    ASSERT( state != NULL );
+    ASSERT( state->state != NULL );
+    ASSERT( fifo != NULL );
+    ASSERT( queue != NULL );
+
+    /* Events are read straight out of the ring rather than through the
+     * vfunc, the slot is released before dispatching so that handlers
+     * can post back into the same queue */
+    uint32_t consumed = 0U;
+    event_t s;
+    while( ( consumed < max ) && FIFO_Take( fifo, queue, &s, sizeof( s ) ) )
+    {
+        ASSERT( s != (event_t)EVENT( None ) );
+
+        DispatchEvent( state, s );
+        consumed++;
+
+        if( ( stop != NULL ) && stop( state, s, arg ) )
+        {
+            break;
+        }
+    }
+
+    return consumed;
+}
+
+static inline void DispatchEvent( state_t * const state, event_t s )
+{
     /* Always guaranteed to execute the first state */
     state_func_t source = state->state;
 
@@ -349,30 +747,15 @@ extern void STATEMACHINE_Dispatch( state_t * state, event_t s )
     {
         /* Store the target state */
         state_func_t target = state->state; 
-    
-        /* These hold the history up and down the state tree */
-        state_func_t path_out[ STATES_BUFFER_LEN ];
-        state_func_t path_in[ STATES_BUFFER_LEN ];
 
-        /* FSM within HSM to handle transitions */
-        transition_t transition =
+        if( IsTopLevel( source ) && IsTopLevel( target ) )
         {
-            .path_out = path_out,
-            .path_in = path_in,
-            .in_depth = 0U,
-            .out_depth = 0U,
-            .source = source,
-            .target = target,
-            .storage = state,
-        };
-    
-        /* Dogfooding to handle transition */
-        transition.state.state = STATE( TransitionStart );
-        Dispatch( &(transition.state), EVENT( Enter ) );
-
-        /* Reassign original state */    
-        state->state = transition.target;
-    
+            FlatTransition( state, source, target );
+        }
+        else
+        {
+            HierarchicalTransition( state, source, target );
+        }
     }
     else
     {
@@ -382,6 +765,85 @@ extern void STATEMACHINE_Dispatch( state_t * state, event_t s )
 
 }
 
+static inline bool IsTopLevel( state_func_t const handler )
+{
+    bool top_level;
+    registry_entry_t const * const entry = RegistryLookup( handler );
+
+    if( entry != NULL )
+    {
+        top_level = entry->top_level;
+    }
+    else
+    {
+        /* Same probe as TraverseToRoot, stopping after the first step */
+        state_t probe = { .state = handler };
+        state_ret_t ret = handler( &probe, EVENT( None ) );
+        ASSERT( ret == RETURN( Unhandled ) );
+        (void)ret;
+        top_level = ( probe.state == NULL );
+    }
+
+    return top_level;
+}
+
+/* Neither state has a parent, so the transition is an Exit and an Enter
+ * without building any paths */
+static void FlatTransition( state_t * const state, state_func_t const source, state_func_t const target )
+{
+    state->state = source;
+    state_ret_t ret = STATE_EXECUTE( state, EVENT( Exit ) );
+    ASSERT( ret != RETURN( Unhandled ) );
+
+    if( ret == RETURN( Transition ) )
+    {
+        /* Redirected on exit, the source has already been left */
+        HierarchicalTransition( state, NULL, state->state );
+    }
+    else
+    {
+        state->state = target;
+        ret = STATE_EXECUTE( state, EVENT( Enter ) );
+        ASSERT( ret != RETURN( Unhandled ) );
+
+        if( ret == RETURN( Transition ) )
+        {
+            /* Redirected on entry, so the target is now the source */
+            HierarchicalTransition( state, target, state->state );
+        }
+        else
+        {
+            state->state = target;
+        }
+    }
+}
+
+static void HierarchicalTransition( state_t * const state, state_func_t const source, state_func_t const target )
+{
+    /* These hold the history up and down the state tree */
+    state_func_t path_out[ STATES_BUFFER_LEN ];
+    state_func_t path_in[ STATES_BUFFER_LEN ];
+
+    /* FSM within HSM to handle transitions */
+    transition_t transition =
+    {
+        .path_out = path_out,
+        .path_in = path_in,
+        .in_depth = 0U,
+        .out_depth = 0U,
+        .source = source,
+        .target = target,
+        .storage = state,
+    };
+
+    /* Dogfooding to handle transition */
+    transition.state.state = STATE( TransitionStart );
+    Dispatch( &(transition.state), EVENT( Enter ) );
+
+    /* Reassign original state */    
+    state->state = transition.target;
+}
+
 #ifdef UNIT_TESTS
 extern void STATE_UnitTestInit( void )
 {
@@ -11,6 +11,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "fifo_base.h"
 
 /* Core State Machine Defines and helper macros */
 #define DEFAULT_EVENTS(EVNT) \
@@ -28,6 +29,16 @@
 #define MAX_NESTED_STATES ( 3U )
 #endif /* MAX_NESTED_STATES */
 
+/* Handlers that can be declared across all hierarchies, a power of 2 */
+#ifndef STATE_REGISTRY_LEN
+#define STATE_REGISTRY_LEN ( 64U )
+#endif /* STATE_REGISTRY_LEN */
+
+/* Transition cache slots, a power of 2 */
+#ifndef STATE_CACHE_LEN
+#define STATE_CACHE_LEN ( 32U )
+#endif /* STATE_CACHE_LEN */
+
 #define EVENT_ENUM(x) event_##x,
 #define EVENT_ENUM_(x) event_##x
 
@@ -62,6 +73,52 @@
         printf("%s -> %s Event\n", __func__, event_str[x] ); \
     }
 
+/* Optional static declaration of the state hierarchy, listing each state
+ * alongside its parent. Top level states have the parent Root, e.g.
+ *
+ * #define HIERARCHY(HSM) \
+ *     HSM( A, Root ) \
+ *     HSM( A0, A ) \
+ *
+ * GENERATE_STATE_IDS( HIERARCHY );
+ * GENERATE_HIERARCHY( hierarchy, HIERARCHY );
+ */
+#define STATE_ID(x) state_id_##x
+#define STATE_ID_ENUM_(x, p) STATE_ID(x),
+#define STATE_NODE_(x, p) [STATE_ID(x)] = { .state = STATE(x), .parent = STATE_ID(p), .depth = 0U },
+
+#define GENERATE_STATE_IDS( HSM ) \
+    enum StateId \
+    { \
+        HSM( STATE_ID_ENUM_ ) \
+        STATE_ID( Root ) \
+    }
+
+#define GENERATE_HIERARCHY( NAME, HSM ) \
+    static state_node_t NAME##_nodes[] = \
+    { \
+        HSM( STATE_NODE_ ) \
+        [STATE_ID( Root )] = { .state = NULL, .parent = STATE_ID( Root ), .depth = 0U }, \
+    }; \
+    static state_hierarchy_t NAME = \
+    { \
+        .node = NAME##_nodes, \
+        .num_states = (uint32_t)STATE_ID( Root ), \
+        .flat = false, \
+        .valid = false, \
+    }
+
+/* Drains up to max events from an event FIFO into a single machine.
+ *
+ * Events are taken straight out of the FIFO's ring, not through its vfunc,
+ * so f must be a FIFO of event_t with its queue next to base and a power
+ * of two length. The calling thread must own the FIFO: nothing else may
+ * post or take concurrently, and a FIFO attached to a fifo_wait_t has to
+ * be drained with FIFO_WAIT_TakeN and STATEMACHINE_DispatchSpan instead,
+ * or its lock and producer wake ups are skipped */
+#define STATEMACHINE_DispatchBatch( s, f, max, stop, arg ) \
+    STATEMACHINE_DispatchQueue( (s), &(f)->base, (f)->queue, (max), (stop), (arg) )
+
 #define PARENT( X, parent_state ) ((X)->state = parent_state, RETURN( Unhandled ) )
 #define TRANSITION( X, new_state ) ((X)->state = new_state, RETURN( Transition ))
 #define HANDLED(X) RETURN ( Handled )
@@ -83,6 +140,58 @@ typedef struct state_t state_t;
 /* Function pointer that holds the state to execute */
 typedef state_ret_t ( *state_func_t ) ( state_t * this, event_t s );
 
+typedef struct
+{
+    state_func_t state;
+    uint32_t parent;
+    uint32_t depth;
+}
+state_node_t;
+
+/* Dense parent/depth table, the final node is the root. Once checked by
+ * STATEMACHINE_HierarchyInit each handler is registered against its node
+ * for the whole process, so any machine in one of those states walks the
+ * table instead of probing its handlers, however it was initialised. A
+ * handler belongs to at most one table */
+typedef struct
+{
+    state_node_t * node;
+    uint32_t num_states;
+    /* Every state is top level, set by STATEMACHINE_HierarchyInit */
+    bool flat;
+    bool valid;
+}
+state_hierarchy_t;
+
+/* Precomputed exit/entry paths for a (source, target) pair */
+typedef struct
+{
+    state_func_t source;
+    state_func_t target;
+    state_func_t path_in[ MAX_NESTED_STATES + 1U ];
+    state_func_t path_out[ MAX_NESTED_STATES + 1U ];
+    uint32_t in_depth;
+    uint32_t out_depth;
+    uint32_t lca_in;
+    uint32_t lca_out;
+}
+state_cache_entry_t;
+
+/* Open-addressed transition cache keyed on the (source, target) handlers.
+ * A cache belongs to the thread that installed it with
+ * STATEMACHINE_SetCache and is never touched by any other, so machines
+ * of any type dispatched on that thread share it without locking. Each
+ * worker thread installs its own */
+typedef struct
+{
+    state_cache_entry_t entry[ STATE_CACHE_LEN ];
+    uint32_t fill;
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t rejected;
+}
+state_cache_t;
+
 struct state_t
 {
     state_func_t state;
@@ -95,11 +204,41 @@ typedef struct
 }
 state_event_t;
 
+/* Called after each event of a batch, returning true ends the batch early */
+typedef bool ( *state_batch_stop_t ) ( state_t const * const state, event_t s, void * arg );
+
 extern void STATEMACHINE_Init( state_t * state, state_ret_t (*initial_state) ( state_t * this, event_t s ) );
 extern void STATEMACHINE_Dispatch( state_t * state, event_t s );
+extern uint32_t STATEMACHINE_DispatchSpan( state_t * const state, 
+        event_t const * const events,
+        uint32_t num_events,
+        state_batch_stop_t stop,
+        void * const arg );
+extern uint32_t STATEMACHINE_DispatchQueue( state_t * const state, 
+        fifo_base_t * const fifo,
+        event_t const * const queue,
+        uint32_t max,
+        state_batch_stop_t stop,
+        void * const arg );
+
+/* False, with nothing registered, when a parent is out of range, the
+ * parents form a cycle or nest deeper than MAX_NESTED_STATES, a handler
+ * disagrees with its declared parent or is already in another table, or
+ * the registry is full. Initialising the same table again is harmless.
+ *
+ * The registry is read without locking, so every table must be
+ * initialised during start up, before any thread initialises or
+ * dispatches a machine */
+extern bool STATEMACHINE_HierarchyInit( state_hierarchy_t * const hierarchy );
+extern state_hierarchy_t const * STATEMACHINE_GetHierarchy( state_func_t const state );
+
+extern void STATEMACHINE_CacheInit( state_cache_t * const cache );
+/* Installs the cache used by transitions on the calling thread, NULL to
+ * stop caching */
+extern void STATEMACHINE_SetCache( state_cache_t * const cache );
+extern state_cache_t * STATEMACHINE_GetCache( void );
 
 #ifdef UNIT_TESTS
-#include "fifo_base.h"
 #include "state_history.h"
 extern fifo_base_t * STATE_GetHistory ( void );
 #endif
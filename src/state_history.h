@@ -2,7 +2,7 @@
 #define STATE_HISTORY_H
 
 #include "state.h"
-#include "fifo_base.h"
+#include "fifo_static.h"
 #define UNIT_TEST_HISTORY_SIZE ( 64U )
 
 typedef struct
@@ -12,14 +12,7 @@ typedef struct
 }
 state_history_data_t;
 
-typedef struct
-{
-    fifo_base_t base;
-    state_history_data_t queue[UNIT_TEST_HISTORY_SIZE];
-    state_history_data_t in;
-    state_history_data_t out;
-}
-history_fifo_t;
+GENERATE_FIFO( history_fifo, state_history_data_t, UNIT_TEST_HISTORY_SIZE );
 
 extern void History_Init( history_fifo_t * fifo );
 extern history_fifo_t * History_GetHistory ( void );
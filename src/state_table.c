@@ -0,0 +1,81 @@
+/*
+ *
+ * Table driven State Machine Engine
+ *
+ */
+
+#include "assert_bp.h"
+#include "state_table.h"
+#include <stddef.h>
+
+#define EVENTS(EVNT)
+GENERATE_EVENTS(EVENTS);
+
+/* Destination of an entry that does not transition */
+#define NO_TRANSITION ( 0U )
+
+static inline state_table_entry_t const * Lookup( state_table_t const * const machine, uint32_t state, event_t s )
+{
+    return &machine->table[ ( state * machine->num_events ) + s ];
+}
+
+static inline void Execute( state_table_t * const machine, state_table_entry_t const * const entry, event_t s )
+{
+    if( entry->action != NULL )
+    {
+        entry->action( machine, s );
+    }
+}
+
+/* Exit the current state and enter the next, entry actions can chain
+ * further transitions */
+static void Transition( state_table_t * const machine, uint32_t next )
+{
+    while( next != NO_TRANSITION )
+    {
+        state_table_entry_t const * const exit = Lookup( machine, machine->state, EVENT( Exit ) );
+        Execute( machine, exit, EVENT( Exit ) );
+        if( exit->next != NO_TRANSITION )
+        {
+            /* Transition upon exit replaces the target */
+            next = exit->next;
+        }
+
+        machine->state = next;
+
+        state_table_entry_t const * const enter = Lookup( machine, machine->state, EVENT( Enter ) );
+        Execute( machine, enter, EVENT( Enter ) );
+        next = enter->next;
+    }
+}
+
+extern void STATETABLE_InitTable( state_table_t * const machine, 
+        state_table_entry_t const * const table,
+        uint32_t num_events,
+        uint32_t initial_state )
+{
+    ASSERT( machine != NULL );
+    ASSERT( table != NULL );
+    ASSERT( num_events >= EVENT( EventCount ) );
+    ASSERT( initial_state != NO_TRANSITION );
+
+    machine->table = table;
+    machine->num_events = num_events;
+    machine->state = initial_state;
+
+    state_table_entry_t const * const enter = Lookup( machine, machine->state, EVENT( Enter ) );
+    Execute( machine, enter, EVENT( Enter ) );
+    Transition( machine, enter->next );
+}
+
+extern void STATETABLE_Dispatch( state_table_t * const machine, event_t s )
+{
+    ASSERT( machine != NULL );
+    ASSERT( machine->state != NO_TRANSITION );
+    ASSERT( s != (event_t)EVENT( None ) );
+    ASSERT( s < machine->num_events );
+
+    state_table_entry_t const * const entry = Lookup( machine, machine->state, s );
+    Execute( machine, entry, s );
+    Transition( machine, entry->next );
+}
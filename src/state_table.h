@@ -0,0 +1,77 @@
+/*
+ *
+ * Table driven FSM Engine
+ *
+ */
+
+#ifndef STATE_TABLE_H_
+#define STATE_TABLE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "state.h"
+
+/* Flat state machines can be described with a list of states and a
+ * transition table instead of a handler per state, e.g.
+ *
+ * #define STATES(ST) \
+ *     ST( Idle ) \
+ *     ST( Running ) \
+ *
+ * #define TRANSITIONS(TR) \
+ *     TR( Idle,    Enter, None,    OnIdle ) \
+ *     TR( Idle,    Start, Running, StartMotor ) \
+ *     TR( Running, Tick,  None,    Count ) \
+ *
+ * GENERATE_TABLE_STATES( STATES );
+ * GENERATE_STATE_TABLE( table, TRANSITIONS );
+ *
+ * A destination of None handles the event without a transition. Enter and
+ * Exit rows behave as they do in the Enter/Exit cases of a state handler.
+ */
+#define TABLE_STATE(x) table_state_##x
+#define TABLE_STATE_ENUM_(x) TABLE_STATE(x),
+#define TABLE_ENTRY_(src, ev, dst, act) [TABLE_STATE(src)][EVENT(ev)] = { .action = (act), .next = TABLE_STATE(dst) },
+
+#define GENERATE_TABLE_STATES( ST ) \
+    enum TableState \
+    { \
+        TABLE_STATE_ENUM_( None ) \
+        ST( TABLE_STATE_ENUM_ ) \
+        TABLE_STATE_ENUM_( StateCount ) \
+    }
+
+#define GENERATE_STATE_TABLE( NAME, TR ) \
+    static const state_table_entry_t NAME[ TABLE_STATE( StateCount ) ][ EVENT( EventCount ) ] = \
+    { \
+        TR( TABLE_ENTRY_ ) \
+    }
+
+#define STATETABLE_Init( m, table, initial ) \
+    STATETABLE_InitTable( (m), &(table)[0][0], EVENT( EventCount ), TABLE_STATE( initial ) )
+
+typedef struct state_table_t state_table_t;
+
+typedef void ( *table_action_t ) ( state_table_t * this, event_t s );
+
+typedef struct
+{
+    table_action_t action;
+    uint32_t next;
+}
+state_table_entry_t;
+
+struct state_table_t
+{
+    uint32_t state;
+    uint32_t num_events;
+    state_table_entry_t const * table;
+};
+
+extern void STATETABLE_InitTable( state_table_t * const machine, 
+        state_table_entry_t const * const table,
+        uint32_t num_events,
+        uint32_t initial_state );
+extern void STATETABLE_Dispatch( state_table_t * const machine, event_t s );
+
+#endif /* STATE_TABLE_H_ */
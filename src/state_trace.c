@@ -0,0 +1,63 @@
+/*
+ *
+ * State Machine Trace
+ *
+ */
+
+#include "assert_bp.h"
+#include "state_trace.h"
+#include <time.h>
+
+_Static_assert( STATE_TRACE_LEN > 0U, "Trace length must be greater than 0" );
+_Static_assert( ( STATE_TRACE_LEN & ( STATE_TRACE_LEN - 1U ) ) == 0U, "Trace length must be a power of 2" );
+
+#define TRACE_MASK ( STATE_TRACE_LEN - 1U )
+
+static _Thread_local state_trace_t thread_trace;
+
+extern void StateTrace_Record( state_t const * const machine, state_func_t handler, event_t event, state_ret_t ret )
+{
+    state_trace_record_t * const record = &thread_trace.record[ thread_trace.written & TRACE_MASK ];
+
+    record->timestamp = STATE_TRACE_TIMESTAMP();
+    record->machine = (uintptr_t)machine;
+    record->state = handler;
+    record->event = event;
+    record->ret = (uint8_t)ret;
+    thread_trace.written++;
+}
+
+extern state_trace_t * StateTrace_Get( void )
+{
+    return &thread_trace;
+}
+
+extern void StateTrace_Reset( state_trace_t * const trace )
+{
+    ASSERT( trace != NULL );
+    trace->written = 0U;
+}
+
+extern uint32_t StateTrace_Dump( state_trace_t const * const trace, state_trace_record_t * const out, uint32_t max )
+{
+    ASSERT( trace != NULL );
+    ASSERT( out != NULL );
+
+    uint32_t available = ( trace->written < STATE_TRACE_LEN ) ? trace->written : STATE_TRACE_LEN;
+    uint32_t count = ( available < max ) ? available : max;
+    uint32_t first = trace->written - available;
+
+    for( uint32_t idx = 0U; idx < count; idx++ )
+    {
+        out[ idx ] = trace->record[ ( first + idx ) & TRACE_MASK ];
+    }
+
+    return count;
+}
+
+extern uint64_t StateTrace_Now( void )
+{
+    struct timespec ts;
+    (void)clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ( (uint64_t)ts.tv_sec * 1000000000ULL ) + (uint64_t)ts.tv_nsec;
+}
@@ -0,0 +1,65 @@
+/*
+ *
+ * State Machine Trace
+ *
+ * Compile with STATE_TRACE defined to record every handler the engine
+ * executes into a per-thread ring, otherwise the hook compiles to nothing.
+ *
+ */
+
+#ifndef STATE_TRACE_H_
+#define STATE_TRACE_H_
+
+#include <stdint.h>
+#include "state.h"
+
+/* Records kept per thread, older records are overwritten. Must be a power of 2 */
+#ifndef STATE_TRACE_LEN
+#define STATE_TRACE_LEN ( 256U )
+#endif /* STATE_TRACE_LEN */
+
+/* Timestamp source, override with a cycle counter or tick on targets */
+#ifndef STATE_TRACE_TIMESTAMP
+#define STATE_TRACE_TIMESTAMP() StateTrace_Now()
+#endif /* STATE_TRACE_TIMESTAMP */
+
+#ifdef STATE_TRACE
+    #define STATE_TRACE_RECORD( machine, handler, event, ret ) \
+        StateTrace_Record( (machine), (handler), (event), (ret) )
+#else
+    #define STATE_TRACE_RECORD( machine, handler, event, ret ) ( (void)0 )
+#endif /* STATE_TRACE */
+
+typedef struct
+{
+    uint64_t timestamp;
+    /* Address of the state_t, so records from one machine can be grouped */
+    uintptr_t machine;
+    state_func_t state;
+    uint32_t event;
+    uint8_t ret;
+}
+state_trace_record_t;
+
+typedef struct
+{
+    state_trace_record_t record[ STATE_TRACE_LEN ];
+    /* Total records written, the ring holds the newest STATE_TRACE_LEN */
+    uint32_t written;
+}
+state_trace_t;
+
+extern void StateTrace_Record( state_t const * const machine, state_func_t handler, event_t event, state_ret_t ret );
+
+/* The calling thread's ring, a fault handler can keep hold of this and
+ * dump it later */
+extern state_trace_t * StateTrace_Get( void );
+extern void StateTrace_Reset( state_trace_t * const trace );
+
+/* Copies up to max records out oldest first, returning how many were copied */
+extern uint32_t StateTrace_Dump( state_trace_t const * const trace, state_trace_record_t * const out, uint32_t max );
+
+/* Monotonic nanoseconds, so wall clock adjustments cannot reorder records */
+extern uint64_t StateTrace_Now( void );
+
+#endif /* STATE_TRACE_H_ */
@@ -0,0 +1,424 @@
+#define _GNU_SOURCE
+#include "work_stealing.h"
+#include <sched.h>
+#include <time.h>
+
+_Static_assert( ( WS_MAX_OBJECTS & ( WS_MAX_OBJECTS - 1U ) ) == 0U, "Max objects must be a power of 2" );
+_Static_assert( ( WS_QUEUE_LEN & ( WS_QUEUE_LEN - 1U ) ) == 0U, "Queue length must be a power of 2" );
+_Static_assert( WS_QUEUE_LEN > 1U, "Queue length must be greater than 1" );
+_Static_assert( WS_QUANTUM > 0U, "Quantum must be greater than 0" );
+
+#define DEQUE_MASK ( WS_MAX_OBJECTS - 1U )
+
+/* Set on worker threads so that posts from handlers go to the local deque */
+static _Thread_local ws_worker_t * current_worker;
+
+static void * Worker( void * arg );
+
+static inline uint64_t Now( void )
+{
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ( (uint64_t)ts.tv_sec * 1000000000ULL ) + (uint64_t)ts.tv_nsec;
+}
+
+/* Owner end of the deque */
+static void DequePush( ws_deque_t * const deque, ws_object_t * const object )
+{
+    const int64_t b = atomic_load_explicit( &deque->bottom, memory_order_relaxed );
+    const int64_t t = atomic_load_explicit( &deque->top, memory_order_acquire );
+    /* A machine is only ever in one deque, so this cannot overflow */
+    assert( ( b - t ) < (int64_t)WS_MAX_OBJECTS );
+    (void)t;
+
+    atomic_store_explicit( &deque->buffer[ (uint64_t)b & DEQUE_MASK ], object, memory_order_relaxed );
+    atomic_thread_fence( memory_order_release );
+    atomic_store_explicit( &deque->bottom, b + 1, memory_order_relaxed );
+}
+
+static ws_object_t * DequeTake( ws_deque_t * const deque )
+{
+    const int64_t b = atomic_load_explicit( &deque->bottom, memory_order_relaxed ) - 1;
+    atomic_store_explicit( &deque->bottom, b, memory_order_relaxed );
+    atomic_thread_fence( memory_order_seq_cst );
+    int64_t t = atomic_load_explicit( &deque->top, memory_order_relaxed );
+
+    ws_object_t * object = NULL;
+    if( t <= b )
+    {
+        object = atomic_load_explicit( &deque->buffer[ (uint64_t)b & DEQUE_MASK ], memory_order_relaxed );
+        if( t == b )
+        {
+            /* Last entry, race against thieves for it */
+            if( !atomic_compare_exchange_strong_explicit( &deque->top, &t, t + 1,
+                        memory_order_seq_cst, memory_order_relaxed ) )
+            {
+                object = NULL;
+            }
+            atomic_store_explicit( &deque->bottom, b + 1, memory_order_relaxed );
+        }
+    }
+    else
+    {
+        atomic_store_explicit( &deque->bottom, b + 1, memory_order_relaxed );
+    }
+    return object;
+}
+
+/* Thief end of the deque */
+static ws_object_t * DequeSteal( ws_deque_t * const deque )
+{
+    int64_t t = atomic_load_explicit( &deque->top, memory_order_acquire );
+    atomic_thread_fence( memory_order_seq_cst );
+    const int64_t b = atomic_load_explicit( &deque->bottom, memory_order_acquire );
+
+    ws_object_t * object = NULL;
+    if( t < b )
+    {
+        object = atomic_load_explicit( &deque->buffer[ (uint64_t)t & DEQUE_MASK ], memory_order_relaxed );
+        if( !atomic_compare_exchange_strong_explicit( &deque->top, &t, t + 1,
+                    memory_order_seq_cst, memory_order_relaxed ) )
+        {
+            object = NULL;
+        }
+    }
+    return object;
+}
+
+static bool DequeIsEmpty( ws_deque_t * const deque )
+{
+    const int64_t t = atomic_load_explicit( &deque->top, memory_order_acquire );
+    const int64_t b = atomic_load_explicit( &deque->bottom, memory_order_acquire );
+    return ( t >= b );
+}
+
+static void InjectPush( work_stealing_t * const ws, ws_object_t * const object )
+{
+    /* A machine is only ever queued once, so this cannot fill up */
+    bool success = FIFO_MPMC_TryEnqueue( &ws->inject, &object );
+    assert( success );
+    (void)success;
+}
+
+static ws_object_t * InjectPop( work_stealing_t * const ws )
+{
+    ws_object_t * object = NULL;
+    (void)FIFO_MPMC_TryDequeue( &ws->inject, &object );
+    return object;
+}
+
+static bool HasWork( work_stealing_t * const ws )
+{
+    bool work = !FIFO_MPMC_IsEmpty( &ws->inject.base );
+    for( uint32_t idx = 0U; ( idx < ws->num_workers ) && !work; idx++ )
+    {
+        work = !DequeIsEmpty( &ws->worker[idx].deque );
+    }
+    return work;
+}
+
+/* Events still queued on any machine, including one that a worker is
+ * part way through */
+static bool HasEvents( work_stealing_t * const ws )
+{
+    bool events = false;
+    for( uint32_t idx = 0U; ( idx < ws->num_objects ) && !events; idx++ )
+    {
+        events = !FIFO_MPMC_IsEmpty( &ws->object[idx]->queue.base );
+    }
+    return events;
+}
+
+static void WakeOne( work_stealing_t * const ws )
+{
+    /* Pairs with the fence taken by a worker before it sleeps */
+    atomic_thread_fence( memory_order_seq_cst );
+    if( atomic_load_explicit( &ws->sleepers, memory_order_relaxed ) > 0U )
+    {
+        pthread_mutex_lock( &ws->lock );
+        pthread_cond_signal( &ws->wake );
+        pthread_mutex_unlock( &ws->lock );
+    }
+}
+
+/* Caller must hold the scheduled flag */
+static void Schedule( work_stealing_t * const ws, ws_object_t * const object )
+{
+    ws_worker_t * const worker = current_worker;
+    if( ( worker != NULL ) && ( worker->runtime == ws ) )
+    {
+        DequePush( &worker->deque, object );
+    }
+    else
+    {
+        InjectPush( ws, object );
+    }
+    WakeOne( ws );
+}
+
+extern void WorkStealing_Init( work_stealing_t * const ws, uint32_t num_workers )
+{
+    assert( ws != NULL );
+    assert( num_workers > 0U );
+    assert( num_workers <= WS_MAX_WORKERS );
+
+    for( uint32_t idx = 0U; idx < num_workers; idx++ )
+    {
+        ws_worker_t * const worker = &ws->worker[idx];
+        atomic_init( &worker->deque.top, 0 );
+        atomic_init( &worker->deque.bottom, 0 );
+        for( uint32_t jdx = 0U; jdx < WS_MAX_OBJECTS; jdx++ )
+        {
+            atomic_init( &worker->deque.buffer[jdx], NULL );
+        }
+        worker->runtime = ws;
+        worker->index = idx;
+        worker->seed = 0x9E3779B9U * ( idx + 1U );
+        worker->dispatched = 0U;
+        worker->runs = 0U;
+        worker->steals = 0U;
+        worker->steal_attempts = 0U;
+        worker->busy_ns = 0U;
+        worker->idle_ns = 0U;
+    }
+
+    FIFO_MPMC_Init( &ws->inject );
+
+    ws->num_workers = num_workers;
+    ws->num_objects = 0U;
+    atomic_init( &ws->sleepers, 0U );
+    pthread_mutex_init( &ws->lock, NULL );
+    pthread_cond_init( &ws->wake, NULL );
+    atomic_init( &ws->accepting, false );
+    atomic_init( &ws->stopping, false );
+    atomic_init( &ws->posting, 0U );
+    ws->started = false;
+}
+
+extern void WorkStealing_Register( work_stealing_t * const ws, ws_object_t * const object, state_t * const state )
+{
+    assert( ws != NULL );
+    assert( object != NULL );
+    assert( state != NULL );
+    assert( !ws->started );
+    assert( ws->num_objects < WS_MAX_OBJECTS );
+
+    object->state = state;
+    FIFO_MPMC_Init( &object->queue );
+    atomic_init( &object->scheduled, false );
+    object->dispatched = 0U;
+
+    ws->object[ws->num_objects++] = object;
+}
+
+extern void WorkStealing_Start( work_stealing_t * const ws )
+{
+    assert( ws != NULL );
+    assert( !ws->started );
+
+    atomic_store( &ws->stopping, false );
+    atomic_store( &ws->accepting, true );
+    ws->started = true;
+
+    for( uint32_t idx = 0U; idx < ws->num_workers; idx++ )
+    {
+        int ret = pthread_create( &ws->worker[idx].thread, NULL, Worker, &ws->worker[idx] );
+        assert( ret == 0 );
+        (void)ret;
+    }
+}
+
+extern bool WorkStealing_Post( work_stealing_t * const ws, ws_object_t * const object, event_t event )
+{
+    assert( ws != NULL );
+    assert( object != NULL );
+
+    bool success = false;
+
+    /* Handlers keep posting while the runtime drains on stop, their
+     * machines are already being tracked by a live worker */
+    ws_worker_t * const worker = current_worker;
+    const bool internal = ( worker != NULL ) && ( worker->runtime == ws );
+
+    atomic_fetch_add( &ws->posting, 1U );
+    if( internal || atomic_load( &ws->accepting ) )
+    {
+        success = FIFO_MPMC_TryEnqueue( &object->queue, &event );
+
+        /* Pairs with the fence in Run, so either this sees the machine
+         * given up or Run sees the event */
+        atomic_thread_fence( memory_order_seq_cst );
+
+        /* Only the post which finds the machine idle queues it */
+        bool expected = false;
+        if( success && !atomic_load_explicit( &object->scheduled, memory_order_relaxed ) &&
+                atomic_compare_exchange_strong( &object->scheduled, &expected, true ) )
+        {
+            Schedule( ws, object );
+        }
+    }
+    atomic_fetch_sub( &ws->posting, 1U );
+
+    return success;
+}
+
+extern void WorkStealing_Stop( work_stealing_t * const ws )
+{
+    assert( ws != NULL );
+    assert( ws->started );
+
+    atomic_store( &ws->accepting, false );
+    while( atomic_load( &ws->posting ) != 0U )
+    {
+        sched_yield();
+    }
+    atomic_store( &ws->stopping, true );
+
+    pthread_mutex_lock( &ws->lock );
+    pthread_cond_broadcast( &ws->wake );
+    pthread_mutex_unlock( &ws->lock );
+
+    for( uint32_t idx = 0U; idx < ws->num_workers; idx++ )
+    {
+        pthread_join( ws->worker[idx].thread, NULL );
+    }
+    ws->started = false;
+}
+
+extern void WorkStealing_GetStats( work_stealing_t const * const ws, uint32_t worker, ws_stats_t * const stats )
+{
+    assert( ws != NULL );
+    assert( stats != NULL );
+    assert( worker < ws->num_workers );
+
+    ws_worker_t const * const w = &ws->worker[worker];
+    const uint64_t total = w->busy_ns + w->idle_ns;
+
+    stats->dispatched = w->dispatched;
+    stats->steals = w->steals;
+    stats->steal_attempts = w->steal_attempts;
+    stats->utilization = ( total > 0U ) ? ( 100.0 * (double)w->busy_ns / (double)total ) : 0.0;
+}
+
+static void Run( ws_worker_t * const worker, ws_object_t * const object )
+{
+    work_stealing_t * const ws = worker->runtime;
+    uint32_t count = 0U;
+    event_t event;
+
+    while( ( count < WS_QUANTUM ) && FIFO_MPMC_TryDequeue( &object->queue, &event ) )
+    {
+        STATEMACHINE_Dispatch( object->state, event );
+        count++;
+    }
+    object->dispatched += count;
+    worker->dispatched += count;
+    worker->runs++;
+
+    /* Give up the machine, then take it back if events arrived in the
+     * meantime and no poster has queued it already */
+    atomic_store( &object->scheduled, false );
+    atomic_thread_fence( memory_order_seq_cst );
+    bool expected = false;
+    if( !FIFO_MPMC_IsEmpty( &object->queue.base ) && atomic_compare_exchange_strong( &object->scheduled, &expected, true ) )
+    {
+        if( count == WS_QUANTUM )
+        {
+            /* Preempted, so it waits its turn behind the local deque and
+             * everything already injected */
+            InjectPush( ws, object );
+            WakeOne( ws );
+        }
+        else
+        {
+            Schedule( ws, object );
+        }
+    }
+}
+
+static ws_object_t * Steal( ws_worker_t * const worker )
+{
+    work_stealing_t * const ws = worker->runtime;
+    ws_object_t * object = NULL;
+
+    if( ws->num_workers > 1U )
+    {
+        /* Start from a random victim so thieves spread out */
+        worker->seed ^= worker->seed << 13U;
+        worker->seed ^= worker->seed >> 17U;
+        worker->seed ^= worker->seed << 5U;
+        const uint32_t start = worker->seed % ws->num_workers;
+
+        for( uint32_t idx = 0U; ( idx < ws->num_workers ) && ( object == NULL ); idx++ )
+        {
+            const uint32_t victim = ( start + idx ) % ws->num_workers;
+            if( victim != worker->index )
+            {
+                worker->steal_attempts++;
+                object = DequeSteal( &ws->worker[victim].deque );
+            }
+        }
+
+        if( object != NULL )
+        {
+            worker->steals++;
+        }
+    }
+    return object;
+}
+
+static void * Worker( void * arg )
+{
+    ws_worker_t * const worker = (ws_worker_t *)arg;
+    work_stealing_t * const ws = worker->runtime;
+    current_worker = worker;
+
+    uint64_t mark = Now();
+    while( true )
+    {
+        ws_object_t * object = DequeTake( &worker->deque );
+        if( object == NULL )
+        {
+            object = InjectPop( ws );
+        }
+        if( object == NULL )
+        {
+            object = Steal( worker );
+        }
+
+        if( object != NULL )
+        {
+            const uint64_t start = Now();
+            worker->idle_ns += start - mark;
+            Run( worker, object );
+            mark = Now();
+            worker->busy_ns += mark - start;
+        }
+        else if( atomic_load( &ws->stopping ) )
+        {
+            /* Every accepted post has landed, and a machine being run by
+             * another worker is rescheduled by that worker, so only stop
+             * once none is left ready or holding events */
+            if( !HasWork( ws ) && !HasEvents( ws ) )
+            {
+                break;
+            }
+        }
+        else
+        {
+            pthread_mutex_lock( &ws->lock );
+            atomic_fetch_add( &ws->sleepers, 1U );
+            atomic_thread_fence( memory_order_seq_cst );
+            if( !HasWork( ws ) && !atomic_load( &ws->stopping ) )
+            {
+                pthread_cond_wait( &ws->wake, &ws->lock );
+            }
+            atomic_fetch_sub( &ws->sleepers, 1U );
+            pthread_mutex_unlock( &ws->lock );
+        }
+    }
+    worker->idle_ns += Now() - mark;
+    current_worker = NULL;
+
+    return NULL;
+}
@@ -0,0 +1,127 @@
+#ifndef WORK_STEALING_H_
+#define WORK_STEALING_H_
+
+#include <assert.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "state.h"
+#include "fifo_mpmc.h"
+
+#ifndef WS_MAX_WORKERS
+#define WS_MAX_WORKERS (16U)
+#endif /* WS_MAX_WORKERS */
+
+/* Upper bound on registered machines, each one is queued at most once so
+ * this also sizes the deques. Must be a power of 2 */
+#ifndef WS_MAX_OBJECTS
+#define WS_MAX_OBJECTS (1024U)
+#endif /* WS_MAX_OBJECTS */
+
+/* Event queue length of each machine, must be a power of 2 */
+#ifndef WS_QUEUE_LEN
+#define WS_QUEUE_LEN (64U)
+#endif /* WS_QUEUE_LEN */
+
+/* Events dispatched to a machine in one turn. A machine that uses up its
+ * quantum is requeued on the shared inject queue, behind every machine
+ * already waiting, rather than on its worker's deque where it would be
+ * taken straight back */
+#ifndef WS_QUANTUM
+#define WS_QUANTUM (32U)
+#endif /* WS_QUANTUM */
+
+#define WS_CACHE_LINE (64U)
+
+typedef struct
+{
+    fifo_mpmc_base_t base;
+    FIFO_MPMC_SLOT( event_t ) slot[WS_QUEUE_LEN];
+}
+ws_event_queue_t;
+
+/* A state machine and its event queue. The scheduled flag is held by
+ * whoever queued the machine as ready, so it is never dispatched from two
+ * workers at once */
+typedef struct
+{
+    state_t * state;
+    ws_event_queue_t queue;
+    atomic_bool scheduled;
+    uint64_t dispatched;
+}
+ws_object_t;
+
+/* Chase-Lev deque of ready machines */
+typedef struct
+{
+    _Alignas(WS_CACHE_LINE) _Atomic int64_t top;
+    _Alignas(WS_CACHE_LINE) _Atomic int64_t bottom;
+    _Atomic(ws_object_t *) buffer[WS_MAX_OBJECTS];
+}
+ws_deque_t;
+
+/* Machines made ready by threads outside the runtime */
+typedef struct
+{
+    fifo_mpmc_base_t base;
+    FIFO_MPMC_SLOT( ws_object_t * ) slot[WS_MAX_OBJECTS];
+}
+ws_inject_queue_t;
+
+typedef struct work_stealing_t work_stealing_t;
+
+typedef struct
+{
+    ws_deque_t deque;
+    pthread_t thread;
+    work_stealing_t * runtime;
+    uint32_t index;
+    uint32_t seed;
+    uint64_t dispatched;
+    uint64_t runs;
+    uint64_t steals;
+    uint64_t steal_attempts;
+    uint64_t busy_ns;
+    uint64_t idle_ns;
+}
+ws_worker_t;
+
+struct work_stealing_t
+{
+    ws_worker_t worker[WS_MAX_WORKERS];
+    ws_inject_queue_t inject;
+    ws_object_t * object[WS_MAX_OBJECTS];
+    uint32_t num_workers;
+    uint32_t num_objects;
+    atomic_uint sleepers;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    atomic_bool accepting;
+    atomic_bool stopping;
+    atomic_uint posting;
+    bool started;
+};
+
+typedef struct
+{
+    uint64_t dispatched;
+    uint64_t steals;
+    uint64_t steal_attempts;
+    /* Busy time as a percentage of the time the worker was running */
+    double utilization;
+}
+ws_stats_t;
+
+extern void WorkStealing_Init( work_stealing_t * const ws, uint32_t num_workers );
+extern void WorkStealing_Register( work_stealing_t * const ws, ws_object_t * const object, state_t * const state );
+extern void WorkStealing_Start( work_stealing_t * const ws );
+extern bool WorkStealing_Post( work_stealing_t * const ws, ws_object_t * const object, event_t event );
+/* Rejects posts from outside the runtime, then returns once every queued
+ * event, including those posted by handlers while draining, is dispatched */
+extern void WorkStealing_Stop( work_stealing_t * const ws );
+extern void WorkStealing_GetStats( work_stealing_t const * const ws, uint32_t worker, ws_stats_t * const stats );
+
+#endif /* WORK_STEALING_H_ */
@@ -1,7 +1,7 @@
 #include "emitter_tests.h"
 #include "emitter_base.h"
 #include "state.h"
-#include "fifo_base.h"
+#include "fifo_static.h"
 #include "unity.h"
 #include <string.h>
 
@@ -18,14 +18,7 @@
 
 GENERATE_EVENTS( EVENTS );
 
-typedef struct
-{
-    fifo_base_t base;
-    event_t queue[FIFO_LEN];
-    event_t in;
-    event_t out;
-}
-emitter_fifo_t;
+GENERATE_FIFO( emitter_fifo, event_t, FIFO_LEN );
 
 typedef struct
 {
@@ -36,28 +29,13 @@ typedef struct
 }
 emitter_t;
 
-static void Enqueue( fifo_base_t * const fifo );
-static void Dequeue( fifo_base_t * const fifo );
-static void Flush( fifo_base_t * const fifo );
-
-static void Destroy(emitter_base_t * const base);
+static void Destroy(emitter_base_t * const base, event_t event);
 static void Create(emitter_base_t * const base, event_t event, uint32_t period);
 static bool Emit(emitter_base_t * const base, event_t event);
 
 static void Init( emitter_t * emitter, emitter_fifo_t * fifo )
 {
-    static const fifo_vfunc_t fifo_vfunc =
-    {
-        .enq = Enqueue,
-        .deq = Dequeue,
-        .flush = Flush,
-    };
-    FIFO_Init( (fifo_base_t *)fifo, FIFO_LEN );
-    
-    fifo->base.vfunc = &fifo_vfunc;
-    fifo->in = 0x0;
-    fifo->out = 0x0;
-    memset(fifo->queue, 0x00, FIFO_LEN * sizeof(fifo->in));
+    emitter_fifo_Init( fifo );
 
     static const emitter_vfunc_t emitter_vfunc =
     {
@@ -72,27 +50,10 @@ static void Init( emitter_t * emitter, emitter_fifo_t * fifo )
     emitter->magic_2 = MAGIC_NUMBER_2;
 }
 
-void Enqueue( fifo_base_t * const base )
-{
-    assert(base != NULL );
-    ENQUEUE_BOILERPLATE( emitter_fifo_t, base );
-}
-
-void Dequeue( fifo_base_t * const base )
-{
-    assert(base != NULL );
-    DEQUEUE_BOILERPLATE( emitter_fifo_t, base );
-}
-
-void Flush( fifo_base_t * const base )
-{
-    assert(base != NULL );
-    FLUSH_BOILERPLATE( emitter_fifo_t, base );
-}
-
-static void Destroy(emitter_base_t * const base)
+static void Destroy(emitter_base_t * const base, event_t event)
 {
     assert(base!=NULL);
+    (void)event;
 }
 
 static void Create(emitter_base_t * const base, event_t event, uint32_t period)
@@ -146,9 +107,9 @@ void test_EMITTER_Init(void)
     TEST_ASSERT_EQUAL(Create, emitter.base.vfunc->create);
     TEST_ASSERT_EQUAL(Destroy, emitter.base.vfunc->destroy);
     
-    TEST_ASSERT_EQUAL(Flush, emitter.base.fifo->vfunc->flush);
-    TEST_ASSERT_EQUAL(Enqueue, emitter.base.fifo->vfunc->enq);
-    TEST_ASSERT_EQUAL(Dequeue, emitter.base.fifo->vfunc->deq);
+    TEST_ASSERT_EQUAL(emitter_fifo_BaseFlush, emitter.base.fifo->vfunc->flush);
+    TEST_ASSERT_EQUAL(emitter_fifo_BaseEnqueue, emitter.base.fifo->vfunc->enq);
+    TEST_ASSERT_EQUAL(emitter_fifo_BaseDequeue, emitter.base.fifo->vfunc->deq);
 }
 
 void test_EMITTER_Emit(void)
@@ -180,8 +141,23 @@ void test_EMITTER_Emit(void)
     TEST_ASSERT_EQUAL( fifo.base.fill, 0U );
 }
 
+/* The fifo argument is what gets checked, not whatever base held before */
+void test_EMITTER_InitZeroed(void)
+{
+    emitter_fifo_t fifo;
+    emitter_t emitter;
+    memset(&emitter, 0x00, sizeof(emitter));
+
+    emitter_fifo_Init(&fifo);
+    Emitter_Init(&emitter.base, &fifo.base);
+
+    TEST_ASSERT_EQUAL_PTR( &fifo.base, emitter.base.fifo );
+    TEST_ASSERT_NOT_NULL( emitter.base.vfunc );
+}
+
 extern void EMITTERTestSuite(void)
 {
     RUN_TEST(test_EMITTER_Init);
     RUN_TEST(test_EMITTER_Emit);
+    RUN_TEST(test_EMITTER_InitZeroed);
 }
@@ -0,0 +1,303 @@
+#include "emitter_wheel_tests.h"
+#include "emitter_wheel.h"
+#include "fifo_static.h"
+#include "unity.h"
+
+#define EVENTS(EVNT) \
+    EVNT(Tick) \
+    EVNT(Timeout) \
+    EVNT(Heartbeat) \
+
+#define FIFO_LEN (64U)
+#define NUM_TIMERS (256U)
+
+GENERATE_EVENTS( EVENTS );
+
+GENERATE_FIFO( wheel_fifo, event_t, FIFO_LEN );
+
+static wheel_fifo_t fifo;
+static emitter_wheel_t wheel;
+static emitter_timer_t timers[NUM_TIMERS];
+static uint64_t ticks;
+
+static uint64_t Clock( void * arg )
+{
+    return *(uint64_t *)arg;
+}
+
+static void Init( uint64_t start )
+{
+    ticks = start;
+    wheel_fifo_Init(&fifo);
+    EMITTER_WHEEL_Init(&wheel, &fifo, timers, NUM_TIMERS, Clock, &ticks);
+}
+
+/* Polls one tick at a time up to target, returns the tick of the last emit */
+static uint64_t RunTo( uint64_t target )
+{
+    uint64_t last = 0U;
+    while( ticks < target )
+    {
+        ticks++;
+        if( EMITTER_WHEEL_Poll(&wheel) > 0U )
+        {
+            last = ticks;
+        }
+    }
+    return last;
+}
+
+static void test_EMITTER_WHEEL_Init(void)
+{
+    Init(1000U);
+
+    TEST_ASSERT_EQUAL_PTR( &fifo.base, wheel.base.fifo );
+    TEST_ASSERT_EQUAL( 1000U, wheel.now );
+    TEST_ASSERT_EQUAL( 0U, wheel.active );
+    TEST_ASSERT_EQUAL( 0U, EMITTER_WHEEL_Poll(&wheel) );
+    TEST_ASSERT_FALSE( EMITTER_WHEEL_IsActive(&wheel, 0U) );
+}
+
+static void test_EMITTER_WHEEL_OneShot(void)
+{
+    Init(0U);
+
+    emitter_handle_t handle = EMITTER_WHEEL_Start(&wheel, EVENT(Timeout), 10U, 0U);
+    TEST_ASSERT_TRUE( EMITTER_WHEEL_IsActive(&wheel, handle) );
+
+    TEST_ASSERT_EQUAL( 10U, RunTo(100U) );
+    TEST_ASSERT_EQUAL( 1U, wheel_fifo_Fill(&fifo) );
+    TEST_ASSERT_EQUAL( EVENT(Timeout), wheel_fifo_Pop(&fifo) );
+    TEST_ASSERT_FALSE( EMITTER_WHEEL_IsActive(&wheel, handle) );
+    TEST_ASSERT_EQUAL( 0U, wheel.active );
+}
+
+static void test_EMITTER_WHEEL_Periodic(void)
+{
+    Init(0U);
+
+    (void)EMITTER_WHEEL_Start(&wheel, EVENT(Tick), 5U, 5U);
+    RunTo(50U);
+
+    TEST_ASSERT_EQUAL( 10U, wheel_fifo_Fill(&fifo) );
+    TEST_ASSERT_EQUAL( 10U, wheel.fired );
+    TEST_ASSERT_EQUAL( 1U, wheel.active );
+}
+
+static void test_EMITTER_WHEEL_Stop(void)
+{
+    Init(0U);
+
+    emitter_handle_t a = EMITTER_WHEEL_Start(&wheel, EVENT(Timeout), 20U, 0U);
+    emitter_handle_t b = EMITTER_WHEEL_Start(&wheel, EVENT(Heartbeat), 20U, 0U);
+
+    TEST_ASSERT_TRUE( EMITTER_WHEEL_Stop(&wheel, a) );
+    TEST_ASSERT_FALSE( EMITTER_WHEEL_Stop(&wheel, a) );
+    RunTo(30U);
+
+    TEST_ASSERT_EQUAL( 1U, wheel_fifo_Fill(&fifo) );
+    TEST_ASSERT_EQUAL( EVENT(Heartbeat), wheel_fifo_Pop(&fifo) );
+    TEST_ASSERT_FALSE( EMITTER_WHEEL_Stop(&wheel, b) );
+
+    /* A reused timer does not answer to the old handle */
+    emitter_handle_t c = EMITTER_WHEEL_Start(&wheel, EVENT(Tick), 5U, 0U);
+    TEST_ASSERT_NOT_EQUAL( a, c );
+    TEST_ASSERT_NOT_EQUAL( b, c );
+    TEST_ASSERT_FALSE( EMITTER_WHEEL_IsActive(&wheel, b) );
+    TEST_ASSERT_TRUE( EMITTER_WHEEL_IsActive(&wheel, c) );
+}
+
+static void test_EMITTER_WHEEL_StaleHandle(void)
+{
+    Init(0U);
+
+    emitter_handle_t first = EMITTER_WHEEL_Start(&wheel, EVENT(Timeout), 20U, 0U);
+    TEST_ASSERT_TRUE( EMITTER_WHEEL_Stop(&wheel, first) );
+
+    /* Reuse the same timer well past the point where a generation packed
+     * in with the index would have wrapped round to the first handle */
+    timers[ (uint32_t)first ].generation = UINT32_MAX / NUM_TIMERS;
+    for( uint32_t idx = 0; idx < 3U; idx++ )
+    {
+        emitter_handle_t again = EMITTER_WHEEL_Start(&wheel, EVENT(Timeout), 20U, 0U);
+        TEST_ASSERT_EQUAL( (uint32_t)first, (uint32_t)again );
+        TEST_ASSERT_NOT_EQUAL( first, again );
+        TEST_ASSERT_FALSE( EMITTER_WHEEL_IsActive(&wheel, first) );
+        TEST_ASSERT_FALSE( EMITTER_WHEEL_Stop(&wheel, first) );
+        TEST_ASSERT_TRUE( EMITTER_WHEEL_Stop(&wheel, again) );
+    }
+    TEST_ASSERT_FALSE( EMITTER_WHEEL_IsActive(&wheel, EMITTER_HANDLE_INVALID) );
+}
+
+/* Delays that land in every level, and across carries between them,
+ * each emit on exactly their tick */
+static void test_EMITTER_WHEEL_Levels(void)
+{
+    const uint32_t delays[] = { 1U, 63U, 64U, 65U, 200U, 4095U, 4096U, 4097U, 70000U, 300000U };
+    const uint64_t starts[] = { 0U, 62U, 4094U, ( 1ULL << 24U ) - 3U, ( 1ULL << 30U ) - 2U };
+
+    for( uint32_t s = 0; s < sizeof(starts) / sizeof(starts[0]); s++ )
+    {
+        for( uint32_t d = 0; d < sizeof(delays) / sizeof(delays[0]); d++ )
+        {
+            Init(starts[s]);
+            (void)EMITTER_WHEEL_Start(&wheel, EVENT(Timeout), delays[d], 0U);
+
+            /* Jump to just before, then tick onto it */
+            ticks = starts[s] + delays[d] - 1U;
+            TEST_ASSERT_EQUAL( 0U, EMITTER_WHEEL_Poll(&wheel) );
+            ticks++;
+            TEST_ASSERT_EQUAL( 1U, EMITTER_WHEEL_Poll(&wheel) );
+            TEST_ASSERT_EQUAL( 0U, wheel.active );
+        }
+    }
+}
+
+/* Further than the wheel spans, parked in the top level until it turns */
+static void test_EMITTER_WHEEL_Beyond(void)
+{
+    const uint64_t span = 1ULL << ( EMITTER_WHEEL_BITS * EMITTER_WHEEL_LEVELS );
+    Init(12345U);
+
+    (void)EMITTER_WHEEL_Start(&wheel, EVENT(Timeout), UINT32_MAX, 0U);
+    TEST_ASSERT_TRUE( UINT32_MAX > span );
+
+    ticks = 12345ULL + UINT32_MAX - 1U;
+    TEST_ASSERT_EQUAL( 0U, EMITTER_WHEEL_Poll(&wheel) );
+    ticks++;
+    TEST_ASSERT_EQUAL( 1U, EMITTER_WHEEL_Poll(&wheel) );
+}
+
+/* A late poll emits everything that fell due, periodic ones each time */
+static void test_EMITTER_WHEEL_Jump(void)
+{
+    Init(0U);
+
+    (void)EMITTER_WHEEL_Start(&wheel, EVENT(Tick), 100U, 100U);
+    (void)EMITTER_WHEEL_Start(&wheel, EVENT(Timeout), 250U, 0U);
+
+    ticks = 1000U;
+    TEST_ASSERT_EQUAL( 11U, EMITTER_WHEEL_Poll(&wheel) );
+    TEST_ASSERT_EQUAL( 1000U, wheel.now );
+    TEST_ASSERT_EQUAL( 1U, wheel.active );
+}
+
+static void test_EMITTER_WHEEL_Emitter(void)
+{
+    Init(0U);
+
+    Emitter_Create(&wheel.base, EVENT(Heartbeat), 10U);
+    RunTo(30U);
+    TEST_ASSERT_EQUAL( 3U, wheel_fifo_Fill(&fifo) );
+
+    /* Creating again restarts rather than adding a second timer */
+    Emitter_Create(&wheel.base, EVENT(Heartbeat), 20U);
+    TEST_ASSERT_EQUAL( 1U, wheel.active );
+    RunTo(50U);
+    TEST_ASSERT_EQUAL( 4U, wheel_fifo_Fill(&fifo) );
+
+    Emitter_Destroy(&wheel.base, EVENT(Heartbeat));
+    TEST_ASSERT_EQUAL( 0U, wheel.active );
+    RunTo(200U);
+    TEST_ASSERT_EQUAL( 4U, wheel_fifo_Fill(&fifo) );
+
+    TEST_ASSERT_TRUE( Emitter_Emit(&wheel.base, EVENT(Tick)) );
+    TEST_ASSERT_EQUAL( 5U, wheel_fifo_Fill(&fifo) );
+}
+
+static void test_EMITTER_WHEEL_Full(void)
+{
+    Init(0U);
+    FIFO_SetOverflow(&fifo.base, FIFO_OVERFLOW_REJECT, 0);
+
+    for( uint32_t idx = 0; idx < NUM_TIMERS; idx++ )
+    {
+        TEST_ASSERT_NOT_EQUAL( EMITTER_HANDLE_INVALID, EMITTER_WHEEL_Start(&wheel, EVENT(Tick), 1U + ( idx % 7U ), 0U) );
+    }
+    TEST_ASSERT_EQUAL( EMITTER_HANDLE_INVALID, EMITTER_WHEEL_Start(&wheel, EVENT(Tick), 1U, 0U) );
+
+    RunTo(10U);
+    TEST_ASSERT_EQUAL( FIFO_LEN, wheel_fifo_Fill(&fifo) );
+    TEST_ASSERT_EQUAL( FIFO_LEN, wheel.fired );
+    TEST_ASSERT_EQUAL( NUM_TIMERS - FIFO_LEN, wheel.dropped );
+    TEST_ASSERT_EQUAL( 0U, wheel.active );
+}
+
+/* Random one-shots checked against their own expiry ticks */
+static void test_EMITTER_WHEEL_Random(void)
+{
+    uint64_t expiry[NUM_TIMERS];
+    emitter_handle_t handle[NUM_TIMERS];
+    uint32_t seed = 0x12345678U;
+    Init(777U);
+    FIFO_SetOverflow(&fifo.base, FIFO_OVERFLOW_REJECT, 0);
+
+    for( uint32_t idx = 0; idx < NUM_TIMERS; idx++ )
+    {
+        seed ^= seed << 13U;
+        seed ^= seed >> 17U;
+        seed ^= seed << 5U;
+        uint32_t delay = 1U + ( seed % 20000U );
+        expiry[idx] = 777U + delay;
+        handle[idx] = EMITTER_WHEEL_Start(&wheel, EVENT(Timeout), delay, 0U);
+    }
+
+    for( uint64_t now = 778U; now <= 777U + 20000U; now += 37U )
+    {
+        ticks = now;
+        (void)EMITTER_WHEEL_Poll(&wheel);
+        for( uint32_t idx = 0; idx < NUM_TIMERS; idx++ )
+        {
+            TEST_ASSERT_EQUAL( expiry[idx] > now, EMITTER_WHEEL_IsActive(&wheel, handle[idx]) );
+        }
+    }
+}
+
+/* Far apart expiries across every level, polled with large jumps */
+static void test_EMITTER_WHEEL_Far(void)
+{
+    uint64_t expiry[NUM_TIMERS];
+    emitter_handle_t handle[NUM_TIMERS];
+    uint32_t seed = 0x9E3779B9U;
+    Init(5U);
+    FIFO_SetOverflow(&fifo.base, FIFO_OVERFLOW_REJECT, 0);
+
+    for( uint32_t idx = 0; idx < NUM_TIMERS; idx++ )
+    {
+        seed ^= seed << 13U;
+        seed ^= seed >> 17U;
+        seed ^= seed << 5U;
+        const uint32_t delay = 1U + ( seed >> ( idx % 31U ) );
+        expiry[idx] = 5U + delay;
+        handle[idx] = EMITTER_WHEEL_Start(&wheel, EVENT(Timeout), delay, 0U);
+    }
+
+    uint64_t fired = 0U;
+    for( uint64_t now = 5U; wheel.active > 0U; now += ( 1ULL << 26U ) + 12345U )
+    {
+        ticks = now;
+        fired += EMITTER_WHEEL_Poll(&wheel);
+        wheel_fifo_Flush(&fifo);
+        for( uint32_t idx = 0; idx < NUM_TIMERS; idx++ )
+        {
+            TEST_ASSERT_EQUAL( expiry[idx] > now, EMITTER_WHEEL_IsActive(&wheel, handle[idx]) );
+        }
+    }
+    TEST_ASSERT_EQUAL( NUM_TIMERS, fired );
+}
+
+extern void EMITTERWHEELTestSuite(void)
+{
+    RUN_TEST(test_EMITTER_WHEEL_Init);
+    RUN_TEST(test_EMITTER_WHEEL_OneShot);
+    RUN_TEST(test_EMITTER_WHEEL_Periodic);
+    RUN_TEST(test_EMITTER_WHEEL_Stop);
+    RUN_TEST(test_EMITTER_WHEEL_StaleHandle);
+    RUN_TEST(test_EMITTER_WHEEL_Levels);
+    RUN_TEST(test_EMITTER_WHEEL_Beyond);
+    RUN_TEST(test_EMITTER_WHEEL_Jump);
+    RUN_TEST(test_EMITTER_WHEEL_Emitter);
+    RUN_TEST(test_EMITTER_WHEEL_Full);
+    RUN_TEST(test_EMITTER_WHEEL_Random);
+    RUN_TEST(test_EMITTER_WHEEL_Far);
+}
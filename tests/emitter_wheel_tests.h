@@ -0,0 +1,6 @@
+#ifndef EMITTER_WHEEL_TESTS_H
+#define EMITTER_WHEEL_TESTS_H
+
+extern void EMITTERWHEELTestSuite(void);
+
+#endif /* EMITTER_WHEEL_TESTS_H */
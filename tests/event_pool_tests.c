@@ -0,0 +1,321 @@
+#include "event_pool_tests.h"
+#include "event_pool.h"
+#include "event_observer.h"
+#include "state.h"
+#include "unity.h"
+#include <pthread.h>
+#include <string.h>
+
+#define EVENTS(EVNT) \
+    EVNT(Reading) \
+    EVNT(Alarm) \
+
+GENERATE_EVENTS( EVENTS );
+
+#define SMALL_BLOCKS (4U)
+#define LARGE_BLOCKS (2U)
+#define NUM_SUBSCRIBERS (3U)
+#define STRESS_THREADS (2U)
+#define STRESS_LOOPS (10000U)
+
+typedef struct
+{
+    uint32_t sequence;
+    int32_t value;
+}
+reading_t;
+
+typedef struct
+{
+    state_t state;
+    event_handle_fifo_t fifo;
+    void const * payload;
+    int32_t value;
+}
+subscriber_t;
+
+DEFINE_STATE(Listening);
+
+static state_ret_t State_Listening( state_t * this, event_t s )
+{
+    state_ret_t ret;
+    subscriber_t * subscriber = (subscriber_t *)this;
+
+    switch( s )
+    {
+        case EVENT(Enter):
+        case EVENT(Exit):
+        case EVENT(Alarm):
+            ret = HANDLED(this);
+            break;
+        case EVENT(Reading):
+        {
+            reading_t const * reading = EventPool_CurrentPayload();
+            TEST_ASSERT_EQUAL( sizeof( reading_t ), EventPool_CurrentSize() );
+            subscriber->payload = reading;
+            subscriber->value = reading->value;
+            ret = HANDLED(this);
+            break;
+        }
+        default:
+            ret = NO_PARENT(this);
+            break;
+    }
+
+    return ret;
+}
+
+static bool Post( state_t * const subscriber, event_handle_t handle, void * const arg )
+{
+    (void)arg;
+    subscriber_t * s = (subscriber_t *)subscriber;
+    bool success = false;
+    if( !FIFO_IsFull( &s->fifo.base ) )
+    {
+        FIFO_Enqueue( &s->fifo, handle );
+        success = true;
+    }
+    return success;
+}
+
+static void CreatePool( event_pool_t * pool )
+{
+    GENERATE_EVENT_POOL_CLASS( small, 8U, SMALL_BLOCKS );
+    GENERATE_EVENT_POOL_CLASS( large, 64U, LARGE_BLOCKS );
+
+    EventPool_Init( pool );
+    EventPool_AddClass( pool, &small );
+    EventPool_AddClass( pool, &large );
+}
+
+static void test_EVENTPOOL_Init( void )
+{
+    event_pool_t pool;
+    event_pool_stats_t stats;
+
+    CreatePool( &pool );
+
+    TEST_ASSERT_EQUAL( 2U, pool.num_classes );
+    TEST_ASSERT_EQUAL( 0U, EventPool_Failed( &pool ) );
+
+    EventPool_GetStats( &pool, 1U, &stats );
+    TEST_ASSERT_EQUAL( 64U, stats.payload_size );
+    TEST_ASSERT_EQUAL( LARGE_BLOCKS, stats.num_blocks );
+    TEST_ASSERT_EQUAL( 0U, stats.in_use );
+    TEST_ASSERT_EQUAL( 0U, stats.high_water );
+    TEST_ASSERT_EQUAL( 0U, pool.size_class[0]->block_size % EVENT_POOL_ALIGN );
+}
+
+static void test_EVENTPOOL_AllocRelease( void )
+{
+    event_pool_t pool;
+    event_pool_stats_t stats;
+    event_handle_t handle;
+
+    CreatePool( &pool );
+
+    TEST_ASSERT_TRUE( EventPool_Alloc( &pool, EVENT(Reading), sizeof( reading_t ), &handle ) );
+    TEST_ASSERT_EQUAL( EVENT(Reading), handle.event );
+    TEST_ASSERT_EQUAL_PTR( pool.size_class[0], handle.block->owner );
+    TEST_ASSERT_EQUAL( 0U, (uintptr_t)EventPool_Payload( handle ) % EVENT_POOL_ALIGN );
+
+    /* Too big for the small class */
+    event_handle_t big;
+    TEST_ASSERT_TRUE( EventPool_Alloc( &pool, EVENT(Alarm), 32U, &big ) );
+    TEST_ASSERT_EQUAL_PTR( pool.size_class[1], big.block->owner );
+
+    EventPool_GetStats( &pool, 0U, &stats );
+    TEST_ASSERT_EQUAL( 1U, stats.in_use );
+
+    EventPool_Retain( handle, 2U );
+    EventPool_Release( handle );
+    EventPool_Release( handle );
+    EventPool_GetStats( &pool, 0U, &stats );
+    TEST_ASSERT_EQUAL( 1U, stats.in_use );
+
+    EventPool_Release( handle );
+    EventPool_Release( big );
+    EventPool_GetStats( &pool, 0U, &stats );
+    TEST_ASSERT_EQUAL( 0U, stats.in_use );
+    TEST_ASSERT_EQUAL( 1U, stats.high_water );
+
+    /* Handles without a payload are ignored */
+    EventPool_Release( EventPool_Handle( EVENT(Alarm) ) );
+}
+
+static void test_EVENTPOOL_Exhaustion( void )
+{
+    event_pool_t pool;
+    event_pool_stats_t stats;
+    event_handle_t handle[ SMALL_BLOCKS + LARGE_BLOCKS ];
+    event_handle_t spare;
+
+    CreatePool( &pool );
+
+    /* Small allocations spill into the large class once it is empty */
+    for( uint32_t idx = 0U; idx < ( SMALL_BLOCKS + LARGE_BLOCKS ); idx++ )
+    {
+        TEST_ASSERT_TRUE( EventPool_Alloc( &pool, EVENT(Reading), 4U, &handle[idx] ) );
+    }
+    TEST_ASSERT_EQUAL_PTR( pool.size_class[1], handle[SMALL_BLOCKS].block->owner );
+    TEST_ASSERT_FALSE( EventPool_Alloc( &pool, EVENT(Reading), 4U, &spare ) );
+    TEST_ASSERT_EQUAL( 1U, EventPool_Failed( &pool ) );
+
+    EventPool_GetStats( &pool, 0U, &stats );
+    TEST_ASSERT_EQUAL( SMALL_BLOCKS, stats.high_water );
+    TEST_ASSERT_EQUAL( 3U, stats.exhausted );
+    EventPool_GetStats( &pool, 1U, &stats );
+    TEST_ASSERT_EQUAL( LARGE_BLOCKS, stats.in_use );
+    TEST_ASSERT_EQUAL( 1U, stats.exhausted );
+
+    /* Freed blocks are reused */
+    EventPool_Release( handle[1] );
+    TEST_ASSERT_TRUE( EventPool_Alloc( &pool, EVENT(Reading), 4U, &spare ) );
+    TEST_ASSERT_EQUAL_PTR( handle[1].block, spare.block );
+}
+
+static void test_EVENTPOOL_Multicast( void )
+{
+    GENERATE_EVENT_OBSERVERS( observer, EVENTS );
+    event_pool_t pool;
+    event_pool_stats_t stats;
+    event_handle_t handle;
+    subscriber_t subscriber[ NUM_SUBSCRIBERS ];
+
+    CreatePool( &pool );
+    EventObserver_Init( observer, EVENT(EventCount) );
+    for( uint32_t idx = 0U; idx < NUM_SUBSCRIBERS; idx++ )
+    {
+        STATEMACHINE_Init( &subscriber[idx].state, STATE( Listening ) );
+        EventHandleFIFO_Init( &subscriber[idx].fifo );
+        subscriber[idx].payload = NULL;
+        subscriber[idx].value = 0;
+        EventObserver_Subscribe( observer, EVENT(Reading), &subscriber[idx].state );
+    }
+
+    TEST_ASSERT_TRUE( EventPool_Alloc( &pool, EVENT(Reading), sizeof( reading_t ), &handle ) );
+    reading_t * reading = EventPool_Payload( handle );
+    reading->sequence = 1U;
+    reading->value = -42;
+
+    TEST_ASSERT_EQUAL( NUM_SUBSCRIBERS, EventObserver_Multicast( observer, handle, Post, NULL ) );
+    TEST_ASSERT_EQUAL( NUM_SUBSCRIBERS, atomic_load( &handle.block->refs ) );
+
+    for( uint32_t idx = 0U; idx < NUM_SUBSCRIBERS; idx++ )
+    {
+        EventPool_GetStats( &pool, 0U, &stats );
+        TEST_ASSERT_EQUAL( 1U, stats.in_use );
+
+        event_handle_t received = FIFO_Dequeue( &subscriber[idx].fifo );
+        EventPool_Dispatch( &subscriber[idx].state, received );
+
+        /* Every subscriber sees the same block */
+        TEST_ASSERT_EQUAL_PTR( reading, subscriber[idx].payload );
+        TEST_ASSERT_EQUAL( -42, subscriber[idx].value );
+    }
+
+    EventPool_GetStats( &pool, 0U, &stats );
+    TEST_ASSERT_EQUAL( 0U, stats.in_use );
+    TEST_ASSERT_NULL( EventPool_CurrentPayload() );
+}
+
+static void test_EVENTPOOL_MulticastRejected( void )
+{
+    GENERATE_EVENT_OBSERVERS( observer, EVENTS );
+    event_pool_t pool;
+    event_pool_stats_t stats;
+    event_handle_t handle;
+    subscriber_t subscriber;
+
+    CreatePool( &pool );
+    EventObserver_Init( observer, EVENT(EventCount) );
+    STATEMACHINE_Init( &subscriber.state, STATE( Listening ) );
+    EventHandleFIFO_Init( &subscriber.fifo );
+    EventObserver_Subscribe( observer, EVENT(Reading), &subscriber.state );
+
+    /* Fill the subscriber's queue with plain events */
+    while( !FIFO_IsFull( &subscriber.fifo.base ) )
+    {
+        FIFO_Enqueue( &subscriber.fifo, EventPool_Handle( EVENT(Alarm) ) );
+    }
+
+    TEST_ASSERT_TRUE( EventPool_Alloc( &pool, EVENT(Reading), sizeof( reading_t ), &handle ) );
+    TEST_ASSERT_EQUAL( 0U, EventObserver_Multicast( observer, handle, Post, NULL ) );
+
+    EventPool_GetStats( &pool, 0U, &stats );
+    TEST_ASSERT_EQUAL( 0U, stats.in_use );
+}
+
+typedef struct
+{
+    event_pool_t * pool;
+    uint32_t corrupted;
+}
+stress_t;
+
+static void * Stress( void * arg )
+{
+    stress_t * stress = (stress_t *)arg;
+    event_handle_t handle[ 2U ];
+
+    for( uint32_t idx = 0U; idx < STRESS_LOOPS; idx++ )
+    {
+        for( uint32_t jdx = 0U; jdx < 2U; jdx++ )
+        {
+            while( !EventPool_Alloc( stress->pool, EVENT(Reading), 4U, &handle[jdx] ) )
+            {
+            }
+            *(uint32_t *)EventPool_Payload( handle[jdx] ) = idx;
+        }
+        for( uint32_t jdx = 0U; jdx < 2U; jdx++ )
+        {
+            if( *(uint32_t *)EventPool_Payload( handle[jdx] ) != idx )
+            {
+                stress->corrupted++;
+            }
+            EventPool_Release( handle[jdx] );
+        }
+    }
+
+    return NULL;
+}
+
+static void test_EVENTPOOL_Concurrent( void )
+{
+    static event_pool_t pool;
+    event_pool_stats_t stats;
+    pthread_t thread[ STRESS_THREADS ];
+    stress_t stress[ STRESS_THREADS ];
+
+    CreatePool( &pool );
+    for( uint32_t idx = 0U; idx < STRESS_THREADS; idx++ )
+    {
+        stress[idx] = (stress_t){ .pool = &pool, .corrupted = 0U };
+        pthread_create( &thread[idx], NULL, Stress, &stress[idx] );
+    }
+    for( uint32_t idx = 0U; idx < STRESS_THREADS; idx++ )
+    {
+        pthread_join( thread[idx], NULL );
+    }
+    for( uint32_t idx = 0U; idx < STRESS_THREADS; idx++ )
+    {
+        TEST_ASSERT_EQUAL( 0U, stress[idx].corrupted );
+    }
+
+    for( uint32_t idx = 0U; idx < pool.num_classes; idx++ )
+    {
+        EventPool_GetStats( &pool, idx, &stats );
+        TEST_ASSERT_EQUAL( 0U, stats.in_use );
+        TEST_ASSERT_LESS_OR_EQUAL( stats.num_blocks, stats.high_water );
+    }
+}
+
+extern void EVENTPOOLTestSuite(void)
+{
+    RUN_TEST(test_EVENTPOOL_Init);
+    RUN_TEST(test_EVENTPOOL_AllocRelease);
+    RUN_TEST(test_EVENTPOOL_Exhaustion);
+    RUN_TEST(test_EVENTPOOL_Multicast);
+    RUN_TEST(test_EVENTPOOL_MulticastRejected);
+    RUN_TEST(test_EVENTPOOL_Concurrent);
+}
@@ -0,0 +1,6 @@
+#ifndef EVENT_POOL_TESTS_H
+#define EVENT_POOL_TESTS_H
+
+extern void EVENTPOOLTestSuite(void);
+
+#endif /* EVENT_POOL_TESTS_H */
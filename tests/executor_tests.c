@@ -0,0 +1,245 @@
+#include "executor_tests.h"
+#include "executor.h"
+#include "state.h"
+#include "unity.h"
+#include <sched.h>
+#include <string.h>
+
+#define EVENTS(EVNT) \
+    EVNT(Increment) \
+    EVNT(Relay) \
+
+GENERATE_EVENTS( EVENTS );
+
+#define NUM_OBJECTS (4U)
+#define NUM_PRODUCERS (2U)
+#define EVENTS_PER_PRODUCER (1000U)
+#define RELAY_HOPS (10000U)
+
+typedef struct
+{
+    state_t state;
+    atomic_bool in_dispatch;
+    uint32_t count;
+    uint32_t overlaps;
+}
+counter_t;
+
+typedef struct
+{
+    executor_t * exec;
+    executor_object_t * object;
+}
+producer_t;
+
+DEFINE_STATE(Counting);
+
+/* Relays pass a single event back and forth between two machines */
+static executor_t relay_exec;
+static executor_object_t relay_object[2];
+static atomic_uint relay_hops;
+
+/* The last CPU glibc's cpu_set_t can name, which no test machine has */
+#define MISSING_CPU (1023)
+
+static state_ret_t State_Counting( state_t * this, event_t s )
+{
+    state_ret_t ret;
+    counter_t * counter = (counter_t *)this;
+
+    switch( s )
+    {
+        case EVENT(Enter):
+        case EVENT(Exit):
+            ret = HANDLED(this);
+            break;
+        case EVENT(Increment):
+            if( atomic_exchange( &counter->in_dispatch, true ) )
+            {
+                counter->overlaps++;
+            }
+            counter->count++;
+            atomic_store( &counter->in_dispatch, false );
+            ret = HANDLED(this);
+            break;
+        case EVENT(Relay):
+            counter->count++;
+            if( ( atomic_fetch_add( &relay_hops, 1U ) + 1U ) < RELAY_HOPS )
+            {
+                executor_object_t * const peer = ( relay_object[0].state == this ) ? &relay_object[1] : &relay_object[0];
+                if( !Executor_Post( &relay_exec, peer, EVENT(Relay) ) )
+                {
+                    counter->overlaps++;
+                }
+            }
+            ret = HANDLED(this);
+            break;
+        default:
+            ret = NO_PARENT(this);
+            break;
+    }
+
+    return ret;
+}
+
+static void * Producer( void * arg )
+{
+    producer_t * producer = (producer_t *)arg;
+
+    for( uint32_t idx = 0U; idx < EVENTS_PER_PRODUCER; idx++ )
+    {
+        for( uint32_t jdx = 0U; jdx < NUM_OBJECTS; jdx++ )
+        {
+            while( !Executor_Post( producer->exec, &producer->object[jdx], EVENT(Increment) ) )
+            {
+                sched_yield();
+            }
+        }
+    }
+
+    return NULL;
+}
+
+static void CreateCounters( counter_t * counter, uint32_t num )
+{
+    for( uint32_t idx = 0U; idx < num; idx++ )
+    {
+        STATEMACHINE_Init( &counter[idx].state, STATE( Counting ) );
+        atomic_init( &counter[idx].in_dispatch, false );
+        counter[idx].count = 0U;
+        counter[idx].overlaps = 0U;
+    }
+}
+
+static void test_EXECUTOR_Init( void )
+{
+    static executor_t exec;
+    const int cpus[2] = { EXECUTOR_NO_AFFINITY, 0 };
+
+    Executor_Init( &exec, 2U, cpus );
+
+    TEST_ASSERT_EQUAL( 2U, exec.num_workers );
+    TEST_ASSERT_EQUAL( EXECUTOR_NO_AFFINITY, exec.worker[0].cpu );
+    TEST_ASSERT_EQUAL( 0, exec.worker[1].cpu );
+    TEST_ASSERT_FALSE( exec.started );
+    TEST_ASSERT_TRUE( FIFO_MPMC_IsEmpty( &exec.worker[1].queue.base ) );
+}
+
+static void test_EXECUTOR_Register( void )
+{
+    static executor_t exec;
+    executor_object_t object[3];
+    counter_t counter[3];
+
+    CreateCounters( counter, 3U );
+    Executor_Init( &exec, 2U, NULL );
+
+    Executor_Register( &exec, &object[0], &counter[0].state, EXECUTOR_ANY_WORKER );
+    Executor_Register( &exec, &object[1], &counter[1].state, EXECUTOR_ANY_WORKER );
+    Executor_Register( &exec, &object[2], &counter[2].state, 1U );
+
+    TEST_ASSERT_EQUAL( 0U, object[0].worker );
+    TEST_ASSERT_EQUAL( 1U, object[1].worker );
+    TEST_ASSERT_EQUAL( 1U, object[2].worker );
+    TEST_ASSERT_EQUAL( &counter[2].state, object[2].state );
+}
+
+static void test_EXECUTOR_PostBeforeStart( void )
+{
+    static executor_t exec;
+    executor_object_t object;
+    counter_t counter;
+
+    CreateCounters( &counter, 1U );
+    Executor_Init( &exec, 1U, NULL );
+    Executor_Register( &exec, &object, &counter.state, EXECUTOR_ANY_WORKER );
+
+    TEST_ASSERT_FALSE( Executor_Post( &exec, &object, EVENT(Increment) ) );
+}
+
+static void test_EXECUTOR_Drain( void )
+{
+    static executor_t exec;
+    executor_object_t object[NUM_OBJECTS];
+    counter_t counter[NUM_OBJECTS];
+    producer_t producer = { .exec = &exec, .object = object };
+    pthread_t thread[NUM_PRODUCERS];
+
+    CreateCounters( counter, NUM_OBJECTS );
+    Executor_Init( &exec, 2U, NULL );
+    for( uint32_t idx = 0U; idx < NUM_OBJECTS; idx++ )
+    {
+        Executor_Register( &exec, &object[idx], &counter[idx].state, EXECUTOR_ANY_WORKER );
+    }
+    TEST_ASSERT_EQUAL( 0, Executor_Start( &exec ) );
+
+    for( uint32_t idx = 0U; idx < NUM_PRODUCERS; idx++ )
+    {
+        pthread_create( &thread[idx], NULL, Producer, &producer );
+    }
+    for( uint32_t idx = 0U; idx < NUM_PRODUCERS; idx++ )
+    {
+        pthread_join( thread[idx], NULL );
+    }
+
+    Executor_Stop( &exec );
+
+    for( uint32_t idx = 0U; idx < NUM_OBJECTS; idx++ )
+    {
+        TEST_ASSERT_EQUAL( NUM_PRODUCERS * EVENTS_PER_PRODUCER, counter[idx].count );
+        TEST_ASSERT_EQUAL( NUM_PRODUCERS * EVENTS_PER_PRODUCER, object[idx].dispatched );
+        TEST_ASSERT_EQUAL( 0U, counter[idx].overlaps );
+    }
+    TEST_ASSERT_EQUAL( 2U * NUM_PRODUCERS * EVENTS_PER_PRODUCER, exec.worker[0].dispatched );
+    TEST_ASSERT_EQUAL( 2U * NUM_PRODUCERS * EVENTS_PER_PRODUCER, exec.worker[1].dispatched );
+
+    /* Posts are rejected once stopped */
+    TEST_ASSERT_FALSE( Executor_Post( &exec, &object[0], EVENT(Increment) ) );
+}
+
+/* Stop waits for events handlers post to each other while draining */
+static void test_EXECUTOR_DrainInternal( void )
+{
+    counter_t counter[2];
+
+    CreateCounters( counter, 2U );
+    atomic_init( &relay_hops, 0U );
+    Executor_Init( &relay_exec, 2U, NULL );
+    Executor_Register( &relay_exec, &relay_object[0], &counter[0].state, 0U );
+    Executor_Register( &relay_exec, &relay_object[1], &counter[1].state, 1U );
+    TEST_ASSERT_EQUAL( 0, Executor_Start( &relay_exec ) );
+
+    TEST_ASSERT_TRUE( Executor_Post( &relay_exec, &relay_object[0], EVENT(Relay) ) );
+    Executor_Stop( &relay_exec );
+
+    TEST_ASSERT_EQUAL( RELAY_HOPS, counter[0].count + counter[1].count );
+    TEST_ASSERT_EQUAL( 0U, counter[0].overlaps + counter[1].overlaps );
+    TEST_ASSERT_FALSE( Executor_Post( &relay_exec, &relay_object[0], EVENT(Relay) ) );
+}
+
+/* A CPU that cannot be pinned to fails the start, with nothing running */
+static void test_EXECUTOR_StartFails( void )
+{
+    static executor_t exec;
+    executor_object_t object;
+    counter_t counter;
+    const int cpus[2] = { EXECUTOR_NO_AFFINITY, MISSING_CPU };
+
+    CreateCounters( &counter, 1U );
+    Executor_Init( &exec, 2U, cpus );
+    Executor_Register( &exec, &object, &counter.state, 0U );
+
+    TEST_ASSERT_NOT_EQUAL( 0, Executor_Start( &exec ) );
+    TEST_ASSERT_FALSE( exec.started );
+    TEST_ASSERT_FALSE( Executor_Post( &exec, &object, EVENT(Increment) ) );
+}
+
+extern void EXECUTORTestSuite(void)
+{
+    RUN_TEST(test_EXECUTOR_Init);
+    RUN_TEST(test_EXECUTOR_Register);
+    RUN_TEST(test_EXECUTOR_PostBeforeStart);
+    RUN_TEST(test_EXECUTOR_Drain);
+    RUN_TEST(test_EXECUTOR_DrainInternal);
+    RUN_TEST(test_EXECUTOR_StartFails);
+}
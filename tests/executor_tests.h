@@ -0,0 +1,6 @@
+#ifndef EXECUTOR_TESTS_H
+#define EXECUTOR_TESTS_H
+
+extern void EXECUTORTestSuite(void);
+
+#endif /* EXECUTOR_TESTS_H */
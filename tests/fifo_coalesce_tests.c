@@ -0,0 +1,175 @@
+#include "fifo_coalesce_tests.h"
+#include "fifo_coalesce.h"
+#include "fifo_static.h"
+#include "unity.h"
+
+#define FIFO_LEN (8U)
+
+#define EVENTS(EVNT) \
+    EVNT(Tick) \
+    EVNT(Sensor) \
+    EVNT(Command) \
+
+GENERATE_EVENTS( EVENTS );
+
+typedef struct
+{
+    uint32_t value;
+    event_t event;
+}
+reading_t;
+
+GENERATE_FIFO( event_fifo, event_t, FIFO_LEN );
+GENERATE_FIFO( reading_fifo, reading_t, FIFO_LEN );
+
+static uint32_t pending[ EVENT(EventCount) ];
+
+void test_FIFO_COALESCE_Events(void)
+{
+    event_fifo_t fifo;
+    fifo_coalesce_t coalesce;
+
+    event_fifo_Init( &fifo );
+    FIFO_COALESCE_Init( &coalesce, &fifo, pending, EVENT(EventCount) );
+    FIFO_COALESCE_Mark( &coalesce, EVENT(Tick) );
+
+    /* A burst of ticks behind a slow machine takes a single slot */
+    for( uint32_t idx = 0; idx < 100; idx++ )
+    {
+        event_t event = ( idx % 25U == 0U ) ? EVENT(Command) : EVENT(Tick);
+        TEST_ASSERT_TRUE( FIFO_COALESCE_Post( &coalesce, &event ) );
+    }
+    TEST_ASSERT_EQUAL( 5U, event_fifo_Fill( &fifo ) );
+    TEST_ASSERT_EQUAL_UINT64( 95U, coalesce.coalesced );
+    TEST_ASSERT_TRUE( FIFO_COALESCE_IsPending( &coalesce, EVENT(Tick) ) );
+    TEST_ASSERT_FALSE( FIFO_COALESCE_IsPending( &coalesce, EVENT(Command) ) );
+
+    event_t expected[] = { EVENT(Command), EVENT(Tick), EVENT(Command), EVENT(Command), EVENT(Command) };
+    event_t event;
+    TEST_ASSERT_TRUE( FIFO_COALESCE_Take( &coalesce, &event ) );
+    TEST_ASSERT_EQUAL( expected[0], event );
+    TEST_ASSERT_TRUE( FIFO_COALESCE_Take( &coalesce, &event ) );
+    TEST_ASSERT_EQUAL( expected[1], event );
+    TEST_ASSERT_FALSE( FIFO_COALESCE_IsPending( &coalesce, EVENT(Tick) ) );
+
+    /* Once taken the next tick queues again */
+    event = EVENT(Tick);
+    TEST_ASSERT_TRUE( FIFO_COALESCE_Post( &coalesce, &event ) );
+    TEST_ASSERT_EQUAL( 4U, event_fifo_Fill( &fifo ) );
+
+    for( uint32_t idx = 2; idx < 5; idx++ )
+    {
+        TEST_ASSERT_TRUE( FIFO_COALESCE_Take( &coalesce, &event ) );
+        TEST_ASSERT_EQUAL( expected[idx], event );
+    }
+    TEST_ASSERT_TRUE( FIFO_COALESCE_Take( &coalesce, &event ) );
+    TEST_ASSERT_EQUAL( EVENT(Tick), event );
+    TEST_ASSERT_FALSE( FIFO_COALESCE_Take( &coalesce, &event ) );
+}
+
+void test_FIFO_COALESCE_ReplacePayload(void)
+{
+    reading_fifo_t fifo;
+    fifo_coalesce_t coalesce;
+
+    reading_fifo_Init( &fifo );
+    FIFO_COALESCE_InitRecords( &coalesce, &fifo, event, pending, EVENT(EventCount) );
+    FIFO_COALESCE_Mark( &coalesce, EVENT(Sensor) );
+
+    reading_t reading = { .value = 1U, .event = EVENT(Sensor) };
+    TEST_ASSERT_TRUE( FIFO_COALESCE_Post( &coalesce, &reading ) );
+    reading = (reading_t){ .value = 10U, .event = EVENT(Command) };
+    TEST_ASSERT_TRUE( FIFO_COALESCE_Post( &coalesce, &reading ) );
+    reading = (reading_t){ .value = 2U, .event = EVENT(Sensor) };
+    TEST_ASSERT_TRUE( FIFO_COALESCE_Post( &coalesce, &reading ) );
+
+    /* Latest reading, in the place of the first */
+    TEST_ASSERT_EQUAL( 2U, reading_fifo_Fill( &fifo ) );
+    TEST_ASSERT_TRUE( FIFO_COALESCE_Take( &coalesce, &reading ) );
+    TEST_ASSERT_EQUAL( EVENT(Sensor), reading.event );
+    TEST_ASSERT_EQUAL( 2U, reading.value );
+    TEST_ASSERT_TRUE( FIFO_COALESCE_Take( &coalesce, &reading ) );
+    TEST_ASSERT_EQUAL( EVENT(Command), reading.event );
+}
+
+void test_FIFO_COALESCE_Overflow(void)
+{
+    event_fifo_t fifo;
+    fifo_coalesce_t coalesce;
+
+    event_fifo_Init( &fifo );
+    FIFO_SetOverflow( &fifo.base, FIFO_OVERFLOW_DROP_OLDEST, 0 );
+    FIFO_COALESCE_Init( &coalesce, &fifo, pending, EVENT(EventCount) );
+    FIFO_COALESCE_Mark( &coalesce, EVENT(Tick) );
+
+    event_t event = EVENT(Tick);
+    TEST_ASSERT_TRUE( FIFO_COALESCE_Post( &coalesce, &event ) );
+    event = EVENT(Command);
+    for( uint32_t idx = 0; idx < FIFO_LEN; idx++ )
+    {
+        TEST_ASSERT_TRUE( FIFO_COALESCE_Post( &coalesce, &event ) );
+    }
+
+    /* The pending tick was the one dropped, so it is no longer pending */
+    TEST_ASSERT_EQUAL_UINT64( 1U, fifo.base.overflow.dropped );
+    TEST_ASSERT_FALSE( FIFO_COALESCE_IsPending( &coalesce, EVENT(Tick) ) );
+
+    event = EVENT(Tick);
+    TEST_ASSERT_TRUE( FIFO_COALESCE_Post( &coalesce, &event ) );
+    TEST_ASSERT_TRUE( FIFO_COALESCE_IsPending( &coalesce, EVENT(Tick) ) );
+    for( uint32_t idx = 0; idx < ( FIFO_LEN - 1U ); idx++ )
+    {
+        TEST_ASSERT_TRUE( FIFO_COALESCE_Take( &coalesce, &event ) );
+        TEST_ASSERT_EQUAL( EVENT(Command), event );
+    }
+    TEST_ASSERT_TRUE( FIFO_COALESCE_Take( &coalesce, &event ) );
+    TEST_ASSERT_EQUAL( EVENT(Tick), event );
+    TEST_ASSERT_FALSE( FIFO_COALESCE_IsPending( &coalesce, EVENT(Tick) ) );
+}
+
+void test_FIFO_COALESCE_OverflowMerged(void)
+{
+    event_fifo_t fifo;
+    fifo_coalesce_t coalesce;
+
+    event_fifo_Init( &fifo );
+    FIFO_SetOverflow( &fifo.base, FIFO_OVERFLOW_COALESCE, 0 );
+    FIFO_COALESCE_Init( &coalesce, &fifo, pending, EVENT(EventCount) );
+
+    /* A tick queued before it was marked, so only the FIFO's policy
+     * knows about it */
+    event_t event = EVENT(Tick);
+    TEST_ASSERT_TRUE( FIFO_COALESCE_Post( &coalesce, &event ) );
+    event = EVENT(Command);
+    for( uint32_t idx = 1; idx < FIFO_LEN; idx++ )
+    {
+        TEST_ASSERT_TRUE( FIFO_COALESCE_Post( &coalesce, &event ) );
+    }
+    FIFO_COALESCE_Mark( &coalesce, EVENT(Tick) );
+
+    /* Merged by the policy, neither lands on the last command */
+    event = EVENT(Tick);
+    TEST_ASSERT_TRUE( FIFO_COALESCE_Post( &coalesce, &event ) );
+    TEST_ASSERT_FALSE( FIFO_COALESCE_IsPending( &coalesce, EVENT(Tick) ) );
+    TEST_ASSERT_TRUE( FIFO_COALESCE_Post( &coalesce, &event ) );
+    TEST_ASSERT_EQUAL_UINT64( 2U, fifo.base.overflow.coalesced );
+    event = EVENT(Sensor);
+    TEST_ASSERT_FALSE( FIFO_COALESCE_Post( &coalesce, &event ) );
+
+    TEST_ASSERT_TRUE( FIFO_COALESCE_Take( &coalesce, &event ) );
+    TEST_ASSERT_EQUAL( EVENT(Tick), event );
+    for( uint32_t idx = 1; idx < FIFO_LEN; idx++ )
+    {
+        TEST_ASSERT_TRUE( FIFO_COALESCE_Take( &coalesce, &event ) );
+        TEST_ASSERT_EQUAL( EVENT(Command), event );
+    }
+    TEST_ASSERT_FALSE( FIFO_COALESCE_Take( &coalesce, &event ) );
+}
+
+extern void FIFOCOALESCETestSuite(void)
+{
+    RUN_TEST(test_FIFO_COALESCE_Events);
+    RUN_TEST(test_FIFO_COALESCE_ReplacePayload);
+    RUN_TEST(test_FIFO_COALESCE_Overflow);
+    RUN_TEST(test_FIFO_COALESCE_OverflowMerged);
+}
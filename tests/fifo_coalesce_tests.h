@@ -0,0 +1,6 @@
+#ifndef FIFO_COALESCE_TESTS_H
+#define FIFO_COALESCE_TESTS_H
+
+extern void FIFOCOALESCETestSuite(void);
+
+#endif /* FIFO_COALESCE_TESTS_H */
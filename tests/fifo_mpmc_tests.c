@@ -0,0 +1,206 @@
+#include "fifo_mpmc_tests.h"
+#include "fifo_mpmc.h"
+#include "unity.h"
+#include <pthread.h>
+#include <string.h>
+
+#define FIFO_LEN (8U)
+#define NUM_PRODUCERS (3U)
+#define NUM_CONSUMERS (2U)
+#define VALUES_PER_PRODUCER (20000U)
+
+typedef struct
+{
+    uint32_t producer;
+    uint32_t value;
+}
+test_value_t;
+
+typedef struct
+{
+    fifo_mpmc_base_t base;
+    FIFO_MPMC_SLOT( test_value_t ) slot[FIFO_LEN];
+}
+test_mpmc_fifo_t;
+
+typedef struct
+{
+    test_mpmc_fifo_t * fifo;
+    uint32_t id;
+    uint32_t received;
+    uint32_t out_of_order;
+    uint32_t refused;
+    uint64_t sum;
+}
+worker_t;
+
+static void test_FIFO_MPMC_Init( void )
+{
+    test_mpmc_fifo_t fifo;
+    FIFO_MPMC_Init( &fifo );
+
+    TEST_ASSERT_EQUAL( FIFO_LEN, fifo.base.max );
+    TEST_ASSERT_TRUE( FIFO_MPMC_IsEmpty( &fifo.base ) );
+    TEST_ASSERT_FALSE( FIFO_MPMC_IsFull( &fifo.base ) );
+    TEST_ASSERT_EQUAL( 0U, atomic_load( &fifo.slot[0].sequence ) );
+    TEST_ASSERT_EQUAL( FIFO_LEN - 1U, atomic_load( &fifo.slot[FIFO_LEN - 1U].sequence ) );
+
+    FIFO_MPMC_Destroy( &fifo.base );
+}
+
+static void test_FIFO_MPMC_TryEnqueueDequeue( void )
+{
+    test_mpmc_fifo_t fifo;
+    test_value_t value;
+    FIFO_MPMC_Init( &fifo );
+
+    TEST_ASSERT_FALSE( FIFO_MPMC_TryDequeue( &fifo, &value ) );
+
+    for( uint32_t idx = 0U; idx < FIFO_LEN; idx++ )
+    {
+        value.producer = 0U;
+        value.value = idx;
+        TEST_ASSERT_TRUE( FIFO_MPMC_TryEnqueue( &fifo, &value ) );
+    }
+    TEST_ASSERT_TRUE( FIFO_MPMC_IsFull( &fifo.base ) );
+    TEST_ASSERT_FALSE( FIFO_MPMC_TryEnqueue( &fifo, &value ) );
+    TEST_ASSERT_EQUAL( FIFO_LEN, FIFO_MPMC_Fill( &fifo.base ) );
+
+    /* Wrap around a few laps */
+    for( uint32_t idx = 0U; idx < ( 3U * FIFO_LEN ); idx++ )
+    {
+        TEST_ASSERT_TRUE( FIFO_MPMC_TryDequeue( &fifo, &value ) );
+        TEST_ASSERT_EQUAL( idx, value.value );
+        value.value = idx + FIFO_LEN;
+        TEST_ASSERT_TRUE( FIFO_MPMC_TryEnqueue( &fifo, &value ) );
+    }
+    TEST_ASSERT_EQUAL( FIFO_LEN, FIFO_MPMC_Fill( &fifo.base ) );
+
+    FIFO_MPMC_Destroy( &fifo.base );
+}
+
+static void test_FIFO_MPMC_Close( void )
+{
+    test_mpmc_fifo_t fifo;
+    test_value_t value = { .producer = 1U, .value = 7U };
+    FIFO_MPMC_Init( &fifo );
+
+    TEST_ASSERT_TRUE( FIFO_MPMC_Enqueue( &fifo, &value ) );
+    FIFO_MPMC_Close( &fifo.base );
+
+    /* Anything already queued can still be taken */
+    memset( &value, 0x00, sizeof( value ) );
+    TEST_ASSERT_TRUE( FIFO_MPMC_Dequeue( &fifo, &value ) );
+    TEST_ASSERT_EQUAL( 7U, value.value );
+    TEST_ASSERT_FALSE( FIFO_MPMC_Dequeue( &fifo, &value ) );
+
+    FIFO_MPMC_Open( &fifo.base );
+    TEST_ASSERT_TRUE( FIFO_MPMC_TryEnqueue( &fifo, &value ) );
+
+    FIFO_MPMC_Destroy( &fifo.base );
+}
+
+static void * Producer( void * arg )
+{
+    worker_t * worker = (worker_t *)arg;
+
+    for( uint32_t idx = 0U; idx < VALUES_PER_PRODUCER; idx++ )
+    {
+        test_value_t value = { .producer = worker->id, .value = idx };
+        if( ( idx & 1U ) == 0U )
+        {
+            if( !FIFO_MPMC_Enqueue( worker->fifo, &value ) )
+            {
+                worker->refused++;
+            }
+        }
+        else
+        {
+            while( !FIFO_MPMC_TryEnqueue( worker->fifo, &value ) )
+            {
+            }
+        }
+    }
+
+    return NULL;
+}
+
+static void * Consumer( void * arg )
+{
+    worker_t * worker = (worker_t *)arg;
+    uint32_t last[NUM_PRODUCERS];
+    bool seen[NUM_PRODUCERS] = { false };
+    test_value_t value;
+
+    while( FIFO_MPMC_Dequeue( worker->fifo, &value ) )
+    {
+        /* Values from one producer arrive in the order they were sent */
+        if( seen[value.producer] && ( value.value <= last[value.producer] ) )
+        {
+            worker->out_of_order++;
+        }
+        seen[value.producer] = true;
+        last[value.producer] = value.value;
+        worker->sum += value.value;
+        worker->received++;
+    }
+
+    return NULL;
+}
+
+static void test_FIFO_MPMC_Concurrent( void )
+{
+    static test_mpmc_fifo_t fifo;
+    worker_t producer[NUM_PRODUCERS];
+    worker_t consumer[NUM_CONSUMERS];
+    pthread_t producer_thread[NUM_PRODUCERS];
+    pthread_t consumer_thread[NUM_CONSUMERS];
+
+    FIFO_MPMC_Init( &fifo );
+    for( uint32_t idx = 0U; idx < NUM_CONSUMERS; idx++ )
+    {
+        consumer[idx] = (worker_t){ .fifo = &fifo, .id = idx };
+        pthread_create( &consumer_thread[idx], NULL, Consumer, &consumer[idx] );
+    }
+    for( uint32_t idx = 0U; idx < NUM_PRODUCERS; idx++ )
+    {
+        producer[idx] = (worker_t){ .fifo = &fifo, .id = idx };
+        pthread_create( &producer_thread[idx], NULL, Producer, &producer[idx] );
+    }
+    for( uint32_t idx = 0U; idx < NUM_PRODUCERS; idx++ )
+    {
+        pthread_join( producer_thread[idx], NULL );
+    }
+    FIFO_MPMC_Close( &fifo.base );
+    for( uint32_t idx = 0U; idx < NUM_CONSUMERS; idx++ )
+    {
+        pthread_join( consumer_thread[idx], NULL );
+    }
+
+    for( uint32_t idx = 0U; idx < NUM_PRODUCERS; idx++ )
+    {
+        TEST_ASSERT_EQUAL( 0U, producer[idx].refused );
+    }
+
+    uint32_t received = 0U;
+    uint64_t sum = 0U;
+    for( uint32_t idx = 0U; idx < NUM_CONSUMERS; idx++ )
+    {
+        TEST_ASSERT_EQUAL( 0U, consumer[idx].out_of_order );
+        received += consumer[idx].received;
+        sum += consumer[idx].sum;
+    }
+    TEST_ASSERT_EQUAL( NUM_PRODUCERS * VALUES_PER_PRODUCER, received );
+    TEST_ASSERT_EQUAL_UINT64( (uint64_t)NUM_PRODUCERS * VALUES_PER_PRODUCER * ( VALUES_PER_PRODUCER - 1U ) / 2U, sum );
+    TEST_ASSERT_TRUE( FIFO_MPMC_IsEmpty( &fifo.base ) );
+
+    FIFO_MPMC_Destroy( &fifo.base );
+}
+
+extern void FIFOMPMCTestSuite(void)
+{
+    RUN_TEST(test_FIFO_MPMC_Init);
+    RUN_TEST(test_FIFO_MPMC_TryEnqueueDequeue);
+    RUN_TEST(test_FIFO_MPMC_Close);
+    RUN_TEST(test_FIFO_MPMC_Concurrent);
+}
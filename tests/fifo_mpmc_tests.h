@@ -0,0 +1,6 @@
+#ifndef FIFO_MPMC_TESTS_H
+#define FIFO_MPMC_TESTS_H
+
+extern void FIFOMPMCTestSuite(void);
+
+#endif /* FIFO_MPMC_TESTS_H */
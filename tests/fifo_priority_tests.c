@@ -0,0 +1,217 @@
+#include "fifo_priority_tests.h"
+#include "fifo_priority.h"
+#include "fifo_static.h"
+#include "unity.h"
+
+#define FIFO_LEN (8U)
+
+#define EVENTS(EVNT) \
+    EVNT(Telemetry) \
+    EVNT(Command) \
+    EVNT(Fault) \
+
+GENERATE_EVENTS( EVENTS );
+GENERATE_FIFO( lane_fifo, event_t, FIFO_LEN );
+
+enum
+{
+    LANE_BULK,
+    LANE_NORMAL,
+    LANE_URGENT = 5,
+};
+
+static lane_fifo_t bulk, normal, urgent;
+static uint32_t faults;
+
+DEFINE_STATE(Counting);
+
+static state_ret_t State_Counting( state_t * this, event_t s )
+{
+    if( s == EVENT(Fault) )
+    {
+        faults++;
+    }
+    return ( s == EVENT(Enter) || s == EVENT(Exit) || s == EVENT(Fault) ) ? HANDLED(this) : NO_PARENT(this);
+}
+
+static void Init( fifo_priority_t * pq, uint32_t quota )
+{
+    lane_fifo_Init( &bulk );
+    lane_fifo_Init( &normal );
+    lane_fifo_Init( &urgent );
+    FIFO_PRIORITY_Init( pq );
+    FIFO_PRIORITY_AddLane( pq, LANE_BULK, &bulk, 0U );
+    FIFO_PRIORITY_AddLane( pq, LANE_NORMAL, &normal, quota );
+    FIFO_PRIORITY_AddLane( pq, LANE_URGENT, &urgent, quota );
+}
+
+void test_FIFO_PRIORITY_Order(void)
+{
+    fifo_priority_t pq;
+    Init( &pq, 0U );
+
+    event_t event;
+    TEST_ASSERT_TRUE( FIFO_PRIORITY_IsEmpty( &pq ) );
+    TEST_ASSERT_FALSE( FIFO_PRIORITY_Take( &pq, &event ) );
+
+    for( uint32_t idx = 0; idx < 4; idx++ )
+    {
+        TEST_ASSERT_TRUE( FIFO_PRIORITY_Post( &pq, LANE_BULK, EVENT(Telemetry) ) );
+    }
+    TEST_ASSERT_TRUE( FIFO_PRIORITY_Post( &pq, LANE_NORMAL, EVENT(Command) ) );
+    TEST_ASSERT_TRUE( FIFO_PRIORITY_Post( &pq, LANE_URGENT, EVENT(Fault) ) );
+    TEST_ASSERT_EQUAL( ( 1U << LANE_BULK ) | ( 1U << LANE_NORMAL ) | ( 1U << LANE_URGENT ), pq.ready );
+
+    /* The fault overtakes everything posted before it */
+    TEST_ASSERT_TRUE( FIFO_PRIORITY_Take( &pq, &event ) );
+    TEST_ASSERT_EQUAL( EVENT(Fault), event );
+    TEST_ASSERT_TRUE( FIFO_PRIORITY_Take( &pq, &event ) );
+    TEST_ASSERT_EQUAL( EVENT(Command), event );
+    TEST_ASSERT_EQUAL( ( 1U << LANE_BULK ), pq.ready );
+
+    for( uint32_t idx = 0; idx < 4; idx++ )
+    {
+        TEST_ASSERT_TRUE( FIFO_PRIORITY_Take( &pq, &event ) );
+        TEST_ASSERT_EQUAL( EVENT(Telemetry), event );
+    }
+    TEST_ASSERT_TRUE( FIFO_PRIORITY_IsEmpty( &pq ) );
+    TEST_ASSERT_EQUAL( 4U, pq.lane[LANE_BULK].dispatched );
+    TEST_ASSERT_EQUAL( 0U, pq.yields );
+}
+
+void test_FIFO_PRIORITY_Quota(void)
+{
+    fifo_priority_t pq;
+    Init( &pq, 3U );
+
+    /* Normal traffic keeps coming, but bulk still gets one in four */
+    TEST_ASSERT_TRUE( FIFO_PRIORITY_Post( &pq, LANE_BULK, EVENT(Telemetry) ) );
+    TEST_ASSERT_TRUE( FIFO_PRIORITY_Post( &pq, LANE_BULK, EVENT(Telemetry) ) );
+
+    uint32_t telemetry_at[2];
+    uint32_t telemetry = 0U;
+    for( uint32_t idx = 0; idx < 12; idx++ )
+    {
+        if( FIFO_IsEmpty( &normal.base ) )
+        {
+            TEST_ASSERT_TRUE( FIFO_PRIORITY_Post( &pq, LANE_NORMAL, EVENT(Command) ) );
+        }
+
+        event_t event;
+        TEST_ASSERT_TRUE( FIFO_PRIORITY_Take( &pq, &event ) );
+        if( event == EVENT(Telemetry) )
+        {
+            telemetry_at[telemetry++] = idx;
+        }
+    }
+
+    TEST_ASSERT_EQUAL( 2U, telemetry );
+    TEST_ASSERT_EQUAL( 3U, telemetry_at[0] );
+    TEST_ASSERT_EQUAL( 7U, telemetry_at[1] );
+    TEST_ASSERT_EQUAL( 2U, pq.yields );
+}
+
+void test_FIFO_PRIORITY_Saturated(void)
+{
+    fifo_priority_t pq;
+    Init( &pq, 4U );
+
+    /* Both lanes above bulk stay busy throughout, bulk still gets a turn
+     * once normal has had its quota of turns from urgent */
+    TEST_ASSERT_TRUE( FIFO_PRIORITY_Post( &pq, LANE_BULK, EVENT(Telemetry) ) );
+    TEST_ASSERT_TRUE( FIFO_PRIORITY_Post( &pq, LANE_BULK, EVENT(Telemetry) ) );
+
+    uint32_t telemetry_at[2];
+    uint32_t telemetry = 0U;
+    for( uint32_t idx = 0; idx < 50; idx++ )
+    {
+        if( FIFO_IsEmpty( &normal.base ) )
+        {
+            TEST_ASSERT_TRUE( FIFO_PRIORITY_Post( &pq, LANE_NORMAL, EVENT(Command) ) );
+        }
+        if( FIFO_IsEmpty( &urgent.base ) )
+        {
+            TEST_ASSERT_TRUE( FIFO_PRIORITY_Post( &pq, LANE_URGENT, EVENT(Fault) ) );
+        }
+
+        event_t event;
+        TEST_ASSERT_TRUE( FIFO_PRIORITY_Take( &pq, &event ) );
+        if( event == EVENT(Telemetry) )
+        {
+            telemetry_at[telemetry++] = idx;
+        }
+    }
+
+    TEST_ASSERT_EQUAL( 2U, telemetry );
+    TEST_ASSERT_EQUAL( 24U, telemetry_at[0] );
+    TEST_ASSERT_EQUAL( 49U, telemetry_at[1] );
+    TEST_ASSERT_EQUAL( 40U, pq.lane[LANE_URGENT].dispatched );
+    TEST_ASSERT_EQUAL( 8U, pq.lane[LANE_NORMAL].dispatched );
+    TEST_ASSERT_EQUAL( 12U, pq.yields );
+}
+
+void test_FIFO_PRIORITY_Overflow(void)
+{
+    fifo_priority_t pq;
+    Init( &pq, 0U );
+    FIFO_SetOverflow( &bulk.base, FIFO_OVERFLOW_REJECT, 0 );
+
+    for( uint32_t idx = 0; idx < FIFO_LEN; idx++ )
+    {
+        TEST_ASSERT_TRUE( FIFO_PRIORITY_Post( &pq, LANE_BULK, EVENT(Telemetry) ) );
+    }
+    TEST_ASSERT_FALSE( FIFO_PRIORITY_Post( &pq, LANE_BULK, EVENT(Telemetry) ) );
+    TEST_ASSERT_EQUAL_UINT64( 1U, bulk.base.overflow.rejected );
+
+    /* A full bulk lane does not hold up urgent events */
+    TEST_ASSERT_TRUE( FIFO_PRIORITY_Post( &pq, LANE_URGENT, EVENT(Fault) ) );
+}
+
+void test_FIFO_PRIORITY_Dispatch(void)
+{
+    fifo_priority_t pq;
+    state_t machine;
+    Init( &pq, 0U );
+    faults = 0U;
+
+    STATEMACHINE_Init( &machine, STATE( Counting ) );
+    TEST_ASSERT_FALSE( FIFO_PRIORITY_Dispatch( &pq, &machine ) );
+
+    TEST_ASSERT_TRUE( FIFO_PRIORITY_Post( &pq, LANE_BULK, EVENT(Telemetry) ) );
+    TEST_ASSERT_TRUE( FIFO_PRIORITY_Post( &pq, LANE_URGENT, EVENT(Fault) ) );
+    TEST_ASSERT_TRUE( FIFO_PRIORITY_Dispatch( &pq, &machine ) );
+    TEST_ASSERT_EQUAL( 1U, faults );
+    TEST_ASSERT_EQUAL( 1U, lane_fifo_Fill( &bulk ) );
+}
+
+void test_FIFO_PRIORITY_Flushed(void)
+{
+    fifo_priority_t pq;
+    event_t event;
+    Init( &pq, 0U );
+
+    /* A lane flushed directly leaves its ready bit behind, which is
+     * dropped rather than taken from */
+    TEST_ASSERT_TRUE( FIFO_PRIORITY_Post( &pq, LANE_BULK, EVENT(Telemetry) ) );
+    TEST_ASSERT_TRUE( FIFO_PRIORITY_Post( &pq, LANE_URGENT, EVENT(Fault) ) );
+    lane_fifo_Flush( &urgent );
+
+    TEST_ASSERT_TRUE( FIFO_PRIORITY_Take( &pq, &event ) );
+    TEST_ASSERT_EQUAL( EVENT(Telemetry), event );
+    TEST_ASSERT_EQUAL( 0U, pq.ready );
+
+    TEST_ASSERT_TRUE( FIFO_PRIORITY_Post( &pq, LANE_NORMAL, EVENT(Command) ) );
+    lane_fifo_Flush( &normal );
+    TEST_ASSERT_FALSE( FIFO_PRIORITY_Take( &pq, &event ) );
+    TEST_ASSERT_EQUAL( 0U, pq.ready );
+}
+
+extern void FIFOPRIORITYTestSuite(void)
+{
+    RUN_TEST(test_FIFO_PRIORITY_Order);
+    RUN_TEST(test_FIFO_PRIORITY_Quota);
+    RUN_TEST(test_FIFO_PRIORITY_Saturated);
+    RUN_TEST(test_FIFO_PRIORITY_Overflow);
+    RUN_TEST(test_FIFO_PRIORITY_Dispatch);
+    RUN_TEST(test_FIFO_PRIORITY_Flushed);
+}
@@ -0,0 +1,6 @@
+#ifndef FIFO_PRIORITY_TESTS_H
+#define FIFO_PRIORITY_TESTS_H
+
+extern void FIFOPRIORITYTestSuite(void);
+
+#endif /* FIFO_PRIORITY_TESTS_H */
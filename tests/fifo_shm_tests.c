@@ -0,0 +1,212 @@
+#include "fifo_shm_tests.h"
+#include "fifo_shm.h"
+#include "unity.h"
+#include <sched.h>
+#include <signal.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#define FIFO_LEN (64U)
+#define TRANSFER_LEN (100000U)
+
+typedef struct
+{
+    uint32_t id;
+    uint32_t data[5];
+}
+record_t;
+
+static char name[64];
+
+static void Name( void )
+{
+    snprintf( name, sizeof( name ), "/stateengine_fifo_shm_%d", (int)getpid() );
+    FIFO_SHM_Unlink( name );
+}
+
+void test_FIFO_SHM_CreateAttach(void)
+{
+    fifo_shm_t owner;
+    fifo_shm_t other;
+    Name();
+
+    TEST_ASSERT_EQUAL( FIFO_SHM_NOT_FOUND, FIFO_SHM_Attach( &other, name, sizeof( record_t ) ) );
+    TEST_ASSERT_EQUAL( FIFO_SHM_OK, FIFO_SHM_Create( &owner, name, FIFO_LEN, sizeof( record_t ) ) );
+    TEST_ASSERT_EQUAL( FIFO_SHM_EXISTS, FIFO_SHM_Create( &other, name, FIFO_LEN, sizeof( record_t ) ) );
+    TEST_ASSERT_EQUAL( FIFO_SHM_OK, FIFO_SHM_Attach( &other, name, sizeof( record_t ) ) );
+    TEST_ASSERT_EQUAL( FIFO_LEN, other.max );
+
+    /* Two mappings of the one ring */
+    record_t in = { .id = 7U, .data = { 1U, 2U, 3U, 4U, 5U } };
+    record_t out = { 0 };
+    for( uint32_t idx = 0; idx < FIFO_LEN; idx++ )
+    {
+        in.id = idx;
+        TEST_ASSERT_TRUE( FIFO_SHM_TryEnqueue( &owner, &in ) );
+    }
+    TEST_ASSERT_FALSE( FIFO_SHM_TryEnqueue( &owner, &in ) );
+    TEST_ASSERT_EQUAL( FIFO_LEN, FIFO_SHM_Fill( &other ) );
+
+    for( uint32_t idx = 0; idx < FIFO_LEN; idx++ )
+    {
+        TEST_ASSERT_TRUE( FIFO_SHM_TryDequeue( &other, &out ) );
+        TEST_ASSERT_EQUAL( idx, out.id );
+        TEST_ASSERT_EQUAL( 5U, out.data[4] );
+    }
+    TEST_ASSERT_FALSE( FIFO_SHM_TryDequeue( &other, &out ) );
+    TEST_ASSERT_TRUE( FIFO_SHM_IsEmpty( &owner ) );
+
+    FIFO_SHM_Detach( &other );
+    FIFO_SHM_Detach( &owner );
+    FIFO_SHM_Unlink( name );
+}
+
+void test_FIFO_SHM_RefuseBadSegment(void)
+{
+    fifo_shm_t owner;
+    fifo_shm_t other;
+    Name();
+
+    TEST_ASSERT_EQUAL( FIFO_SHM_OK, FIFO_SHM_Create( &owner, name, FIFO_LEN, sizeof( uint32_t ) ) );
+    TEST_ASSERT_EQUAL( FIFO_SHM_BAD_LAYOUT, FIFO_SHM_Attach( &other, name, sizeof( uint64_t ) ) );
+
+    owner.header->version = FIFO_SHM_VERSION + 1U;
+    TEST_ASSERT_EQUAL( FIFO_SHM_BAD_LAYOUT, FIFO_SHM_Attach( &other, name, sizeof( uint32_t ) ) );
+    owner.header->version = FIFO_SHM_VERSION;
+
+    /* As left by a creator that died before finishing */
+    atomic_store( &owner.header->state, FIFO_SHM_INITIALISING );
+    TEST_ASSERT_EQUAL( FIFO_SHM_NOT_READY, FIFO_SHM_Attach( &other, name, sizeof( uint32_t ) ) );
+    atomic_store( &owner.header->state, FIFO_SHM_READY );
+
+    TEST_ASSERT_EQUAL( FIFO_SHM_OK, FIFO_SHM_Attach( &other, name, sizeof( uint32_t ) ) );
+    FIFO_SHM_Detach( &other );
+    FIFO_SHM_Detach( &owner );
+    FIFO_SHM_Unlink( name );
+}
+
+static void Die( void )
+{
+    raise( SIGKILL );
+}
+
+static void Stop( void )
+{
+    raise( SIGSTOP );
+}
+
+/* Forks a creator that runs hook between recording itself as owner and
+ * marking the segment ready */
+static pid_t CreateHalfWay( void ( *hook )( void ) )
+{
+    pid_t child = fork();
+    if( child == 0 )
+    {
+        fifo_shm_t fifo;
+        FIFO_SHM_InitHook = hook;
+        (void)FIFO_SHM_Create( &fifo, name, FIFO_LEN, sizeof( uint32_t ) );
+        _exit( 0 );
+    }
+    return child;
+}
+
+void test_FIFO_SHM_ReclaimStale(void)
+{
+    fifo_shm_t owner;
+    fifo_shm_t other;
+    int status = -1;
+    Name();
+
+    /* A creator killed half way no longer holds the name */
+    pid_t child = CreateHalfWay( Die );
+    TEST_ASSERT_TRUE( child > 0 );
+    waitpid( child, &status, 0 );
+    TEST_ASSERT_TRUE( WIFSIGNALED( status ) );
+    TEST_ASSERT_EQUAL( SIGKILL, WTERMSIG( status ) );
+
+    TEST_ASSERT_EQUAL( FIFO_SHM_NOT_READY, FIFO_SHM_Attach( &other, name, sizeof( uint32_t ) ) );
+    TEST_ASSERT_EQUAL( FIFO_SHM_OK, FIFO_SHM_Create( &owner, name, FIFO_LEN, sizeof( uint64_t ) ) );
+    TEST_ASSERT_EQUAL( FIFO_SHM_EXISTS, FIFO_SHM_Create( &other, name, FIFO_LEN, sizeof( uint64_t ) ) );
+    TEST_ASSERT_EQUAL( FIFO_SHM_OK, FIFO_SHM_Attach( &other, name, sizeof( uint64_t ) ) );
+
+    uint64_t in = 42U;
+    uint64_t out = 0U;
+    TEST_ASSERT_TRUE( FIFO_SHM_TryEnqueue( &owner, &in ) );
+    TEST_ASSERT_TRUE( FIFO_SHM_TryDequeue( &other, &out ) );
+    TEST_ASSERT_EQUAL( 42U, out );
+    FIFO_SHM_Detach( &other );
+    FIFO_SHM_Detach( &owner );
+    FIFO_SHM_Unlink( name );
+
+    /* One that is merely slow keeps it until it dies */
+    child = CreateHalfWay( Stop );
+    TEST_ASSERT_TRUE( child > 0 );
+    waitpid( child, &status, WUNTRACED );
+    TEST_ASSERT_TRUE( WIFSTOPPED( status ) );
+
+    TEST_ASSERT_EQUAL( FIFO_SHM_EXISTS, FIFO_SHM_Create( &owner, name, FIFO_LEN, sizeof( uint32_t ) ) );
+    kill( child, SIGKILL );
+    waitpid( child, &status, 0 );
+    TEST_ASSERT_EQUAL( FIFO_SHM_OK, FIFO_SHM_Create( &owner, name, FIFO_LEN, sizeof( uint32_t ) ) );
+
+    FIFO_SHM_Detach( &owner );
+    FIFO_SHM_Unlink( name );
+}
+
+void test_FIFO_SHM_CrossProcess(void)
+{
+    fifo_shm_t fifo;
+    Name();
+
+    TEST_ASSERT_EQUAL( FIFO_SHM_OK, FIFO_SHM_Create( &fifo, name, FIFO_LEN, sizeof( uint32_t ) ) );
+
+    pid_t child = fork();
+    TEST_ASSERT_TRUE( child >= 0 );
+    if( child == 0 )
+    {
+        fifo_shm_t producer;
+        if( FIFO_SHM_Attach( &producer, name, sizeof( uint32_t ) ) != FIFO_SHM_OK )
+        {
+            _exit( 1 );
+        }
+        for( uint32_t idx = 0; idx < TRANSFER_LEN; idx++ )
+        {
+            while( !FIFO_SHM_TryEnqueue( &producer, &idx ) )
+            {
+                sched_yield();
+            }
+        }
+        FIFO_SHM_Detach( &producer );
+        _exit( 0 );
+    }
+
+    bool in_order = true;
+    for( uint32_t idx = 0; idx < TRANSFER_LEN; idx++ )
+    {
+        uint32_t value;
+        while( !FIFO_SHM_TryDequeue( &fifo, &value ) )
+        {
+            sched_yield();
+        }
+        in_order = in_order && ( value == idx );
+    }
+
+    int status = -1;
+    waitpid( child, &status, 0 );
+    TEST_ASSERT_TRUE( WIFEXITED( status ) );
+    TEST_ASSERT_EQUAL( 0, WEXITSTATUS( status ) );
+    TEST_ASSERT_TRUE( in_order );
+    TEST_ASSERT_TRUE( FIFO_SHM_IsEmpty( &fifo ) );
+
+    FIFO_SHM_Detach( &fifo );
+    FIFO_SHM_Unlink( name );
+}
+
+extern void FIFOSHMTestSuite(void)
+{
+    RUN_TEST(test_FIFO_SHM_CreateAttach);
+    RUN_TEST(test_FIFO_SHM_RefuseBadSegment);
+    RUN_TEST(test_FIFO_SHM_ReclaimStale);
+    RUN_TEST(test_FIFO_SHM_CrossProcess);
+}
@@ -0,0 +1,6 @@
+#ifndef FIFO_SHM_TESTS_H
+#define FIFO_SHM_TESTS_H
+
+extern void FIFOSHMTestSuite(void);
+
+#endif /* FIFO_SHM_TESTS_H */
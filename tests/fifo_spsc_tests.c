@@ -0,0 +1,182 @@
+#include "fifo_spsc_tests.h"
+#include "fifo_spsc.h"
+#include "unity.h"
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+
+#define FIFO_LEN (16U)
+#define TRANSFER_LEN (100000U)
+
+typedef struct
+{
+    fifo_spsc_base_t base;
+    uint32_t queue[FIFO_LEN];
+    _Alignas(FIFO_SPSC_CACHE_LINE) uint32_t in;
+    _Alignas(FIFO_SPSC_CACHE_LINE) uint32_t out;
+}
+test_spsc_fifo_t;
+
+static void Enqueue( fifo_spsc_base_t * const base );
+static void Dequeue( fifo_spsc_base_t * const base );
+static void Peek( fifo_spsc_base_t * const base );
+
+static void Init( test_spsc_fifo_t * fifo )
+{
+    static const fifo_spsc_vfunc_t vfunc =
+    {
+        .enq = Enqueue,
+        .deq = Dequeue,
+        .peek = Peek,
+    };
+    FIFO_SPSC_Init( (fifo_spsc_base_t *)fifo, FIFO_LEN );
+
+    fifo->base.vfunc = &vfunc;
+    fifo->in = 0x0;
+    fifo->out = 0x0;
+    memset(fifo->queue, 0x00, FIFO_LEN * sizeof(fifo->in));
+}
+
+static void Enqueue( fifo_spsc_base_t * const base )
+{
+    assert( base != NULL );
+    SPSC_ENQUEUE_BOILERPLATE( test_spsc_fifo_t, base );
+}
+
+static void Dequeue( fifo_spsc_base_t * const base )
+{
+    assert( base != NULL );
+    SPSC_DEQUEUE_BOILERPLATE( test_spsc_fifo_t, base );
+}
+
+static void Peek( fifo_spsc_base_t * const base )
+{
+    assert( base != NULL );
+    SPSC_PEEK_BOILERPLATE( test_spsc_fifo_t, base );
+}
+
+static void test_FIFO_SPSC_Init( void )
+{
+    test_spsc_fifo_t fifo;
+    Init( &fifo );
+
+    TEST_ASSERT_EQUAL( FIFO_LEN, fifo.base.max );
+    TEST_ASSERT_EQUAL( 0U, atomic_load( &fifo.base.write_index ) );
+    TEST_ASSERT_EQUAL( 0U, atomic_load( &fifo.base.read_index ) );
+    TEST_ASSERT_TRUE( FIFO_SPSC_IsEmpty( &fifo.base ) );
+    TEST_ASSERT_FALSE( FIFO_SPSC_IsFull( &fifo.base ) );
+
+    /* Producer and consumer state must not share a cache line */
+    TEST_ASSERT_TRUE( ( offsetof( fifo_spsc_base_t, read_index ) - offsetof( fifo_spsc_base_t, write_index ) ) >= FIFO_SPSC_CACHE_LINE );
+}
+
+static void test_FIFO_SPSC_EnqueueDequeue( void )
+{
+    test_spsc_fifo_t fifo;
+    Init( &fifo );
+
+    FIFO_SPSC_Enqueue( &fifo, 0x12 );
+    FIFO_SPSC_Enqueue( &fifo, 0x34 );
+    TEST_ASSERT_EQUAL( 2U, FIFO_SPSC_Fill( &fifo.base ) );
+    TEST_ASSERT_FALSE( FIFO_SPSC_IsEmpty( &fifo.base ) );
+
+    TEST_ASSERT_EQUAL( 0x12, FIFO_SPSC_Peek( &fifo ) );
+    TEST_ASSERT_EQUAL( 0x12, FIFO_SPSC_Dequeue( &fifo ) );
+    TEST_ASSERT_EQUAL( 0x34, FIFO_SPSC_Dequeue( &fifo ) );
+    TEST_ASSERT_TRUE( FIFO_SPSC_IsEmpty( &fifo.base ) );
+    TEST_ASSERT_EQUAL( 0U, FIFO_SPSC_Fill( &fifo.base ) );
+}
+
+static void test_FIFO_SPSC_IsFull( void )
+{
+    test_spsc_fifo_t fifo;
+    Init( &fifo );
+
+    for( uint32_t idx = 0U; idx < FIFO_LEN; idx++ )
+    {
+        TEST_ASSERT_FALSE( FIFO_SPSC_IsFull( &fifo.base ) );
+        FIFO_SPSC_Enqueue( &fifo, idx );
+    }
+    TEST_ASSERT_TRUE( FIFO_SPSC_IsFull( &fifo.base ) );
+
+    /* The producer picks up the consumer's progress once it looks full */
+    TEST_ASSERT_EQUAL( 0U, FIFO_SPSC_Dequeue( &fifo ) );
+    TEST_ASSERT_FALSE( FIFO_SPSC_IsFull( &fifo.base ) );
+}
+
+static void test_FIFO_SPSC_IndexWrap( void )
+{
+    test_spsc_fifo_t fifo;
+    Init( &fifo );
+
+    /* Start just short of the 32 bit wrap */
+    const uint32_t start = UINT32_MAX - 3U;
+    atomic_store( &fifo.base.write_index, start );
+    atomic_store( &fifo.base.read_index, start );
+    fifo.base.cached_read = start;
+    fifo.base.cached_write = start;
+
+    for( uint32_t idx = 0U; idx < FIFO_LEN; idx++ )
+    {
+        FIFO_SPSC_Enqueue( &fifo, idx );
+    }
+    TEST_ASSERT_TRUE( FIFO_SPSC_IsFull( &fifo.base ) );
+    TEST_ASSERT_EQUAL( FIFO_LEN, FIFO_SPSC_Fill( &fifo.base ) );
+
+    for( uint32_t idx = 0U; idx < FIFO_LEN; idx++ )
+    {
+        TEST_ASSERT_EQUAL( idx, FIFO_SPSC_Dequeue( &fifo ) );
+    }
+    TEST_ASSERT_TRUE( FIFO_SPSC_IsEmpty( &fifo.base ) );
+}
+
+static void * Producer( void * arg )
+{
+    test_spsc_fifo_t * fifo = (test_spsc_fifo_t *)arg;
+
+    for( uint32_t idx = 0U; idx < TRANSFER_LEN; idx++ )
+    {
+        while( FIFO_SPSC_IsFull( &fifo->base ) )
+        {
+            sched_yield();
+        }
+        FIFO_SPSC_Enqueue( fifo, idx );
+    }
+
+    return NULL;
+}
+
+static void test_FIFO_SPSC_Transfer( void )
+{
+    static test_spsc_fifo_t fifo;
+    pthread_t thread;
+    uint32_t errors = 0U;
+
+    Init( &fifo );
+    pthread_create( &thread, NULL, Producer, &fifo );
+
+    for( uint32_t idx = 0U; idx < TRANSFER_LEN; idx++ )
+    {
+        while( FIFO_SPSC_IsEmpty( &fifo.base ) )
+        {
+            sched_yield();
+        }
+        if( FIFO_SPSC_Dequeue( &fifo ) != idx )
+        {
+            errors++;
+        }
+    }
+    pthread_join( thread, NULL );
+
+    TEST_ASSERT_EQUAL( 0U, errors );
+    TEST_ASSERT_TRUE( FIFO_SPSC_IsEmpty( &fifo.base ) );
+}
+
+extern void FIFOSPSCTestSuite(void)
+{
+    RUN_TEST(test_FIFO_SPSC_Init);
+    RUN_TEST(test_FIFO_SPSC_EnqueueDequeue);
+    RUN_TEST(test_FIFO_SPSC_IsFull);
+    RUN_TEST(test_FIFO_SPSC_IndexWrap);
+    RUN_TEST(test_FIFO_SPSC_Transfer);
+}
@@ -0,0 +1,6 @@
+#ifndef FIFO_SPSC_TESTS_H
+#define FIFO_SPSC_TESTS_H
+
+extern void FIFOSPSCTestSuite(void);
+
+#endif /* FIFO_SPSC_TESTS_H */
@@ -0,0 +1,230 @@
+#include "fifo_static_tests.h"
+#include "fifo_static.h"
+#include "unity.h"
+
+#define FIFO_LEN (8U)
+
+typedef struct
+{
+    uint32_t id;
+    uint64_t data;
+}
+record_t;
+
+GENERATE_FIFO( word_fifo, uint32_t, FIFO_LEN );
+GENERATE_FIFO( record_fifo, record_t, FIFO_LEN );
+
+void test_FIFO_STATIC_Init(void)
+{
+    word_fifo_t fifo;
+    word_fifo_Init(&fifo);
+
+    TEST_ASSERT_EQUAL( FIFO_LEN, fifo.base.max );
+    TEST_ASSERT_EQUAL( 0U, word_fifo_Fill(&fifo) );
+    TEST_ASSERT_TRUE( word_fifo_IsEmpty(&fifo) );
+    TEST_ASSERT_FALSE( word_fifo_IsFull(&fifo) );
+    TEST_ASSERT_NOT_NULL( fifo.base.vfunc );
+}
+
+void test_FIFO_STATIC_PushPop(void)
+{
+    record_fifo_t fifo;
+    record_fifo_Init(&fifo);
+
+    /* Run the indices round the ring a few times */
+    for( uint32_t idx = 0; idx < ( FIFO_LEN * 3U ); idx++ )
+    {
+        record_fifo_PushUnchecked(&fifo, (record_t){ .id = idx, .data = (uint64_t)idx << 32U });
+        record_fifo_PushUnchecked(&fifo, (record_t){ .id = idx + 1000U, .data = 0U });
+        TEST_ASSERT_EQUAL( 2U, record_fifo_Fill(&fifo) );
+
+        record_t peeked = record_fifo_Peek(&fifo);
+        record_t first = record_fifo_Pop(&fifo);
+        record_t second = record_fifo_Pop(&fifo);
+
+        TEST_ASSERT_EQUAL( idx, peeked.id );
+        TEST_ASSERT_EQUAL( idx, first.id );
+        TEST_ASSERT_EQUAL_UINT64( (uint64_t)idx << 32U, first.data );
+        TEST_ASSERT_EQUAL( idx + 1000U, second.id );
+        TEST_ASSERT_TRUE( record_fifo_IsEmpty(&fifo) );
+    }
+}
+
+void test_FIFO_STATIC_Full(void)
+{
+    word_fifo_t fifo;
+    word_fifo_Init(&fifo);
+
+    for( uint32_t idx = 0; idx < FIFO_LEN; idx++ )
+    {
+        TEST_ASSERT_FALSE( word_fifo_IsFull(&fifo) );
+        word_fifo_PushUnchecked(&fifo, idx);
+    }
+    TEST_ASSERT_TRUE( word_fifo_IsFull(&fifo) );
+    TEST_ASSERT_TRUE( FIFO_IsFull(&fifo.base) );
+
+    word_fifo_Flush(&fifo);
+    TEST_ASSERT_TRUE( word_fifo_IsEmpty(&fifo) );
+    TEST_ASSERT_EQUAL( 0U, fifo.base.read_index );
+    TEST_ASSERT_EQUAL( 0U, fifo.base.write_index );
+}
+
+void test_FIFO_STATIC_BaseAdapter(void)
+{
+    word_fifo_t fifo;
+    word_fifo_Init(&fifo);
+
+    /* Direct and polymorphic calls operate on the same ring */
+    word_fifo_PushUnchecked(&fifo, 0x11U);
+    FIFO_Enqueue(&fifo, 0x22U);
+    uint32_t span[2] = { 0x33U, 0x44U };
+    TEST_ASSERT_EQUAL( 2U, FIFO_EnqueueN(&fifo, span, 2U) );
+
+    TEST_ASSERT_EQUAL( 0x11U, FIFO_Dequeue(&fifo) );
+    TEST_ASSERT_EQUAL( 0x22U, word_fifo_Pop(&fifo) );
+    TEST_ASSERT_EQUAL( 0x33U, FIFO_Peek(&fifo) );
+    TEST_ASSERT_EQUAL( 2U, FIFO_DequeueN(&fifo, span, 4U) );
+    TEST_ASSERT_EQUAL( 0x44U, span[1] );
+    TEST_ASSERT_TRUE( FIFO_IsEmpty(&fifo.base) );
+}
+
+void test_FIFO_STATIC_InPlace(void)
+{
+    record_fifo_t fifo;
+    record_fifo_Init(&fifo);
+
+    for( uint32_t idx = 0; idx < ( FIFO_LEN * 2U ); idx++ )
+    {
+        record_t * slot = record_fifo_Reserve(&fifo);
+        slot->id = idx;
+        slot->data = 0xA5A5A5A5U;
+        record_fifo_Commit(&fifo);
+
+        record_t * front = record_fifo_Front(&fifo);
+        TEST_ASSERT_EQUAL_PTR( slot, front );
+        TEST_ASSERT_EQUAL( idx, front->id );
+        record_fifo_Release(&fifo);
+        TEST_ASSERT_TRUE( record_fifo_IsEmpty(&fifo) );
+    }
+}
+
+void test_FIFO_STATIC_Overflow(void)
+{
+    word_fifo_t fifo;
+    word_fifo_Init(&fifo);
+
+    for( uint32_t idx = 0; idx < FIFO_LEN; idx++ )
+    {
+        TEST_ASSERT_TRUE( word_fifo_Post(&fifo, idx) );
+    }
+    TEST_ASSERT_EQUAL( FIFO_LEN, fifo.base.overflow.high_water );
+
+    /* Reject leaves the contents alone */
+    FIFO_SetOverflow(&fifo.base, FIFO_OVERFLOW_REJECT, 0);
+    TEST_ASSERT_FALSE( word_fifo_Post(&fifo, 100U) );
+    TEST_ASSERT_FALSE( FIFO_Enqueue(&fifo, 100U) );
+    TEST_ASSERT_EQUAL_UINT64( 2U, fifo.base.overflow.rejected );
+
+    /* Drop oldest makes room at the front */
+    FIFO_SetOverflow(&fifo.base, FIFO_OVERFLOW_DROP_OLDEST, 0);
+    TEST_ASSERT_TRUE( word_fifo_Post(&fifo, 100U) );
+    TEST_ASSERT_TRUE( FIFO_Enqueue(&fifo, 101U) );
+    TEST_ASSERT_EQUAL_UINT64( 2U, fifo.base.overflow.dropped );
+    TEST_ASSERT_EQUAL( 2U, word_fifo_Peek(&fifo) );
+
+    /* Overwrite latest replaces the newest element */
+    FIFO_SetOverflow(&fifo.base, FIFO_OVERFLOW_OVERWRITE_LATEST, 0);
+    TEST_ASSERT_TRUE( word_fifo_Post(&fifo, 102U) );
+    TEST_ASSERT_EQUAL_UINT64( 1U, fifo.base.overflow.overwritten );
+    TEST_ASSERT_TRUE( word_fifo_IsFull(&fifo) );
+
+    /* Coalesce merges duplicates of anything still queued */
+    FIFO_SetOverflow(&fifo.base, FIFO_OVERFLOW_COALESCE, 0);
+    TEST_ASSERT_TRUE( word_fifo_Post(&fifo, 5U) );
+    TEST_ASSERT_TRUE( FIFO_Enqueue(&fifo, 102U) );
+    TEST_ASSERT_FALSE( word_fifo_Post(&fifo, 0U) );
+    TEST_ASSERT_EQUAL_UINT64( 2U, fifo.base.overflow.coalesced );
+    TEST_ASSERT_EQUAL_UINT64( 3U, fifo.base.overflow.rejected );
+
+    uint32_t expected[FIFO_LEN] = { 2U, 3U, 4U, 5U, 6U, 7U, 100U, 102U };
+    for( uint32_t idx = 0; idx < FIFO_LEN; idx++ )
+    {
+        TEST_ASSERT_EQUAL( expected[idx], word_fifo_Pop(&fifo) );
+    }
+    TEST_ASSERT_EQUAL( FIFO_LEN, FIFO_GetOverflow(&fifo.base).high_water );
+}
+
+void test_FIFO_STATIC_OverflowSpan(void)
+{
+    word_fifo_t fifo;
+    word_fifo_Init(&fifo);
+
+    uint32_t values[FIFO_LEN + 4U];
+    for( uint32_t idx = 0; idx < ( FIFO_LEN + 4U ); idx++ )
+    {
+        values[idx] = idx;
+    }
+
+    /* What does not fit drops the oldest, even from the same span */
+    FIFO_SetOverflow(&fifo.base, FIFO_OVERFLOW_DROP_OLDEST, 0);
+    TEST_ASSERT_EQUAL( 6U, FIFO_EnqueueN(&fifo, values, 6U) );
+    TEST_ASSERT_EQUAL( FIFO_LEN + 4U, FIFO_EnqueueN(&fifo, values, FIFO_LEN + 4U) );
+    TEST_ASSERT_EQUAL_UINT64( 10U, fifo.base.overflow.dropped );
+    TEST_ASSERT_EQUAL_UINT64( 0U, fifo.base.overflow.rejected );
+    TEST_ASSERT_EQUAL( 4U, word_fifo_Peek(&fifo) );
+
+    /* Overwrite latest leaves the last value of the span at the back */
+    FIFO_SetOverflow(&fifo.base, FIFO_OVERFLOW_OVERWRITE_LATEST, 0);
+    TEST_ASSERT_EQUAL( 3U, FIFO_EnqueueN(&fifo, &values[8], 3U) );
+    TEST_ASSERT_EQUAL_UINT64( 3U, fifo.base.overflow.overwritten );
+
+    /* Coalesce counts merged values as accepted and rejects the rest */
+    FIFO_SetOverflow(&fifo.base, FIFO_OVERFLOW_COALESCE, 0);
+    uint32_t mixed[3] = { 5U, 100U, 10U };
+    TEST_ASSERT_EQUAL( 2U, FIFO_EnqueueN(&fifo, mixed, 3U) );
+    TEST_ASSERT_EQUAL_UINT64( 2U, fifo.base.overflow.coalesced );
+    TEST_ASSERT_EQUAL_UINT64( 1U, fifo.base.overflow.rejected );
+
+    uint32_t expected[FIFO_LEN] = { 4U, 5U, 6U, 7U, 8U, 9U, 10U, 10U };
+    for( uint32_t idx = 0; idx < FIFO_LEN; idx++ )
+    {
+        TEST_ASSERT_EQUAL( expected[idx], word_fifo_Pop(&fifo) );
+    }
+}
+
+void test_FIFO_STATIC_ReserveFull(void)
+{
+    record_fifo_t fifo;
+    record_fifo_Init(&fifo);
+    FIFO_SetOverflow(&fifo.base, FIFO_OVERFLOW_REJECT, 0);
+
+    for( uint32_t idx = 0; idx < FIFO_LEN; idx++ )
+    {
+        record_fifo_Reserve(&fifo)->id = idx;
+        record_fifo_Commit(&fifo);
+    }
+    TEST_ASSERT_NULL( record_fifo_Reserve(&fifo) );
+    TEST_ASSERT_EQUAL_UINT64( 1U, fifo.base.overflow.rejected );
+
+    /* Overwrite latest hands back the newest slot to build over */
+    FIFO_SetOverflow(&fifo.base, FIFO_OVERFLOW_OVERWRITE_LATEST, 0);
+    record_t * slot = record_fifo_Reserve(&fifo);
+    TEST_ASSERT_EQUAL_PTR( &fifo.queue[ FIFO_LEN - 1U ], slot );
+    slot->id = 100U;
+    record_fifo_Commit(&fifo);
+    TEST_ASSERT_EQUAL_UINT64( 1U, fifo.base.overflow.overwritten );
+    TEST_ASSERT_TRUE( record_fifo_IsFull(&fifo) );
+    TEST_ASSERT_EQUAL( 100U, fifo.queue[ FIFO_LEN - 1U ].id );
+}
+
+extern void FIFOSTATICTestSuite(void)
+{
+    RUN_TEST(test_FIFO_STATIC_Init);
+    RUN_TEST(test_FIFO_STATIC_PushPop);
+    RUN_TEST(test_FIFO_STATIC_Full);
+    RUN_TEST(test_FIFO_STATIC_BaseAdapter);
+    RUN_TEST(test_FIFO_STATIC_InPlace);
+    RUN_TEST(test_FIFO_STATIC_Overflow);
+    RUN_TEST(test_FIFO_STATIC_OverflowSpan);
+    RUN_TEST(test_FIFO_STATIC_ReserveFull);
+}
@@ -0,0 +1,6 @@
+#ifndef FIFO_STATIC_TESTS_H
+#define FIFO_STATIC_TESTS_H
+
+extern void FIFOSTATICTestSuite(void);
+
+#endif /* FIFO_STATIC_TESTS_H */
@@ -18,6 +18,8 @@ static void Enqueue( fifo_base_t * const fifo );
 static void Dequeue( fifo_base_t * const fifo );
 static void Flush( fifo_base_t * const fifo );
 static void Peek( fifo_base_t * const fifo );
+static uint32_t EnqueueN( fifo_base_t * const fifo, void const * const values, uint32_t count );
+static uint32_t DequeueN( fifo_base_t * const fifo, void * const values, uint32_t count );
 
 void Init( test_fifo_t * fifo )
 {
@@ -27,6 +29,8 @@ void Init( test_fifo_t * fifo )
         .deq = Dequeue,
         .flush = Flush,
         .peek = Peek,
+        .enq_n = EnqueueN,
+        .deq_n = DequeueN,
     };
     FIFO_Init( (fifo_base_t *)fifo, FIFO_LEN );
     
@@ -60,6 +64,32 @@ void Peek( fifo_base_t * const base )
     PEEK_BOILERPLATE( test_fifo_t, base );
 }
 
+uint32_t EnqueueN( fifo_base_t * const base, void const * const values, uint32_t count )
+{
+    assert(base != NULL );
+    ENQUEUE_N_BOILERPLATE( test_fifo_t, base, values, count );
+}
+
+uint32_t DequeueN( fifo_base_t * const base, void * const values, uint32_t count )
+{
+    assert(base != NULL );
+    DEQUEUE_N_BOILERPLATE( test_fifo_t, base, values, count );
+}
+
+/* Hand written vfunc without the span entries */
+void InitPlain( test_fifo_t * fifo )
+{
+    static const fifo_vfunc_t vfunc =
+    {
+        .enq = Enqueue,
+        .deq = Dequeue,
+        .flush = Flush,
+        .peek = Peek,
+    };
+    Init( fifo );
+    fifo->base.vfunc = &vfunc;
+}
+
 void test_FIFO_Init(void)
 {
     test_fifo_t fifo;
@@ -219,6 +249,204 @@ void test_FIFO_Peek(void)
     TEST_ASSERT_EQUAL( 0x12345678, fifo.queue[0U]);
 }
 
+void test_FIFO_EnqueueN(void)
+{
+    test_fifo_t fifo;
+    Init(&fifo);
+
+    uint32_t values[40];
+    for( uint32_t idx = 0; idx < 40; idx++ )
+    {
+        values[idx] = idx;
+    }
+
+    TEST_ASSERT_EQUAL( 10U, FIFO_EnqueueN(&fifo, values, 10U) );
+    TEST_ASSERT_EQUAL( 10U, fifo.base.fill );
+    TEST_ASSERT_EQUAL( 10U, fifo.base.write_index );
+
+    /* Only the remaining space is taken */
+    FIFO_SetOverflow(&fifo.base, FIFO_OVERFLOW_REJECT, 0);
+    TEST_ASSERT_EQUAL( 22U, FIFO_EnqueueN(&fifo, &values[10], 30U) );
+    TEST_ASSERT_TRUE( FIFO_IsFull(&fifo.base) );
+    TEST_ASSERT_EQUAL( 0U, fifo.base.write_index );
+    TEST_ASSERT_EQUAL( 0U, FIFO_EnqueueN(&fifo, values, 1U) );
+
+    for( uint32_t idx = 0; idx < 32; idx++ )
+    {
+        TEST_ASSERT_EQUAL( idx, fifo.queue[idx] );
+    }
+}
+
+void test_FIFO_DequeueN(void)
+{
+    test_fifo_t fifo;
+    Init(&fifo);
+
+    uint32_t out[40];
+    TEST_ASSERT_EQUAL( 0U, FIFO_DequeueN(&fifo, out, 4U) );
+
+    for( uint32_t idx = 0; idx < 5; idx++ )
+    {
+        FIFO_Enqueue(&fifo, idx);
+    }
+
+    TEST_ASSERT_EQUAL( 3U, FIFO_DequeueN(&fifo, out, 3U) );
+    TEST_ASSERT_EQUAL( 2U, fifo.base.fill );
+    TEST_ASSERT_EQUAL( 3U, fifo.base.read_index );
+
+    /* Asking for more than is queued returns what is there */
+    TEST_ASSERT_EQUAL( 2U, FIFO_DequeueN(&fifo, &out[3], 40U) );
+    TEST_ASSERT_TRUE( FIFO_IsEmpty(&fifo.base) );
+
+    for( uint32_t idx = 0; idx < 5; idx++ )
+    {
+        TEST_ASSERT_EQUAL( idx, out[idx] );
+    }
+}
+
+void test_FIFO_SpanWrap(void)
+{
+    test_fifo_t fifo;
+    Init(&fifo);
+
+    uint32_t values[32];
+    uint32_t out[32];
+    for( uint32_t idx = 0; idx < 32; idx++ )
+    {
+        values[idx] = 0x1000 + idx;
+    }
+
+    /* Move the indices close to the end of the ring */
+    TEST_ASSERT_EQUAL( 28U, FIFO_EnqueueN(&fifo, values, 28U) );
+    TEST_ASSERT_EQUAL( 28U, FIFO_DequeueN(&fifo, out, 28U) );
+
+    /* Writing 20 splits into 4 at the end and 16 at the start */
+    TEST_ASSERT_EQUAL( 20U, FIFO_EnqueueN(&fifo, values, 20U) );
+    TEST_ASSERT_EQUAL( 16U, fifo.base.write_index );
+    TEST_ASSERT_EQUAL( values[3], fifo.queue[31] );
+    TEST_ASSERT_EQUAL( values[4], fifo.queue[0] );
+
+    /* Span and single element dequeues see the same order */
+    TEST_ASSERT_EQUAL( values[0], FIFO_Dequeue(&fifo) );
+    TEST_ASSERT_EQUAL( 19U, FIFO_DequeueN(&fifo, out, 32U) );
+    TEST_ASSERT_EQUAL( 16U, fifo.base.read_index );
+    for( uint32_t idx = 0; idx < 19; idx++ )
+    {
+        TEST_ASSERT_EQUAL( values[idx + 1U], out[idx] );
+    }
+}
+
+void test_FIFO_SpanFallback(void)
+{
+    test_fifo_t fifo;
+    InitPlain(&fifo);
+
+    uint32_t values[40];
+    uint32_t out[40];
+    for( uint32_t idx = 0; idx < 40; idx++ )
+    {
+        values[idx] = idx * 3U;
+    }
+
+    /* Element at a time through in/out, wrapping and stopping when full */
+    FIFO_SetOverflow(&fifo.base, FIFO_OVERFLOW_REJECT, 0);
+    TEST_ASSERT_EQUAL( 20U, FIFO_EnqueueN(&fifo, values, 20U) );
+    TEST_ASSERT_EQUAL( 20U, FIFO_DequeueN(&fifo, out, 20U) );
+    TEST_ASSERT_EQUAL( FIFO_LEN, FIFO_EnqueueN(&fifo, values, 40U) );
+    TEST_ASSERT_EQUAL_UINT64( 8U, fifo.base.overflow.rejected );
+    TEST_ASSERT_EQUAL( FIFO_LEN, fifo.base.overflow.high_water );
+
+    TEST_ASSERT_EQUAL( FIFO_LEN, FIFO_DequeueN(&fifo, out, 40U) );
+    for( uint32_t idx = 0; idx < FIFO_LEN; idx++ )
+    {
+        TEST_ASSERT_EQUAL( values[idx], out[idx] );
+    }
+    TEST_ASSERT_EQUAL( 0U, FIFO_DequeueN(&fifo, out, 1U) );
+
+    /* The part that does not fit follows the policy on this path too */
+    FIFO_SetOverflow(&fifo.base, FIFO_OVERFLOW_DROP_OLDEST, 0);
+    TEST_ASSERT_EQUAL( 40U, FIFO_EnqueueN(&fifo, values, 40U) );
+    TEST_ASSERT_EQUAL_UINT64( 8U, fifo.base.overflow.dropped );
+    TEST_ASSERT_EQUAL( FIFO_LEN, FIFO_DequeueN(&fifo, out, 40U) );
+    for( uint32_t idx = 0; idx < FIFO_LEN; idx++ )
+    {
+        TEST_ASSERT_EQUAL( values[idx + 8U], out[idx] );
+    }
+}
+
+void test_FIFO_ReserveCommit(void)
+{
+    test_fifo_t fifo;
+    Init(&fifo);
+
+    uint32_t * slot = FIFO_Reserve(&fifo);
+    TEST_ASSERT_EQUAL_PTR( &fifo.queue[0], slot );
+    *slot = 0x12345678;
+
+    /* Not visible until committed */
+    TEST_ASSERT_TRUE( FIFO_IsEmpty(&fifo.base) );
+    FIFO_Commit(&fifo);
+
+    TEST_ASSERT_EQUAL( 1U, fifo.base.fill );
+    TEST_ASSERT_EQUAL( 1U, fifo.base.write_index );
+    TEST_ASSERT_EQUAL( 0x12345678, FIFO_Dequeue(&fifo) );
+}
+
+void test_FIFO_ReserveFull(void)
+{
+    test_fifo_t fifo;
+    Init(&fifo);
+    FIFO_SetOverflow(&fifo.base, FIFO_OVERFLOW_REJECT, 0);
+
+    for( uint32_t idx = 0; idx < FIFO_LEN; idx++ )
+    {
+        *FIFO_Reserve(&fifo) = idx;
+        FIFO_Commit(&fifo);
+    }
+    TEST_ASSERT_NULL( FIFO_Reserve(&fifo) );
+    TEST_ASSERT_EQUAL_UINT64( 1U, fifo.base.overflow.rejected );
+    TEST_ASSERT_EQUAL( FIFO_LEN, fifo.base.fill );
+
+    /* Nothing to compare against before the slot is written */
+    FIFO_SetOverflow(&fifo.base, FIFO_OVERFLOW_COALESCE, 0);
+    TEST_ASSERT_NULL( FIFO_Reserve(&fifo) );
+    TEST_ASSERT_EQUAL_UINT64( 2U, fifo.base.overflow.rejected );
+
+    FIFO_SetOverflow(&fifo.base, FIFO_OVERFLOW_DROP_OLDEST, 0);
+    uint32_t * slot = FIFO_Reserve(&fifo);
+    TEST_ASSERT_NOT_NULL( slot );
+    *slot = 100U;
+    FIFO_Commit(&fifo);
+    TEST_ASSERT_EQUAL_UINT64( 1U, fifo.base.overflow.dropped );
+    TEST_ASSERT_EQUAL( 1U, FIFO_Dequeue(&fifo) );
+}
+
+void test_FIFO_FrontRelease(void)
+{
+    test_fifo_t fifo;
+    Init(&fifo);
+
+    /* Wrap round the ring mixing in place and copying access */
+    for( uint32_t idx = 0; idx < 80; idx++ )
+    {
+        *FIFO_Reserve(&fifo) = idx;
+        FIFO_Commit(&fifo);
+        FIFO_Enqueue(&fifo, idx + 1000U);
+
+        uint32_t * front = FIFO_Front(&fifo);
+        TEST_ASSERT_EQUAL_PTR( &fifo.queue[ fifo.base.read_index ], front );
+        TEST_ASSERT_EQUAL( idx, *front );
+        TEST_ASSERT_EQUAL( 2U, fifo.base.fill );
+        FIFO_Release(&fifo);
+
+        TEST_ASSERT_EQUAL( idx + 1000U, *FIFO_Front(&fifo) );
+        FIFO_Release(&fifo);
+        TEST_ASSERT_TRUE( FIFO_IsEmpty(&fifo.base) );
+    }
+    TEST_ASSERT_EQUAL( 0U, fifo.base.read_index );
+    TEST_ASSERT_EQUAL( 0U, fifo.base.write_index );
+}
+
 extern void FIFOTestSuite(void)
 {
     RUN_TEST(test_FIFO_Init);
@@ -230,5 +458,12 @@ extern void FIFOTestSuite(void)
     RUN_TEST(test_FIFO_IsFull);
     RUN_TEST(test_FIFO_Flush);
     RUN_TEST(test_FIFO_Peek);
+    RUN_TEST(test_FIFO_EnqueueN);
+    RUN_TEST(test_FIFO_DequeueN);
+    RUN_TEST(test_FIFO_SpanWrap);
+    RUN_TEST(test_FIFO_SpanFallback);
+    RUN_TEST(test_FIFO_ReserveCommit);
+    RUN_TEST(test_FIFO_ReserveFull);
+    RUN_TEST(test_FIFO_FrontRelease);
 }
 
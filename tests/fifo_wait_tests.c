@@ -0,0 +1,203 @@
+#include "fifo_wait_tests.h"
+#include "fifo_wait.h"
+#include "fifo_static.h"
+#include "unity.h"
+#include <pthread.h>
+#include <time.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#define FIFO_LEN (16U)
+#define TRANSFER_LEN (10000U)
+
+GENERATE_FIFO( wait_fifo, uint32_t, FIFO_LEN );
+
+static wait_fifo_t fifo;
+static fifo_wait_t waitable;
+
+static void Init( void )
+{
+    wait_fifo_Init( &fifo );
+    TEST_ASSERT_TRUE( FIFO_WAIT_Init( &waitable, &fifo ) );
+}
+
+static uint64_t ElapsedMs( struct timespec const * start )
+{
+    struct timespec now;
+    clock_gettime( CLOCK_MONOTONIC, &now );
+    return (uint64_t)( ( now.tv_sec - start->tv_sec ) * 1000 + ( now.tv_nsec - start->tv_nsec ) / 1000000 );
+}
+
+static void * Producer( void * arg )
+{
+    (void)arg;
+    for( uint32_t idx = 0; idx < TRANSFER_LEN; idx++ )
+    {
+        while( !FIFO_WAIT_Post( &waitable, &idx ) )
+        {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void * DelayedWake( void * arg )
+{
+    (void)arg;
+    struct timespec delay = { .tv_sec = 0, .tv_nsec = 20000000 };
+    nanosleep( &delay, NULL );
+    FIFO_WAIT_Wake( &waitable );
+    return NULL;
+}
+
+void test_FIFO_WAIT_EdgeSignal(void)
+{
+    Init();
+
+    /* Only the post into an empty FIFO signals */
+    for( uint32_t idx = 0; idx < 10; idx++ )
+    {
+        TEST_ASSERT_TRUE( FIFO_WAIT_Post( &waitable, &idx ) );
+    }
+    TEST_ASSERT_EQUAL_UINT64( 1U, waitable.signals );
+    TEST_ASSERT_TRUE( FIFO_WAIT_Wait( &waitable, 0 ) );
+
+    uint32_t values[FIFO_LEN];
+    TEST_ASSERT_EQUAL( 10U, FIFO_WAIT_TakeN( &waitable, values, FIFO_LEN ) );
+    TEST_ASSERT_EQUAL( 9U, values[9] );
+    TEST_ASSERT_TRUE( FIFO_WAIT_IsEmpty( &waitable ) );
+
+    TEST_ASSERT_EQUAL( 3U, FIFO_WAIT_PostN( &waitable, values, 3U ) );
+    TEST_ASSERT_EQUAL_UINT64( 2U, waitable.signals );
+
+    /* Posts fail rather than overflow */
+    FIFO_SetOverflow( &fifo.base, FIFO_OVERFLOW_REJECT, 0 );
+    TEST_ASSERT_EQUAL( FIFO_LEN - 3U, FIFO_WAIT_PostN( &waitable, values, FIFO_LEN ) );
+    TEST_ASSERT_FALSE( FIFO_WAIT_Post( &waitable, values ) );
+
+    FIFO_WAIT_Destroy( &waitable );
+}
+
+void test_FIFO_WAIT_Timeout(void)
+{
+    Init();
+
+    struct timespec start;
+    clock_gettime( CLOCK_MONOTONIC, &start );
+    TEST_ASSERT_FALSE( FIFO_WAIT_Wait( &waitable, 20 ) );
+    TEST_ASSERT_GREATER_THAN( 15U, ElapsedMs( &start ) );
+
+    /* A stale signal from a drained edge does not end the wait early */
+    uint32_t value = 1U;
+    TEST_ASSERT_TRUE( FIFO_WAIT_Post( &waitable, &value ) );
+    TEST_ASSERT_TRUE( FIFO_WAIT_TryTake( &waitable, &value ) );
+    clock_gettime( CLOCK_MONOTONIC, &start );
+    TEST_ASSERT_FALSE( FIFO_WAIT_Wait( &waitable, 20 ) );
+    TEST_ASSERT_GREATER_THAN( 15U, ElapsedMs( &start ) );
+
+    FIFO_WAIT_Destroy( &waitable );
+}
+
+void test_FIFO_WAIT_Wake(void)
+{
+    pthread_t thread;
+    Init();
+
+    pthread_create( &thread, NULL, DelayedWake, NULL );
+    TEST_ASSERT_FALSE( FIFO_WAIT_Wait( &waitable, -1 ) );
+    pthread_join( thread, NULL );
+
+    FIFO_WAIT_Destroy( &waitable );
+}
+
+void test_FIFO_WAIT_Concurrent(void)
+{
+    pthread_t thread;
+    Init();
+
+    FIFO_SetOverflow( &fifo.base, FIFO_OVERFLOW_BLOCK, -1 );
+    pthread_create( &thread, NULL, Producer, NULL );
+
+    uint32_t expected = 0U;
+    while( expected < TRANSFER_LEN )
+    {
+        TEST_ASSERT_TRUE( FIFO_WAIT_Wait( &waitable, 1000 ) );
+
+        uint32_t values[FIFO_LEN];
+        uint32_t taken = FIFO_WAIT_TakeN( &waitable, values, FIFO_LEN );
+        for( uint32_t idx = 0; idx < taken; idx++ )
+        {
+            TEST_ASSERT_EQUAL( expected, values[idx] );
+            expected++;
+        }
+    }
+    pthread_join( thread, NULL );
+
+    TEST_ASSERT_TRUE( FIFO_WAIT_IsEmpty( &waitable ) );
+    TEST_ASSERT_LESS_OR_EQUAL( TRANSFER_LEN, waitable.signals );
+    TEST_ASSERT_EQUAL_UINT64( 0U, fifo.base.overflow.timeouts );
+    TEST_ASSERT_EQUAL( FIFO_LEN, fifo.base.overflow.high_water );
+    FIFO_WAIT_Destroy( &waitable );
+}
+
+void test_FIFO_WAIT_BlockTimeout(void)
+{
+    Init();
+    FIFO_SetOverflow( &fifo.base, FIFO_OVERFLOW_BLOCK, 20 );
+
+    for( uint32_t idx = 0; idx < FIFO_LEN; idx++ )
+    {
+        TEST_ASSERT_TRUE( FIFO_WAIT_Post( &waitable, &idx ) );
+    }
+
+    struct timespec start;
+    clock_gettime( CLOCK_MONOTONIC, &start );
+    uint32_t value = 0xFFU;
+    TEST_ASSERT_FALSE( FIFO_WAIT_Post( &waitable, &value ) );
+    TEST_ASSERT_GREATER_THAN( 15U, ElapsedMs( &start ) );
+
+    fifo_overflow_t overflow = FIFO_GetOverflow( &fifo.base );
+    TEST_ASSERT_EQUAL_UINT64( 1U, overflow.blocked );
+    TEST_ASSERT_EQUAL_UINT64( 1U, overflow.timeouts );
+    TEST_ASSERT_EQUAL_UINT64( 1U, overflow.rejected );
+    TEST_ASSERT_EQUAL( FIFO_LEN, overflow.high_water );
+
+    FIFO_WAIT_Destroy( &waitable );
+}
+
+void test_FIFO_WAIT_Epoll(void)
+{
+    Init();
+
+    int epfd = epoll_create1( 0 );
+    TEST_ASSERT_TRUE( epfd >= 0 );
+    struct epoll_event ev = { .events = EPOLLIN, .data.ptr = &waitable };
+    TEST_ASSERT_EQUAL( 0, epoll_ctl( epfd, EPOLL_CTL_ADD, FIFO_WAIT_Fd( &waitable ), &ev ) );
+
+    struct epoll_event ready;
+    TEST_ASSERT_EQUAL( 0, epoll_wait( epfd, &ready, 1, 0 ) );
+
+    uint32_t value = 0xA5A5A5A5U;
+    TEST_ASSERT_TRUE( FIFO_WAIT_Post( &waitable, &value ) );
+    TEST_ASSERT_EQUAL( 1, epoll_wait( epfd, &ready, 1, 100 ) );
+    TEST_ASSERT_EQUAL_PTR( &waitable, ready.data.ptr );
+
+    FIFO_WAIT_Acknowledge( &waitable );
+    value = 0U;
+    TEST_ASSERT_EQUAL( 1U, FIFO_WAIT_TakeN( &waitable, &value, 1U ) );
+    TEST_ASSERT_EQUAL( 0xA5A5A5A5U, value );
+    TEST_ASSERT_EQUAL( 0, epoll_wait( epfd, &ready, 1, 0 ) );
+
+    close( epfd );
+    FIFO_WAIT_Destroy( &waitable );
+}
+
+extern void FIFOWAITTestSuite(void)
+{
+    RUN_TEST(test_FIFO_WAIT_EdgeSignal);
+    RUN_TEST(test_FIFO_WAIT_Timeout);
+    RUN_TEST(test_FIFO_WAIT_Wake);
+    RUN_TEST(test_FIFO_WAIT_Concurrent);
+    RUN_TEST(test_FIFO_WAIT_BlockTimeout);
+    RUN_TEST(test_FIFO_WAIT_Epoll);
+}
@@ -0,0 +1,6 @@
+#ifndef FIFO_WAIT_TESTS_H
+#define FIFO_WAIT_TESTS_H
+
+extern void FIFOWAITTestSuite(void);
+
+#endif /* FIFO_WAIT_TESTS_H */
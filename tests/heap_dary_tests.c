@@ -0,0 +1,141 @@
+#include "heap_dary_tests.h"
+#include "heap_dary.h"
+#include "unity.h"
+
+#define HEAP_CAPACITY (1000U)
+
+HEAP_DARY_STORAGE( storage, HEAP_CAPACITY );
+
+static const heap_dary_backend_t backends[] =
+{
+    HEAP_DARY_SCALAR,
+    HEAP_DARY_SSE41,
+    HEAP_DARY_AVX2,
+};
+
+static uint32_t Rand( uint32_t * seed )
+{
+    *seed ^= *seed << 13U;
+    *seed ^= *seed >> 17U;
+    *seed ^= *seed << 5U;
+    return *seed;
+}
+
+static void test_HeapDary_Init(void)
+{
+    heap_dary_t heap;
+    HeapDary_Init(&heap, storage, HEAP_CAPACITY);
+
+    TEST_ASSERT_TRUE( HeapDary_IsEmpty(&heap) );
+    TEST_ASSERT_FALSE( HeapDary_IsFull(&heap) );
+    TEST_ASSERT_NOT_EQUAL( HEAP_DARY_AUTO, HeapDary_Backend() );
+}
+
+static void test_HeapDary_Scalar(void)
+{
+    TEST_ASSERT_TRUE( HeapDary_SelectBackend(HEAP_DARY_SCALAR) );
+    TEST_ASSERT_EQUAL( HEAP_DARY_SCALAR, HeapDary_Backend() );
+    TEST_ASSERT_TRUE( HeapDary_SelectBackend(HEAP_DARY_AUTO) );
+}
+
+static void test_HeapDary_Order(void)
+{
+    for( uint32_t b = 0; b < sizeof(backends) / sizeof(backends[0]); b++ )
+    {
+        if( !HeapDary_SelectBackend(backends[b]) )
+        {
+            continue;
+        }
+
+        heap_dary_t heap;
+        HeapDary_Init(&heap, storage, HEAP_CAPACITY);
+        uint32_t seed = 0x12345678U;
+
+        for( uint32_t idx = 0; idx < HEAP_CAPACITY; idx++ )
+        {
+            HeapDary_Push(&heap, Rand(&seed) % 5000U);
+        }
+        TEST_ASSERT_TRUE( HeapDary_IsFull(&heap) );
+
+        uint32_t previous = 0U;
+        for( uint32_t idx = 0; idx < HEAP_CAPACITY; idx++ )
+        {
+            uint32_t peeked = HeapDary_Peek(&heap);
+            uint32_t value = HeapDary_Pop(&heap);
+            TEST_ASSERT_EQUAL( peeked, value );
+            TEST_ASSERT_LESS_OR_EQUAL( value, previous );
+            previous = value;
+        }
+        TEST_ASSERT_TRUE( HeapDary_IsEmpty(&heap) );
+    }
+    (void)HeapDary_SelectBackend(HEAP_DARY_AUTO);
+}
+
+/* Timer-like churn, every backend must pop the same sequence */
+static void test_HeapDary_Backends(void)
+{
+    uint32_t expected[ 2 * HEAP_CAPACITY ];
+    bool first = true;
+
+    for( uint32_t b = 0; b < sizeof(backends) / sizeof(backends[0]); b++ )
+    {
+        if( !HeapDary_SelectBackend(backends[b]) )
+        {
+            continue;
+        }
+
+        heap_dary_t heap;
+        HeapDary_Init(&heap, storage, HEAP_CAPACITY);
+        uint32_t seed = 0xCAFEF00DU;
+
+        for( uint32_t idx = 0; idx < HEAP_CAPACITY / 2U; idx++ )
+        {
+            HeapDary_Push(&heap, Rand(&seed) % 100U);
+        }
+        for( uint32_t idx = 0; idx < 2 * HEAP_CAPACITY; idx++ )
+        {
+            uint32_t now = HeapDary_Pop(&heap);
+            if( first )
+            {
+                expected[idx] = now;
+            }
+            else
+            {
+                TEST_ASSERT_EQUAL( expected[idx], now );
+            }
+            HeapDary_Push(&heap, now + 1U + ( Rand(&seed) % 100U ));
+        }
+        first = false;
+    }
+    (void)HeapDary_SelectBackend(HEAP_DARY_AUTO);
+}
+
+static void test_HeapDary_Extremes(void)
+{
+    heap_dary_t heap;
+    HeapDary_Init(&heap, storage, HEAP_CAPACITY);
+
+    /* Real UINT32_MAX keys must not be mistaken for the padding */
+    HeapDary_Push(&heap, UINT32_MAX);
+    HeapDary_Push(&heap, 7U);
+    HeapDary_Push(&heap, UINT32_MAX);
+    HeapDary_Push(&heap, 0U);
+
+    TEST_ASSERT_EQUAL( 0U, HeapDary_Pop(&heap) );
+    TEST_ASSERT_EQUAL( 7U, HeapDary_Pop(&heap) );
+    TEST_ASSERT_EQUAL( UINT32_MAX, HeapDary_Pop(&heap) );
+    TEST_ASSERT_EQUAL( UINT32_MAX, HeapDary_Pop(&heap) );
+    TEST_ASSERT_TRUE( HeapDary_IsEmpty(&heap) );
+
+    HeapDary_Push(&heap, 3U);
+    TEST_ASSERT_EQUAL( 3U, HeapDary_Peek(&heap) );
+}
+
+extern void HeapDaryTestSuite(void)
+{
+    RUN_TEST(test_HeapDary_Init);
+    RUN_TEST(test_HeapDary_Scalar);
+    RUN_TEST(test_HeapDary_Order);
+    RUN_TEST(test_HeapDary_Backends);
+    RUN_TEST(test_HeapDary_Extremes);
+}
@@ -0,0 +1,6 @@
+#ifndef HEAP_DARY_TESTS_H
+#define HEAP_DARY_TESTS_H
+
+extern void HeapDaryTestSuite(void);
+
+#endif /* HEAP_DARY_TESTS_H */
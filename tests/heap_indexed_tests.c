@@ -0,0 +1,226 @@
+#include "heap_indexed_tests.h"
+#include "heap_indexed.h"
+#include "unity.h"
+
+#define HEAP_CAPACITY (64U)
+
+typedef struct
+{
+    uint32_t deadline;
+    uint32_t event;
+}
+deadline_t;
+
+#define TIMER_LESS( a, b ) ( (a)->deadline < (b)->deadline )
+
+GENERATE_INDEXED_HEAP( timers, deadline_t, HEAP_CAPACITY, TIMER_LESS );
+
+static uint32_t Rand( uint32_t * seed )
+{
+    *seed ^= *seed << 13U;
+    *seed ^= *seed >> 17U;
+    *seed ^= *seed << 5U;
+    return *seed;
+}
+
+/* Heap order holds and every slot in the heap maps back to its index */
+static void CheckHeap( timers_t const * heap )
+{
+    for( uint32_t idx = 0; idx < heap->fill; idx++ )
+    {
+        uint32_t slot = heap->heap[idx];
+        TEST_ASSERT_EQUAL( idx, heap->pos[slot] );
+        if( idx > 0U )
+        {
+            uint32_t parent = heap->heap[( idx - 1U ) >> 1U];
+            TEST_ASSERT_LESS_OR_EQUAL( heap->item[slot].deadline, heap->item[parent].deadline );
+        }
+    }
+}
+
+static void test_HeapIndexed_Init(void)
+{
+    timers_t heap;
+    timers_Init(&heap);
+
+    TEST_ASSERT_EQUAL( 0U, timers_Fill(&heap) );
+    TEST_ASSERT_TRUE( timers_IsEmpty(&heap) );
+    TEST_ASSERT_FALSE( timers_IsFull(&heap) );
+    TEST_ASSERT_FALSE( timers_Contains(&heap, 0U) );
+    TEST_ASSERT_FALSE( timers_Contains(&heap, HEAP_HANDLE_INVALID) );
+}
+
+static void test_HeapIndexed_Order(void)
+{
+    timers_t heap;
+    timers_Init(&heap);
+    uint32_t seed = 0x12345678U;
+
+    for( uint32_t idx = 0; idx < HEAP_CAPACITY; idx++ )
+    {
+        (void)timers_Push(&heap, (deadline_t){ .deadline = Rand(&seed) % 1000U, .event = idx });
+    }
+    TEST_ASSERT_TRUE( timers_IsFull(&heap) );
+    CheckHeap(&heap);
+
+    uint32_t previous = 0U;
+    for( uint32_t idx = 0; idx < HEAP_CAPACITY; idx++ )
+    {
+        deadline_t timer = timers_Pop(&heap);
+        TEST_ASSERT_LESS_OR_EQUAL( timer.deadline, previous );
+        previous = timer.deadline;
+    }
+    TEST_ASSERT_TRUE( timers_IsEmpty(&heap) );
+}
+
+static void test_HeapIndexed_Remove(void)
+{
+    timers_t heap;
+    timers_Init(&heap);
+    heap_handle_t handle[ 8 ];
+
+    for( uint32_t idx = 0; idx < 8; idx++ )
+    {
+        handle[idx] = timers_Push(&heap, (deadline_t){ .deadline = idx * 10U, .event = idx });
+    }
+
+    TEST_ASSERT_TRUE( timers_Remove(&heap, handle[0]) );
+    TEST_ASSERT_TRUE( timers_Remove(&heap, handle[5]) );
+    TEST_ASSERT_FALSE( timers_Remove(&heap, handle[5]) );
+    TEST_ASSERT_FALSE( timers_Contains(&heap, handle[0]) );
+    TEST_ASSERT_TRUE( timers_Contains(&heap, handle[1]) );
+    TEST_ASSERT_EQUAL( 6U, timers_Fill(&heap) );
+    CheckHeap(&heap);
+
+    TEST_ASSERT_EQUAL( handle[1], timers_PeekHandle(&heap) );
+    uint32_t expected[] = { 1U, 2U, 3U, 4U, 6U, 7U };
+    for( uint32_t idx = 0; idx < 6; idx++ )
+    {
+        TEST_ASSERT_EQUAL( expected[idx], timers_Pop(&heap).event );
+        TEST_ASSERT_FALSE( timers_Contains(&heap, handle[expected[idx]]) );
+    }
+}
+
+static void test_HeapIndexed_Update(void)
+{
+    timers_t heap;
+    timers_Init(&heap);
+
+    heap_handle_t a = timers_Push(&heap, (deadline_t){ .deadline = 10U, .event = 1U });
+    heap_handle_t b = timers_Push(&heap, (deadline_t){ .deadline = 20U, .event = 2U });
+    heap_handle_t c = timers_Push(&heap, (deadline_t){ .deadline = 30U, .event = 3U });
+
+    /* Decrease key moves c to the top, increase key sinks a */
+    TEST_ASSERT_TRUE( timers_Update(&heap, c, (deadline_t){ .deadline = 5U, .event = 3U }) );
+    TEST_ASSERT_EQUAL( c, timers_PeekHandle(&heap) );
+    TEST_ASSERT_TRUE( timers_Update(&heap, a, (deadline_t){ .deadline = 50U, .event = 1U }) );
+    CheckHeap(&heap);
+
+    TEST_ASSERT_EQUAL( 50U, timers_Get(&heap, a)->deadline );
+    TEST_ASSERT_EQUAL( 3U, timers_Pop(&heap).event );
+    TEST_ASSERT_EQUAL( 2U, timers_Pop(&heap).event );
+    TEST_ASSERT_EQUAL( 1U, timers_Pop(&heap).event );
+
+    TEST_ASSERT_FALSE( timers_Update(&heap, b, (deadline_t){ .deadline = 1U }) );
+    TEST_ASSERT_NULL( timers_Get(&heap, b) );
+}
+
+/* A freed slot is reused but the old handle must not reach the new element */
+static void test_HeapIndexed_Stale(void)
+{
+    timers_t heap;
+    timers_Init(&heap);
+
+    heap_handle_t old = timers_Push(&heap, (deadline_t){ .deadline = 1U, .event = 1U });
+    (void)timers_Pop(&heap);
+    heap_handle_t fresh = timers_Push(&heap, (deadline_t){ .deadline = 2U, .event = 2U });
+
+    TEST_ASSERT_NOT_EQUAL( old, fresh );
+    TEST_ASSERT_FALSE( timers_Contains(&heap, old) );
+    TEST_ASSERT_FALSE( timers_Remove(&heap, old) );
+    TEST_ASSERT_TRUE( timers_Contains(&heap, fresh) );
+    TEST_ASSERT_EQUAL( 1U, timers_Fill(&heap) );
+
+    /* Still distinct well past where a generation packed in with the slot
+     * would have wrapped round to the old handle */
+    (void)timers_Pop(&heap);
+    heap.generation[ (uint32_t)old ] = UINT32_MAX / HEAP_CAPACITY;
+    for( uint32_t idx = 0; idx < 3U; idx++ )
+    {
+        fresh = timers_Push(&heap, (deadline_t){ .deadline = 3U, .event = 3U });
+        TEST_ASSERT_EQUAL( (uint32_t)old, (uint32_t)fresh );
+        TEST_ASSERT_NOT_EQUAL( old, fresh );
+        TEST_ASSERT_FALSE( timers_Contains(&heap, old) );
+        TEST_ASSERT_NULL( timers_Get(&heap, old) );
+        TEST_ASSERT_TRUE( timers_Remove(&heap, fresh) );
+    }
+}
+
+/* Random push, remove, update and pop checked against a flat array */
+static void test_HeapIndexed_Churn(void)
+{
+    timers_t heap;
+    timers_Init(&heap);
+    uint32_t seed = 0xCAFEF00DU;
+    heap_handle_t live[ HEAP_CAPACITY ];
+    uint32_t deadline[ HEAP_CAPACITY ];
+    uint32_t count = 0U;
+
+    for( uint32_t round = 0; round < 5000; round++ )
+    {
+        uint32_t op = Rand(&seed) % 4U;
+        if( ( op == 0U ) && ( count < HEAP_CAPACITY ) )
+        {
+            deadline[count] = Rand(&seed) % 500U;
+            live[count] = timers_Push(&heap, (deadline_t){ .deadline = deadline[count] });
+            count++;
+        }
+        else if( ( op == 1U ) && ( count > 0U ) )
+        {
+            uint32_t pick = Rand(&seed) % count;
+            TEST_ASSERT_TRUE( timers_Remove(&heap, live[pick]) );
+            count--;
+            live[pick] = live[count];
+            deadline[pick] = deadline[count];
+        }
+        else if( ( op == 2U ) && ( count > 0U ) )
+        {
+            uint32_t pick = Rand(&seed) % count;
+            deadline[pick] = Rand(&seed) % 500U;
+            TEST_ASSERT_TRUE( timers_Update(&heap, live[pick], (deadline_t){ .deadline = deadline[pick] }) );
+        }
+        else if( count > 0U )
+        {
+            uint32_t min = 0U;
+            for( uint32_t idx = 1; idx < count; idx++ )
+            {
+                min = ( deadline[idx] < deadline[min] ) ? idx : min;
+            }
+            TEST_ASSERT_EQUAL( deadline[min], timers_Peek(&heap)->deadline );
+            heap_handle_t top = timers_PeekHandle(&heap);
+            (void)timers_Pop(&heap);
+            for( uint32_t idx = 0; idx < count; idx++ )
+            {
+                if( live[idx] == top )
+                {
+                    count--;
+                    live[idx] = live[count];
+                    deadline[idx] = deadline[count];
+                    break;
+                }
+            }
+        }
+        TEST_ASSERT_EQUAL( count, timers_Fill(&heap) );
+    }
+    CheckHeap(&heap);
+}
+
+extern void HeapIndexedTestSuite(void)
+{
+    RUN_TEST(test_HeapIndexed_Init);
+    RUN_TEST(test_HeapIndexed_Order);
+    RUN_TEST(test_HeapIndexed_Remove);
+    RUN_TEST(test_HeapIndexed_Update);
+    RUN_TEST(test_HeapIndexed_Stale);
+    RUN_TEST(test_HeapIndexed_Churn);
+}
@@ -0,0 +1,6 @@
+#ifndef HEAP_INDEXED_TESTS_H
+#define HEAP_INDEXED_TESTS_H
+
+extern void HeapIndexedTestSuite(void);
+
+#endif /* HEAP_INDEXED_TESTS_H */
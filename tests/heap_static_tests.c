@@ -0,0 +1,189 @@
+#include "heap_static_tests.h"
+#include "heap_static.h"
+#include "unity.h"
+
+#define HEAP_CAPACITY (100U)
+
+typedef struct
+{
+    uint64_t deadline;
+    uint32_t event;
+    uint32_t id;
+}
+deadline_t;
+
+#define KEY_LESS( a, b ) ( *(a) < *(b) )
+#define KEY_GREATER( a, b ) ( *(a) > *(b) )
+#define DEADLINE_LESS( a, b ) ( (a)->deadline < (b)->deadline )
+
+GENERATE_HEAP( key_heap, uint32_t, HEAP_CAPACITY, KEY_LESS );
+GENERATE_HEAP( max_heap, uint32_t, HEAP_CAPACITY, KEY_GREATER );
+GENERATE_HEAP( deadline_heap, deadline_t, HEAP_CAPACITY, DEADLINE_LESS );
+
+static uint32_t Rand( uint32_t * seed )
+{
+    *seed ^= *seed << 13U;
+    *seed ^= *seed >> 17U;
+    *seed ^= *seed << 5U;
+    return *seed;
+}
+
+static void test_HeapStatic_Init(void)
+{
+    key_heap_t heap;
+    key_heap_Init(&heap);
+
+    TEST_ASSERT_EQUAL( 0U, key_heap_Fill(&heap) );
+    TEST_ASSERT_TRUE( key_heap_IsEmpty(&heap) );
+    TEST_ASSERT_FALSE( key_heap_IsFull(&heap) );
+}
+
+static void test_HeapStatic_Order(void)
+{
+    key_heap_t heap;
+    key_heap_Init(&heap);
+    uint32_t seed = 0x12345678U;
+
+    for( uint32_t idx = 0; idx < HEAP_CAPACITY; idx++ )
+    {
+        key_heap_Push(&heap, Rand(&seed) % 1000U);
+    }
+    TEST_ASSERT_TRUE( key_heap_IsFull(&heap) );
+
+    uint32_t previous = 0U;
+    for( uint32_t idx = 0; idx < HEAP_CAPACITY; idx++ )
+    {
+        uint32_t peeked = *key_heap_Peek(&heap);
+        uint32_t value = key_heap_Pop(&heap);
+        TEST_ASSERT_EQUAL( peeked, value );
+        TEST_ASSERT_LESS_OR_EQUAL( value, previous );
+        previous = value;
+    }
+    TEST_ASSERT_TRUE( key_heap_IsEmpty(&heap) );
+}
+
+static void test_HeapStatic_Interleaved(void)
+{
+    key_heap_t heap;
+    key_heap_Init(&heap);
+
+    uint32_t values[] = { 5U, 3U, 8U, 1U, 9U, 2U };
+    for( uint32_t idx = 0; idx < 6; idx++ )
+    {
+        key_heap_Push(&heap, values[idx]);
+    }
+    TEST_ASSERT_EQUAL( 1U, key_heap_Pop(&heap) );
+    TEST_ASSERT_EQUAL( 2U, key_heap_Pop(&heap) );
+
+    key_heap_Push(&heap, 0U);
+    key_heap_Push(&heap, 4U);
+    TEST_ASSERT_EQUAL( 0U, key_heap_Pop(&heap) );
+    TEST_ASSERT_EQUAL( 3U, key_heap_Pop(&heap) );
+    TEST_ASSERT_EQUAL( 4U, key_heap_Pop(&heap) );
+    TEST_ASSERT_EQUAL( 5U, key_heap_Pop(&heap) );
+    TEST_ASSERT_EQUAL( 8U, key_heap_Pop(&heap) );
+    TEST_ASSERT_EQUAL( 9U, key_heap_Pop(&heap) );
+}
+
+static void test_HeapStatic_Less(void)
+{
+    max_heap_t heap;
+    max_heap_Init(&heap);
+
+    for( uint32_t idx = 0; idx < 10; idx++ )
+    {
+        max_heap_Push(&heap, idx);
+    }
+    for( uint32_t idx = 10; idx > 0; idx-- )
+    {
+        TEST_ASSERT_EQUAL( idx - 1U, max_heap_Pop(&heap) );
+    }
+}
+
+static void test_HeapStatic_Records(void)
+{
+    deadline_heap_t heap;
+    deadline_heap_Init(&heap);
+    uint32_t seed = 0xCAFEF00DU;
+
+    for( uint32_t idx = 0; idx < 50; idx++ )
+    {
+        uint64_t deadline = ( (uint64_t)Rand(&seed) << 8U ) | idx;
+        deadline_heap_Push(&heap, (deadline_t){ .deadline = deadline, .event = idx + 100U, .id = idx });
+    }
+
+    uint64_t previous = 0U;
+    for( uint32_t idx = 0; idx < 50; idx++ )
+    {
+        deadline_t timer = deadline_heap_Pop(&heap);
+        TEST_ASSERT_TRUE( timer.deadline >= previous );
+        /* Payload travels with its key */
+        TEST_ASSERT_EQUAL( timer.id, (uint32_t)( timer.deadline & 0xFFU ) );
+        TEST_ASSERT_EQUAL( timer.id + 100U, timer.event );
+        previous = timer.deadline;
+    }
+}
+
+static void test_HeapStatic_Build(void)
+{
+    key_heap_t heap;
+    key_heap_Init(&heap);
+    uint32_t seed = 0x0BADF00DU;
+    uint32_t values[ HEAP_CAPACITY ];
+
+    for( uint32_t idx = 0; idx < HEAP_CAPACITY; idx++ )
+    {
+        values[idx] = Rand(&seed) % 1000U;
+    }
+    key_heap_Build(&heap, values, HEAP_CAPACITY);
+    TEST_ASSERT_TRUE( key_heap_IsFull(&heap) );
+
+    uint32_t previous = 0U;
+    for( uint32_t idx = 0; idx < HEAP_CAPACITY; idx++ )
+    {
+        uint32_t value = key_heap_Pop(&heap);
+        TEST_ASSERT_LESS_OR_EQUAL( value, previous );
+        previous = value;
+    }
+}
+
+/* Both the heapify and the push one at a time paths of PushN */
+static void test_HeapStatic_PushN(void)
+{
+    deadline_heap_t heap;
+    deadline_heap_Init(&heap);
+    deadline_t batch[ 40 ];
+    uint32_t seed = 0x600DCAFEU;
+
+    for( uint32_t round = 0; round < 3; round++ )
+    {
+        uint32_t count = ( round == 1U ) ? 40U : 10U;
+        for( uint32_t idx = 0; idx < count; idx++ )
+        {
+            uint64_t deadline = Rand(&seed) % 1000U;
+            batch[idx] = (deadline_t){ .deadline = deadline, .event = (uint32_t)deadline, .id = idx };
+        }
+        deadline_heap_PushN(&heap, batch, count);
+    }
+    TEST_ASSERT_EQUAL( 60U, deadline_heap_Fill(&heap) );
+
+    uint64_t previous = 0U;
+    while( !deadline_heap_IsEmpty(&heap) )
+    {
+        deadline_t timer = deadline_heap_Pop(&heap);
+        TEST_ASSERT_TRUE( timer.deadline >= previous );
+        TEST_ASSERT_EQUAL( (uint32_t)timer.deadline, timer.event );
+        previous = timer.deadline;
+    }
+}
+
+extern void HeapStaticTestSuite(void)
+{
+    RUN_TEST(test_HeapStatic_Init);
+    RUN_TEST(test_HeapStatic_Order);
+    RUN_TEST(test_HeapStatic_Interleaved);
+    RUN_TEST(test_HeapStatic_Less);
+    RUN_TEST(test_HeapStatic_Records);
+    RUN_TEST(test_HeapStatic_Build);
+    RUN_TEST(test_HeapStatic_PushN);
+}
@@ -0,0 +1,6 @@
+#ifndef HEAP_STATIC_TESTS_H
+#define HEAP_STATIC_TESTS_H
+
+extern void HeapStaticTestSuite(void);
+
+#endif /* HEAP_STATIC_TESTS_H */
@@ -409,6 +409,65 @@ static void test_Heap_Scenario1(void)
     }
 }
 
+static void test_Heap_Build(void)
+{
+    heap_t heap;
+    Heap_Init(&heap);
+
+    uint32_t data[8] = {85,31,57,4,81,86,12,55};
+    uint32_t sorted[8] = {4,12,31,55,57,81,85,86};
+    Heap_Build(&heap, data, 8U);
+
+    TEST_ASSERT_EQUAL( 8U, heap.fill );
+    TEST_ASSERT_EQUAL( 4U, Heap_Peek(&heap) );
+    for( uint32_t idx = 0U; idx < 8U; idx++)
+    {
+        TEST_ASSERT_EQUAL(sorted[idx], Heap_Pop(&heap));
+    }
+    TEST_ASSERT_TRUE( Heap_IsEmpty(&heap) );
+}
+
+static void test_Heap_BuildPartial(void)
+{
+    heap_t heap;
+    Heap_Init(&heap);
+
+    uint32_t data[3] = {10U, 11U, 9U};
+    Heap_Build(&heap, data, 3U);
+
+    TEST_ASSERT_EQUAL( 3U, heap.fill );
+    TEST_ASSERT_EQUAL( 9U, heap.heap[0] );
+    TEST_ASSERT_EQUAL( UINT32_MAX, heap.heap[3] );
+
+    /* Later pushes and pops behave as if built by Heap_Push */
+    Heap_Push(&heap, 1U);
+    TEST_ASSERT_EQUAL( 1U, Heap_Pop(&heap) );
+    TEST_ASSERT_EQUAL( 9U, Heap_Pop(&heap) );
+    TEST_ASSERT_EQUAL( 10U, Heap_Pop(&heap) );
+    TEST_ASSERT_EQUAL( 11U, Heap_Pop(&heap) );
+}
+
+static void test_Heap_PushN(void)
+{
+    heap_t heap;
+    Heap_Init(&heap);
+
+    uint32_t first[2] = {5U, 3U};
+    uint32_t batch[5] = {0U, 5U, 3U, 7U, 2U};
+    uint32_t small[1] = {4U};
+    uint32_t sorted[8] = {0,2,3,3,4,5,5,7};
+
+    Heap_PushN(&heap, first, 2U);
+    Heap_PushN(&heap, batch, 5U);
+    Heap_PushN(&heap, small, 1U);
+
+    TEST_ASSERT_EQUAL( 8U, heap.fill );
+    for( uint32_t idx = 0U; idx < 8U; idx++)
+    {
+        TEST_ASSERT_EQUAL(sorted[idx], Heap_Pop(&heap));
+    }
+}
+
 extern void HeapTestSuite(void)
 {
     RUN_TEST(test_Heap_Init);
@@ -431,4 +490,7 @@ extern void HeapTestSuite(void)
     RUN_TEST(test_Heap_Pop3GL);
     RUN_TEST(test_Heap_Scenario0);
     RUN_TEST(test_Heap_Scenario1);
+    RUN_TEST(test_Heap_Build);
+    RUN_TEST(test_Heap_BuildPartial);
+    RUN_TEST(test_Heap_PushN);
 }
@@ -0,0 +1,362 @@
+#include "scheduler_tests.h"
+#include "scheduler.h"
+#include "state.h"
+#include "fifo_base.h"
+#include "unity.h"
+#include <string.h>
+
+#define EVENTS(EVNT) \
+    EVNT(TestEvent0) \
+    EVNT(TestEvent1) \
+    EVNT(Forward) \
+
+GENERATE_EVENTS( EVENTS );
+
+#define FIFO_LEN (4U)
+#define LOG_LEN (16U)
+
+typedef struct
+{
+    fifo_base_t base;
+    event_t queue[FIFO_LEN];
+    event_t in;
+    event_t out;
+}
+event_fifo_t;
+
+typedef struct
+{
+    state_t state;
+    uint32_t id;
+}
+test_machine_t;
+
+typedef struct
+{
+    uint32_t id;
+    event_t event;
+}
+log_entry_t;
+
+static log_entry_t dispatch_log[LOG_LEN];
+static uint32_t log_fill;
+
+static scheduler_t * forward_sched;
+static active_object_t * forward_ao;
+
+static void Enqueue( fifo_base_t * const fifo );
+static void Dequeue( fifo_base_t * const fifo );
+static void Flush( fifo_base_t * const fifo );
+
+DEFINE_STATE(Logging);
+
+static state_ret_t State_Logging( state_t * this, event_t s )
+{
+    state_ret_t ret;
+    test_machine_t * machine = (test_machine_t *)this;
+
+    switch( s )
+    {
+        case EVENT(Enter):
+        case EVENT(Exit):
+            ret = HANDLED(this);
+            break;
+        case EVENT(Forward):
+            (void)Scheduler_Post( forward_sched, forward_ao, EVENT(TestEvent1) );
+            /* Fallthrough */
+        case EVENT(TestEvent0):
+        case EVENT(TestEvent1):
+            assert( log_fill < LOG_LEN );
+            dispatch_log[log_fill].id = machine->id;
+            dispatch_log[log_fill].event = s;
+            log_fill++;
+            ret = HANDLED(this);
+            break;
+        default:
+            ret = NO_PARENT(this);
+            break;
+    }
+
+    return ret;
+}
+
+static void Init( event_fifo_t * fifo )
+{
+    static const fifo_vfunc_t vfunc =
+    {
+        .enq = Enqueue,
+        .deq = Dequeue,
+        .flush = Flush,
+    };
+    FIFO_Init( (fifo_base_t *)fifo, FIFO_LEN );
+    
+    fifo->base.vfunc = &vfunc;
+    fifo->in = 0x0;
+    fifo->out = 0x0;
+    memset(fifo->queue, 0x00, FIFO_LEN * sizeof(fifo->in));
+}
+
+static void Enqueue( fifo_base_t * const base )
+{
+    assert(base != NULL );
+    ENQUEUE_BOILERPLATE( event_fifo_t, base );
+}
+
+static void Dequeue( fifo_base_t * const base )
+{
+    assert(base != NULL );
+    DEQUEUE_BOILERPLATE( event_fifo_t, base );
+}
+
+static void Flush( fifo_base_t * const base )
+{
+    assert(base != NULL );
+    FLUSH_BOILERPLATE( event_fifo_t, base );
+}
+
+static void Idle( void * arg )
+{
+    uint32_t * idle_count = (uint32_t *)arg;
+    (*idle_count)++;
+}
+
+static void CreateObject( active_object_t * ao, test_machine_t * machine, event_fifo_t * fifo, uint32_t id )
+{
+    Init( fifo );
+    machine->id = id;
+    STATEMACHINE_Init( &machine->state, STATE( Logging ) );
+    ActiveObject_Init( ao, &machine->state, fifo );
+}
+
+static void test_SCHEDULER_Init( void )
+{
+    scheduler_t sched;
+    Scheduler_Init( &sched );
+
+    TEST_ASSERT_EQUAL( 0U, sched.ready );
+    TEST_ASSERT_EQUAL( NULL, sched.idle );
+    for( uint32_t idx = 0U; idx < SCHEDULER_PRIORITIES; idx++ )
+    {
+        TEST_ASSERT_EQUAL( NULL, sched.object[idx] );
+    }
+}
+
+static void test_SCHEDULER_Register( void )
+{
+    scheduler_t sched;
+    active_object_t ao;
+    test_machine_t machine;
+    event_fifo_t fifo;
+
+    Scheduler_Init( &sched );
+    CreateObject( &ao, &machine, &fifo, 0U );
+    Scheduler_Register( &sched, &ao, 5U );
+
+    TEST_ASSERT_EQUAL( &ao, sched.object[5] );
+    TEST_ASSERT_EQUAL( 5U, ao.priority );
+    TEST_ASSERT_EQUAL( &fifo.base, ao.fifo );
+    TEST_ASSERT_EQUAL( fifo.queue, ao.queue );
+    TEST_ASSERT_EQUAL( 0U, sched.ready );
+}
+
+static void test_SCHEDULER_Post( void )
+{
+    scheduler_t sched;
+    active_object_t ao;
+    test_machine_t machine;
+    event_fifo_t fifo;
+
+    Scheduler_Init( &sched );
+    CreateObject( &ao, &machine, &fifo, 0U );
+    Scheduler_Register( &sched, &ao, 3U );
+
+    TEST_ASSERT_TRUE( Scheduler_Post( &sched, &ao, EVENT(TestEvent0) ) );
+    TEST_ASSERT_EQUAL( ( 1U << 3U ), sched.ready );
+    TEST_ASSERT_EQUAL( 1U, fifo.base.fill );
+    TEST_ASSERT_EQUAL( EVENT(TestEvent0), fifo.queue[0] );
+    TEST_ASSERT_EQUAL( 1U, ao.posted );
+    TEST_ASSERT_EQUAL( 1U, ao.high_water );
+}
+
+static void test_SCHEDULER_PostFull( void )
+{
+    scheduler_t sched;
+    active_object_t ao;
+    test_machine_t machine;
+    event_fifo_t fifo;
+
+    Scheduler_Init( &sched );
+    CreateObject( &ao, &machine, &fifo, 0U );
+    FIFO_SetOverflow( &fifo.base, FIFO_OVERFLOW_REJECT, 0 );
+    Scheduler_Register( &sched, &ao, 0U );
+
+    for( uint32_t idx = 0U; idx < FIFO_LEN; idx++ )
+    {
+        TEST_ASSERT_TRUE( Scheduler_Post( &sched, &ao, EVENT(TestEvent0) ) );
+    }
+    TEST_ASSERT_FALSE( Scheduler_Post( &sched, &ao, EVENT(TestEvent1) ) );
+    
+    TEST_ASSERT_EQUAL( FIFO_LEN, ao.posted );
+    TEST_ASSERT_EQUAL( 1U, ao.dropped );
+    TEST_ASSERT_EQUAL( FIFO_LEN, ao.high_water );
+    TEST_ASSERT_EQUAL( 1U, fifo.base.overflow.rejected );
+    TEST_ASSERT_EQUAL( FIFO_LEN, fifo.base.overflow.high_water );
+
+    /* The FIFO's policy decides, here by making room */
+    FIFO_SetOverflow( &fifo.base, FIFO_OVERFLOW_DROP_OLDEST, 0 );
+    TEST_ASSERT_TRUE( Scheduler_Post( &sched, &ao, EVENT(TestEvent1) ) );
+    TEST_ASSERT_EQUAL( 1U, fifo.base.overflow.dropped );
+    TEST_ASSERT_EQUAL( EVENT(TestEvent1), fifo.queue[0] );
+}
+
+static void test_SCHEDULER_Flushed( void )
+{
+    scheduler_t sched;
+    active_object_t ao;
+    test_machine_t machine;
+    event_fifo_t fifo;
+
+    Scheduler_Init( &sched );
+    CreateObject( &ao, &machine, &fifo, 0U );
+    Scheduler_Register( &sched, &ao, 2U );
+    log_fill = 0U;
+
+    /* Emptied behind the scheduler's back, the stale ready bit is dropped
+     * without dispatching anything */
+    TEST_ASSERT_TRUE( Scheduler_Post( &sched, &ao, EVENT(TestEvent0) ) );
+    FIFO_Flush( &fifo.base );
+    TEST_ASSERT_FALSE( Scheduler_RunOnce( &sched ) );
+    TEST_ASSERT_EQUAL( 0U, sched.ready );
+    TEST_ASSERT_EQUAL( 0U, ao.dispatched );
+    TEST_ASSERT_EQUAL( 0U, log_fill );
+}
+
+static void test_SCHEDULER_Priority( void )
+{
+    scheduler_t sched;
+    active_object_t low, high;
+    test_machine_t low_machine, high_machine;
+    event_fifo_t low_fifo, high_fifo;
+    uint32_t idle_count = 0U;
+
+    log_fill = 0U;
+    Scheduler_Init( &sched );
+    Scheduler_SetIdle( &sched, Idle, &idle_count );
+    CreateObject( &low, &low_machine, &low_fifo, 1U );
+    CreateObject( &high, &high_machine, &high_fifo, 2U );
+    Scheduler_Register( &sched, &low, 1U );
+    Scheduler_Register( &sched, &high, 7U );
+
+    (void)Scheduler_Post( &sched, &low, EVENT(TestEvent0) );
+    (void)Scheduler_Post( &sched, &low, EVENT(TestEvent1) );
+    (void)Scheduler_Post( &sched, &high, EVENT(TestEvent0) );
+
+    TEST_ASSERT_TRUE( Scheduler_RunOnce( &sched ) );
+    TEST_ASSERT_EQUAL( 1U, log_fill );
+    TEST_ASSERT_EQUAL( 2U, dispatch_log[0].id );
+    TEST_ASSERT_EQUAL( ( 1U << 1U ), sched.ready );
+
+    TEST_ASSERT_TRUE( Scheduler_RunOnce( &sched ) );
+    TEST_ASSERT_TRUE( Scheduler_RunOnce( &sched ) );
+    TEST_ASSERT_EQUAL( 3U, log_fill );
+    TEST_ASSERT_EQUAL( 1U, dispatch_log[1].id );
+    TEST_ASSERT_EQUAL( EVENT(TestEvent0), dispatch_log[1].event );
+    TEST_ASSERT_EQUAL( 1U, dispatch_log[2].id );
+    TEST_ASSERT_EQUAL( EVENT(TestEvent1), dispatch_log[2].event );
+    TEST_ASSERT_EQUAL( 0U, sched.ready );
+    TEST_ASSERT_EQUAL( 0U, idle_count );
+
+    TEST_ASSERT_FALSE( Scheduler_RunOnce( &sched ) );
+    TEST_ASSERT_EQUAL( 1U, idle_count );
+
+    TEST_ASSERT_EQUAL( 2U, low.dispatched );
+    TEST_ASSERT_EQUAL( 1U, high.dispatched );
+    TEST_ASSERT_EQUAL( 2U, low.high_water );
+}
+
+static void test_SCHEDULER_PostFromHandler( void )
+{
+    scheduler_t sched;
+    active_object_t low, high;
+    test_machine_t low_machine, high_machine;
+    event_fifo_t low_fifo, high_fifo;
+
+    log_fill = 0U;
+    Scheduler_Init( &sched );
+    CreateObject( &low, &low_machine, &low_fifo, 1U );
+    CreateObject( &high, &high_machine, &high_fifo, 2U );
+    Scheduler_Register( &sched, &low, 0U );
+    Scheduler_Register( &sched, &high, 31U );
+
+    forward_sched = &sched;
+    forward_ao = &high;
+
+    /* Higher priority object runs before the low priority backlog */
+    (void)Scheduler_Post( &sched, &low, EVENT(Forward) );
+    (void)Scheduler_Post( &sched, &low, EVENT(TestEvent0) );
+
+    while( Scheduler_RunOnce( &sched ) )
+    {
+    }
+
+    TEST_ASSERT_EQUAL( 3U, log_fill );
+    TEST_ASSERT_EQUAL( 1U, dispatch_log[0].id );
+    TEST_ASSERT_EQUAL( EVENT(Forward), dispatch_log[0].event );
+    TEST_ASSERT_EQUAL( 2U, dispatch_log[1].id );
+    TEST_ASSERT_EQUAL( EVENT(TestEvent1), dispatch_log[1].event );
+    TEST_ASSERT_EQUAL( 1U, dispatch_log[2].id );
+    TEST_ASSERT_EQUAL( EVENT(TestEvent0), dispatch_log[2].event );
+}
+
+static void test_SCHEDULER_Lanes( void )
+{
+    scheduler_t sched;
+    active_object_t ao;
+    test_machine_t machine;
+    event_fifo_t bulk, urgent;
+    fifo_priority_t lanes;
+
+    log_fill = 0U;
+    Scheduler_Init( &sched );
+    Init( &bulk );
+    Init( &urgent );
+    FIFO_PRIORITY_Init( &lanes );
+    FIFO_PRIORITY_AddLane( &lanes, 0U, &bulk, 0U );
+    FIFO_PRIORITY_AddLane( &lanes, 1U, &urgent, 0U );
+
+    machine.id = 1U;
+    STATEMACHINE_Init( &machine.state, STATE( Logging ) );
+    ActiveObject_InitLanes( &ao, &machine.state, &lanes );
+    Scheduler_Register( &sched, &ao, 3U );
+
+    /* Plain posts go to the bulk lane, the urgent one overtakes them */
+    TEST_ASSERT_TRUE( Scheduler_Post( &sched, &ao, EVENT(TestEvent0) ) );
+    TEST_ASSERT_TRUE( Scheduler_Post( &sched, &ao, EVENT(TestEvent0) ) );
+    TEST_ASSERT_TRUE( Scheduler_PostLane( &sched, &ao, 1U, EVENT(TestEvent1) ) );
+    TEST_ASSERT_EQUAL( ( 1U << 3U ), sched.ready );
+    TEST_ASSERT_EQUAL( 2U, ao.high_water );
+
+    while( Scheduler_RunOnce( &sched ) )
+    {
+    }
+
+    TEST_ASSERT_EQUAL( 3U, log_fill );
+    TEST_ASSERT_EQUAL( EVENT(TestEvent1), dispatch_log[0].event );
+    TEST_ASSERT_EQUAL( EVENT(TestEvent0), dispatch_log[1].event );
+    TEST_ASSERT_EQUAL( EVENT(TestEvent0), dispatch_log[2].event );
+    TEST_ASSERT_EQUAL( 0U, sched.ready );
+    TEST_ASSERT_EQUAL( 3U, ao.posted );
+    TEST_ASSERT_EQUAL( 3U, ao.dispatched );
+}
+
+extern void SCHEDULERTestSuite(void)
+{
+    RUN_TEST(test_SCHEDULER_Init);
+    RUN_TEST(test_SCHEDULER_Register);
+    RUN_TEST(test_SCHEDULER_Post);
+    RUN_TEST(test_SCHEDULER_PostFull);
+    RUN_TEST(test_SCHEDULER_Flushed);
+    RUN_TEST(test_SCHEDULER_Priority);
+    RUN_TEST(test_SCHEDULER_PostFromHandler);
+    RUN_TEST(test_SCHEDULER_Lanes);
+}
@@ -0,0 +1,6 @@
+#ifndef SCHEDULER_TESTS_H
+#define SCHEDULER_TESTS_H
+
+extern void SCHEDULERTestSuite(void);
+
+#endif /* SCHEDULER_TESTS_H */
@@ -0,0 +1,175 @@
+#include "state_table_tests.h"
+#include "state_table.h"
+#include "unity.h"
+#include <string.h>
+
+#define EVENTS(EVNT) \
+    EVNT( Tick ) \
+    EVNT( Start ) \
+    EVNT( Stop ) \
+    EVNT( Restart ) \
+    EVNT( Fault ) \
+
+GENERATE_EVENTS( EVENTS );
+
+#define STATES(ST) \
+    ST( Idle ) \
+    ST( Running ) \
+    ST( Error ) \
+
+GENERATE_TABLE_STATES( STATES );
+
+#define LOG_LEN (16U)
+
+typedef struct
+{
+    uint32_t state;
+    event_t event;
+}
+log_entry_t;
+
+static log_entry_t action_log[LOG_LEN];
+static uint32_t log_fill;
+
+static void Log( state_table_t * this, event_t s )
+{
+    TEST_ASSERT_TRUE( log_fill < LOG_LEN );
+    action_log[log_fill].state = this->state;
+    action_log[log_fill].event = s;
+    log_fill++;
+}
+
+static void ResetLog( void )
+{
+    memset( action_log, 0x00, sizeof(action_log) );
+    log_fill = 0U;
+}
+
+#define TRANSITIONS(TR) \
+    TR( Idle,    Enter,   None,    Log ) \
+    TR( Idle,    Exit,    None,    Log ) \
+    TR( Idle,    Start,   Running, Log ) \
+    TR( Idle,    Fault,   Error,   NULL ) \
+    TR( Running, Enter,   None,    Log ) \
+    TR( Running, Exit,    None,    Log ) \
+    TR( Running, Tick,    None,    Log ) \
+    TR( Running, Restart, Running, NULL ) \
+    TR( Running, Stop,    Idle,    NULL ) \
+    TR( Running, Fault,   Error,   NULL ) \
+    TR( Error,   Enter,   Idle,    Log ) \
+    TR( Error,   Exit,    None,    Log ) \
+
+GENERATE_STATE_TABLE( table, TRANSITIONS );
+
+static void test_STATETABLE_Preprocessor( void )
+{
+    TEST_ASSERT_EQUAL( 0U, TABLE_STATE( None ) );
+    TEST_ASSERT_EQUAL( 1U, TABLE_STATE( Idle ) );
+    TEST_ASSERT_EQUAL( 3U, TABLE_STATE( Error ) );
+    TEST_ASSERT_EQUAL( 4U, TABLE_STATE( StateCount ) );
+
+    TEST_ASSERT_EQUAL( Log, table[ TABLE_STATE( Idle ) ][ EVENT( Start ) ].action );
+    TEST_ASSERT_EQUAL( TABLE_STATE( Running ), table[ TABLE_STATE( Idle ) ][ EVENT( Start ) ].next );
+    TEST_ASSERT_EQUAL( NULL, table[ TABLE_STATE( Idle ) ][ EVENT( Tick ) ].action );
+    TEST_ASSERT_EQUAL( TABLE_STATE( None ), table[ TABLE_STATE( Idle ) ][ EVENT( Tick ) ].next );
+}
+
+static void test_STATETABLE_Init( void )
+{
+    ResetLog();
+    state_table_t machine;
+    STATETABLE_Init( &machine, table, Idle );
+
+    TEST_ASSERT_EQUAL( TABLE_STATE( Idle ), machine.state );
+    TEST_ASSERT_EQUAL( EVENT( EventCount ), machine.num_events );
+    TEST_ASSERT_EQUAL( 1U, log_fill );
+    TEST_ASSERT_EQUAL( TABLE_STATE( Idle ), action_log[0].state );
+    TEST_ASSERT_EQUAL( EVENT( Enter ), action_log[0].event );
+}
+
+static void test_STATETABLE_Internal( void )
+{
+    state_table_t machine;
+    STATETABLE_Init( &machine, table, Running );
+    ResetLog();
+
+    STATETABLE_Dispatch( &machine, EVENT( Tick ) );
+    TEST_ASSERT_EQUAL( TABLE_STATE( Running ), machine.state );
+    TEST_ASSERT_EQUAL( 1U, log_fill );
+    TEST_ASSERT_EQUAL( TABLE_STATE( Running ), action_log[0].state );
+    TEST_ASSERT_EQUAL( EVENT( Tick ), action_log[0].event );
+}
+
+static void test_STATETABLE_Unhandled( void )
+{
+    state_table_t machine;
+    STATETABLE_Init( &machine, table, Idle );
+    ResetLog();
+
+    STATETABLE_Dispatch( &machine, EVENT( Tick ) );
+    TEST_ASSERT_EQUAL( TABLE_STATE( Idle ), machine.state );
+    TEST_ASSERT_EQUAL( 0U, log_fill );
+}
+
+static void test_STATETABLE_Transition( void )
+{
+    state_table_t machine;
+    STATETABLE_Init( &machine, table, Idle );
+    ResetLog();
+
+    STATETABLE_Dispatch( &machine, EVENT( Start ) );
+    TEST_ASSERT_EQUAL( TABLE_STATE( Running ), machine.state );
+    TEST_ASSERT_EQUAL( 3U, log_fill );
+    TEST_ASSERT_EQUAL( TABLE_STATE( Idle ), action_log[0].state );
+    TEST_ASSERT_EQUAL( EVENT( Start ), action_log[0].event );
+    TEST_ASSERT_EQUAL( TABLE_STATE( Idle ), action_log[1].state );
+    TEST_ASSERT_EQUAL( EVENT( Exit ), action_log[1].event );
+    TEST_ASSERT_EQUAL( TABLE_STATE( Running ), action_log[2].state );
+    TEST_ASSERT_EQUAL( EVENT( Enter ), action_log[2].event );
+}
+
+static void test_STATETABLE_TransitionIntoItself( void )
+{
+    state_table_t machine;
+    STATETABLE_Init( &machine, table, Running );
+    ResetLog();
+
+    STATETABLE_Dispatch( &machine, EVENT( Restart ) );
+    TEST_ASSERT_EQUAL( TABLE_STATE( Running ), machine.state );
+    TEST_ASSERT_EQUAL( 2U, log_fill );
+    TEST_ASSERT_EQUAL( TABLE_STATE( Running ), action_log[0].state );
+    TEST_ASSERT_EQUAL( EVENT( Exit ), action_log[0].event );
+    TEST_ASSERT_EQUAL( TABLE_STATE( Running ), action_log[1].state );
+    TEST_ASSERT_EQUAL( EVENT( Enter ), action_log[1].event );
+}
+
+static void test_STATETABLE_TransitionWhileEntering( void )
+{
+    state_table_t machine;
+    STATETABLE_Init( &machine, table, Running );
+    ResetLog();
+
+    /* Error immediately transitions back to Idle upon entry */
+    STATETABLE_Dispatch( &machine, EVENT( Fault ) );
+    TEST_ASSERT_EQUAL( TABLE_STATE( Idle ), machine.state );
+    TEST_ASSERT_EQUAL( 4U, log_fill );
+    TEST_ASSERT_EQUAL( TABLE_STATE( Running ), action_log[0].state );
+    TEST_ASSERT_EQUAL( EVENT( Exit ), action_log[0].event );
+    TEST_ASSERT_EQUAL( TABLE_STATE( Error ), action_log[1].state );
+    TEST_ASSERT_EQUAL( EVENT( Enter ), action_log[1].event );
+    TEST_ASSERT_EQUAL( TABLE_STATE( Error ), action_log[2].state );
+    TEST_ASSERT_EQUAL( EVENT( Exit ), action_log[2].event );
+    TEST_ASSERT_EQUAL( TABLE_STATE( Idle ), action_log[3].state );
+    TEST_ASSERT_EQUAL( EVENT( Enter ), action_log[3].event );
+}
+
+extern void STATETABLETestSuite(void)
+{
+    RUN_TEST( test_STATETABLE_Preprocessor );
+    RUN_TEST( test_STATETABLE_Init );
+    RUN_TEST( test_STATETABLE_Internal );
+    RUN_TEST( test_STATETABLE_Unhandled );
+    RUN_TEST( test_STATETABLE_Transition );
+    RUN_TEST( test_STATETABLE_TransitionIntoItself );
+    RUN_TEST( test_STATETABLE_TransitionWhileEntering );
+}
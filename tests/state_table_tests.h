@@ -0,0 +1,6 @@
+#ifndef STATE_TABLE_TESTS_H
+#define STATE_TABLE_TESTS_H
+
+extern void STATETABLETestSuite(void);
+
+#endif /* STATE_TABLE_TESTS_H */
@@ -2,6 +2,7 @@
 #include "state.h"
 #include "unity.h"
 #include <string.h>
+#include <pthread.h>
 
 #define EVENTS(EVNT) \
     EVNT(Tick) \
@@ -25,6 +26,23 @@ DEFINE_STATE(A1);
 DEFINE_STATE(B0);
 DEFINE_STATE(B1);
 DEFINE_STATE(C);
+DEFINE_STATE(D);
+DEFINE_STATE(E);
+DEFINE_STATE(F);
+
+#define HIERARCHY(HSM) \
+    HSM( A, Root ) \
+    HSM( B, Root ) \
+    HSM( A0, A ) \
+    HSM( A00, A0 ) \
+    HSM( A01, A0 ) \
+    HSM( A1, A ) \
+    HSM( B0, B ) \
+    HSM( B1, B ) \
+    HSM( C, Root ) \
+
+GENERATE_STATE_IDS( HIERARCHY );
+GENERATE_HIERARCHY( hierarchy, HIERARCHY );
 
 #define FIFO_LEN (32U)
 
@@ -302,6 +320,68 @@ static state_ret_t State_C( state_t * this, event_t s)
   return ret;
 }
 
+static state_ret_t State_D( state_t * this, event_t s)
+{
+  state_ret_t ret;
+
+  switch( s )
+  {
+    case EVENT(Enter):
+    case EVENT(Exit):
+      ret = HANDLED(this);
+      break;
+    case EVENT(Tick):
+      ret = TRANSITION( this, STATE(E) );
+      break;
+    default:
+      ret = NO_PARENT(this);
+      break;
+  }
+
+  return ret;
+}
+
+static state_ret_t State_E( state_t * this, event_t s)
+{
+  state_ret_t ret;
+
+  switch( s )
+  {
+    case EVENT(Enter):
+    case EVENT(Exit):
+      ret = HANDLED(this);
+      break;
+    case EVENT(Tick):
+      ret = TRANSITION( this, STATE(F) );
+      break;
+    default:
+      ret = NO_PARENT(this);
+      break;
+  }
+
+  return ret;
+}
+
+static state_ret_t State_F( state_t * this, event_t s)
+{
+  state_ret_t ret;
+
+  switch( s )
+  {
+    case EVENT(Enter):
+      ret = TRANSITION( this, STATE(A0) );
+      break;
+    case EVENT(Exit):
+      ret = HANDLED(this);
+      break;
+    default:
+      ret = NO_PARENT(this);
+      break;
+  }
+
+  return ret;
+}
+
 void setUp( void )
 {
 
@@ -742,6 +822,531 @@ static void test_STATE_TransitionWhileExiting( void )
     TEST_ASSERT_EQUAL( state.state, STATE( A0 ) );
 }
 
+static void test_STATE_FlatTransition( void )
+{
+    STATE_UnitTestInit();
+    state_t state;
+    fifo_base_t * history_base = STATE_GetHistory();
+    history_fifo_t * history = (history_fifo_t*)history_base;
+
+    state.state = STATE( D );
+
+    STATEMACHINE_Dispatch( &state, EVENT( Tick ) );
+    TEST_ASSERT_EQUAL( history->base.fill, 3U ); 
+    TEST_ASSERT_EQUAL( history->queue[0].state, STATE( D ) );
+    TEST_ASSERT_EQUAL( history->queue[1].state, STATE( D ) );
+    TEST_ASSERT_EQUAL( history->queue[2].state, STATE( E ) );
+    
+    TEST_ASSERT_EQUAL( history->queue[0].event, EVENT( Tick ) );
+    TEST_ASSERT_EQUAL( history->queue[1].event, EVENT( Exit ) );
+    TEST_ASSERT_EQUAL( history->queue[2].event, EVENT( Enter ) );
+
+    TEST_ASSERT_EQUAL( state.state, STATE( E ) );
+}
+
+static void test_STATE_FlatTransitionWhileEntering( void )
+{
+    STATE_UnitTestInit();
+    state_t state;
+    fifo_base_t * history_base = STATE_GetHistory();
+    history_fifo_t * history = (history_fifo_t*)history_base;
+
+    state.state = STATE( E );
+
+    /* F redirects into a nested state, which the fast path hands over */
+    STATEMACHINE_Dispatch( &state, EVENT( Tick ) );
+    TEST_ASSERT_EQUAL( history->base.fill, 6U ); 
+    TEST_ASSERT_EQUAL( history->queue[0].state, STATE( E ) );
+    TEST_ASSERT_EQUAL( history->queue[1].state, STATE( E ) );
+    TEST_ASSERT_EQUAL( history->queue[2].state, STATE( F ) );
+    TEST_ASSERT_EQUAL( history->queue[3].state, STATE( F ) );
+    TEST_ASSERT_EQUAL( history->queue[4].state, STATE( A ) );
+    TEST_ASSERT_EQUAL( history->queue[5].state, STATE( A0 ) );
+    
+    TEST_ASSERT_EQUAL( history->queue[0].event, EVENT( Tick ) );
+    TEST_ASSERT_EQUAL( history->queue[1].event, EVENT( Exit ) );
+    TEST_ASSERT_EQUAL( history->queue[2].event, EVENT( Enter ) );
+    TEST_ASSERT_EQUAL( history->queue[3].event, EVENT( Exit ) );
+    TEST_ASSERT_EQUAL( history->queue[4].event, EVENT( Enter ) );
+    TEST_ASSERT_EQUAL( history->queue[5].event, EVENT( Enter ) );
+
+    TEST_ASSERT_EQUAL( state.state, STATE( A0 ) );
+}
+
+static void test_STATE_FlatHierarchy( void )
+{
+    static state_node_t flat_nodes[] =
+    {
+        { .state = STATE( D ), .parent = 2U, .depth = 0U },
+        { .state = STATE( E ), .parent = 2U, .depth = 0U },
+        { .state = NULL, .parent = 2U, .depth = 0U },
+    };
+    static state_hierarchy_t flat_hierarchy = { .node = flat_nodes, .num_states = 2U, .flat = false, .valid = false };
+
+    STATE_UnitTestInit();
+    STATEMACHINE_HierarchyInit( &flat_hierarchy );
+    STATEMACHINE_HierarchyInit( &hierarchy );
+    TEST_ASSERT_TRUE( flat_hierarchy.flat );
+    TEST_ASSERT_FALSE( hierarchy.flat );
+
+    state_t state;
+    fifo_base_t * history_base = STATE_GetHistory();
+    history_fifo_t * history = (history_fifo_t*)history_base;
+
+    STATEMACHINE_Init( &state, STATE( D ) );
+    STATEMACHINE_Dispatch( &state, EVENT( Tick ) );
+
+    TEST_ASSERT_EQUAL( history->base.fill, 4U ); 
+    TEST_ASSERT_EQUAL( history->queue[2].state, STATE( D ) );
+    TEST_ASSERT_EQUAL( history->queue[2].event, EVENT( Exit ) );
+    TEST_ASSERT_EQUAL( history->queue[3].state, STATE( E ) );
+    TEST_ASSERT_EQUAL( history->queue[3].event, EVENT( Enter ) );
+    TEST_ASSERT_EQUAL( state.state, STATE( E ) );
+}
+
+static void test_STATE_HierarchyInit( void )
+{
+    STATEMACHINE_HierarchyInit( &hierarchy );
+
+    TEST_ASSERT_TRUE( hierarchy.valid );
+    TEST_ASSERT_EQUAL( 9U, hierarchy.num_states );
+    TEST_ASSERT_EQUAL( STATE_ID( Root ), hierarchy.num_states );
+
+    TEST_ASSERT_EQUAL( STATE( A0 ), hierarchy.node[ STATE_ID( A0 ) ].state );
+    TEST_ASSERT_EQUAL( STATE_ID( A ), hierarchy.node[ STATE_ID( A0 ) ].parent );
+    TEST_ASSERT_EQUAL( STATE_ID( A0 ), hierarchy.node[ STATE_ID( A01 ) ].parent );
+    TEST_ASSERT_EQUAL( STATE_ID( Root ), hierarchy.node[ STATE_ID( C ) ].parent );
+
+    TEST_ASSERT_EQUAL( 1U, hierarchy.node[ STATE_ID( A ) ].depth );
+    TEST_ASSERT_EQUAL( 1U, hierarchy.node[ STATE_ID( B ) ].depth );
+    TEST_ASSERT_EQUAL( 1U, hierarchy.node[ STATE_ID( C ) ].depth );
+    TEST_ASSERT_EQUAL( 2U, hierarchy.node[ STATE_ID( A0 ) ].depth );
+    TEST_ASSERT_EQUAL( 2U, hierarchy.node[ STATE_ID( B1 ) ].depth );
+    TEST_ASSERT_EQUAL( 3U, hierarchy.node[ STATE_ID( A00 ) ].depth );
+    TEST_ASSERT_EQUAL( 0U, hierarchy.node[ STATE_ID( Root ) ].depth );
+    TEST_ASSERT_EQUAL( NULL, hierarchy.node[ STATE_ID( Root ) ].state );
+}
+
+static void test_STATE_HierarchyInitRejects( void )
+{
+    static state_node_t out_of_range[] =
+    {
+        { .state = STATE( B0 ), .parent = 7U, .depth = 0U },
+        { .state = NULL, .parent = 1U, .depth = 0U },
+    };
+    static state_node_t cycle[] =
+    {
+        { .state = STATE( B0 ), .parent = 1U, .depth = 0U },
+        { .state = STATE( B1 ), .parent = 0U, .depth = 0U },
+        { .state = NULL, .parent = 2U, .depth = 0U },
+    };
+    static state_node_t wrong_parent[] =
+    {
+        { .state = STATE( B0 ), .parent = 1U, .depth = 0U },
+        { .state = STATE( A ), .parent = 2U, .depth = 0U },
+        { .state = NULL, .parent = 2U, .depth = 0U },
+    };
+    static state_node_t taken[] =
+    {
+        { .state = STATE( C ), .parent = 1U, .depth = 0U },
+        { .state = NULL, .parent = 1U, .depth = 0U },
+    };
+    static state_hierarchy_t bad[] =
+    {
+        { .node = out_of_range, .num_states = 1U, .valid = false },
+        { .node = cycle, .num_states = 2U, .valid = false },
+        { .node = wrong_parent, .num_states = 2U, .valid = false },
+        { .node = taken, .num_states = 1U, .valid = false },
+    };
+
+    /* C already belongs to the main table */
+    TEST_ASSERT_TRUE( STATEMACHINE_HierarchyInit( &hierarchy ) );
+
+    for( uint32_t idx = 0U; idx < ( sizeof( bad ) / sizeof( bad[ 0 ] ) ); idx++ )
+    {
+        TEST_ASSERT_FALSE( STATEMACHINE_HierarchyInit( &bad[ idx ] ) );
+        TEST_ASSERT_FALSE( bad[ idx ].valid );
+    }
+
+    /* A rejected table never takes over a registered handler */
+    TEST_ASSERT_EQUAL( &hierarchy, STATEMACHINE_GetHierarchy( STATE( C ) ) );
+    TEST_ASSERT_TRUE( STATEMACHINE_HierarchyInit( &hierarchy ) );
+    TEST_ASSERT_EQUAL( &hierarchy, STATEMACHINE_GetHierarchy( STATE( A ) ) );
+}
+
+static void test_STATE_HierarchyInitPath( void )
+{
+    STATE_UnitTestInit();
+    STATEMACHINE_HierarchyInit( &hierarchy );
+
+    state_t state;
+    fifo_base_t * history_base = STATE_GetHistory();
+    history_fifo_t * history = (history_fifo_t*)history_base;
+
+    STATEMACHINE_Init( &state, STATE( A00 ) );
+
+    TEST_ASSERT_EQUAL( &hierarchy, STATEMACHINE_GetHierarchy( state.state ) );
+    TEST_ASSERT_EQUAL( history->base.fill, 3U ); 
+    TEST_ASSERT_EQUAL( history->queue[0].state, STATE( A ) );
+    TEST_ASSERT_EQUAL( history->queue[1].state, STATE( A0 ) );
+    TEST_ASSERT_EQUAL( history->queue[2].state, STATE( A00 ) );
+    
+    TEST_ASSERT_EQUAL( history->queue[0].event, EVENT( Enter ) );
+    TEST_ASSERT_EQUAL( history->queue[1].event, EVENT( Enter ) );
+    TEST_ASSERT_EQUAL( history->queue[2].event, EVENT( Enter ) );
+    
+    TEST_ASSERT_EQUAL( state.state, STATE( A00 ) );
+}
+
+static void test_STATE_HierarchyTransitionNoSharedParent( void )
+{
+    STATEMACHINE_HierarchyInit( &hierarchy );
+    state_t state;
+    STATEMACHINE_Init( &state, STATE( A0 ) );
+
+    STATE_UnitTestInit();
+    fifo_base_t * history_base = STATE_GetHistory();
+    history_fifo_t * history = (history_fifo_t*)history_base;
+
+    STATEMACHINE_Dispatch( &state, EVENT( TransitionToB0 ) );
+    TEST_ASSERT_EQUAL( history->base.fill, 5U ); 
+    TEST_ASSERT_EQUAL( history->queue[0].state, STATE( A0 ) );
+    TEST_ASSERT_EQUAL( history->queue[1].state, STATE( A0 ) );
+    TEST_ASSERT_EQUAL( history->queue[2].state, STATE( A ) );
+    TEST_ASSERT_EQUAL( history->queue[3].state, STATE( B ) );
+    TEST_ASSERT_EQUAL( history->queue[4].state, STATE( B0 ) );
+    
+    TEST_ASSERT_EQUAL( history->queue[0].event, EVENT( TransitionToB0 ) );
+    TEST_ASSERT_EQUAL( history->queue[1].event, EVENT( Exit ) );
+    TEST_ASSERT_EQUAL( history->queue[2].event, EVENT( Exit ) );
+    TEST_ASSERT_EQUAL( history->queue[3].event, EVENT( Enter ) );
+    TEST_ASSERT_EQUAL( history->queue[4].event, EVENT( Enter ) );
+
+    TEST_ASSERT_EQUAL( state.state, STATE( B0 ) );
+    TEST_ASSERT_EQUAL( &hierarchy, STATEMACHINE_GetHierarchy( state.state ) );
+}
+
+static void test_STATE_HierarchyTransitionWhileEntering( void )
+{
+    STATEMACHINE_HierarchyInit( &hierarchy );
+    state_t state;
+    STATEMACHINE_Init( &state, STATE( A0 ) );
+
+    STATE_UnitTestInit();
+    fifo_base_t * history_base = STATE_GetHistory();
+    history_fifo_t * history = (history_fifo_t*)history_base;
+
+    STATEMACHINE_Dispatch( &state, EVENT( TransitionToB1 ) );
+    TEST_ASSERT_EQUAL( history->base.fill, 9U ); 
+    TEST_ASSERT_EQUAL( history->queue[0].state, STATE( A0 ) );
+    TEST_ASSERT_EQUAL( history->queue[1].state, STATE( A0 ) );
+    TEST_ASSERT_EQUAL( history->queue[2].state, STATE( A ) );
+    TEST_ASSERT_EQUAL( history->queue[3].state, STATE( B ) );
+    TEST_ASSERT_EQUAL( history->queue[4].state, STATE( B1 ) );
+    TEST_ASSERT_EQUAL( history->queue[5].state, STATE( B1 ) );
+    TEST_ASSERT_EQUAL( history->queue[6].state, STATE( B ) );
+    TEST_ASSERT_EQUAL( history->queue[7].state, STATE( A ) );
+    TEST_ASSERT_EQUAL( history->queue[8].state, STATE( A1 ) );
+    
+    TEST_ASSERT_EQUAL( history->queue[0].event, EVENT( TransitionToB1 ) );
+    TEST_ASSERT_EQUAL( history->queue[1].event, EVENT( Exit ) );
+    TEST_ASSERT_EQUAL( history->queue[2].event, EVENT( Exit ) );
+    TEST_ASSERT_EQUAL( history->queue[3].event, EVENT( Enter ) );
+    TEST_ASSERT_EQUAL( history->queue[4].event, EVENT( Enter ) );
+    TEST_ASSERT_EQUAL( history->queue[5].event, EVENT( Exit ) );
+    TEST_ASSERT_EQUAL( history->queue[6].event, EVENT( Exit ) );
+    TEST_ASSERT_EQUAL( history->queue[7].event, EVENT( Enter ) );
+    TEST_ASSERT_EQUAL( history->queue[8].event, EVENT( Enter ) );
+
+    TEST_ASSERT_EQUAL( state.state, STATE( A1 ) );
+}
+
+static void test_STATE_HierarchyTransitionWhileExiting( void )
+{
+    STATEMACHINE_HierarchyInit( &hierarchy );
+    state_t state;
+    STATEMACHINE_Init( &state, STATE( C ) );
+
+    STATE_UnitTestInit();
+    fifo_base_t * history_base = STATE_GetHistory();
+    history_fifo_t * history = (history_fifo_t*)history_base;
+
+    STATEMACHINE_Dispatch( &state, EVENT( TransitionToB ) );
+    TEST_ASSERT_EQUAL( history->base.fill, 4U ); 
+    TEST_ASSERT_EQUAL( history->queue[0].state, STATE( C ) );
+    TEST_ASSERT_EQUAL( history->queue[1].state, STATE( C ) );
+    TEST_ASSERT_EQUAL( history->queue[2].state, STATE( A ) );
+    TEST_ASSERT_EQUAL( history->queue[3].state, STATE( A0 ) );
+    
+    TEST_ASSERT_EQUAL( history->queue[0].event, EVENT( TransitionToB ) );
+    TEST_ASSERT_EQUAL( history->queue[1].event, EVENT( Exit ) );
+    TEST_ASSERT_EQUAL( history->queue[2].event, EVENT( Enter ) );
+    TEST_ASSERT_EQUAL( history->queue[3].event, EVENT( Enter ) );
+
+    TEST_ASSERT_EQUAL( state.state, STATE( A0 ) );
+}
+static void test_STATE_CacheInit( void )
+{
+    state_cache_t cache;
+    STATEMACHINE_CacheInit( &cache );
+
+    TEST_ASSERT_EQUAL( 0U, cache.fill );
+    TEST_ASSERT_EQUAL( 0U, cache.hits );
+    TEST_ASSERT_EQUAL( 0U, cache.misses );
+    TEST_ASSERT_EQUAL( 0U, cache.rejected );
+    for( uint32_t idx = 0U; idx < STATE_CACHE_LEN; idx++ )
+    {
+        TEST_ASSERT_EQUAL( NULL, cache.entry[idx].source );
+        TEST_ASSERT_EQUAL( NULL, cache.entry[idx].target );
+    }
+}
+
+static void test_STATE_CacheHitMiss( void )
+{
+    state_cache_t cache;
+    STATEMACHINE_CacheInit( &cache );
+
+    state_t state;
+    STATEMACHINE_Init( &state, STATE( A0 ) );
+    STATEMACHINE_SetCache( &cache );
+    TEST_ASSERT_EQUAL( &cache, STATEMACHINE_GetCache() );
+
+    STATEMACHINE_Dispatch( &state, EVENT( TransitionToB0 ) );
+    TEST_ASSERT_EQUAL( state.state, STATE( B0 ) );
+    TEST_ASSERT_EQUAL( 0U, cache.hits );
+    TEST_ASSERT_EQUAL( 1U, cache.misses );
+    TEST_ASSERT_EQUAL( 1U, cache.fill );
+
+    STATEMACHINE_Dispatch( &state, EVENT( TransitionToA0 ) );
+    TEST_ASSERT_EQUAL( state.state, STATE( A0 ) );
+    TEST_ASSERT_EQUAL( 0U, cache.hits );
+    TEST_ASSERT_EQUAL( 2U, cache.misses );
+    TEST_ASSERT_EQUAL( 2U, cache.fill );
+
+    STATE_UnitTestInit();
+    fifo_base_t * history_base = STATE_GetHistory();
+    history_fifo_t * history = (history_fifo_t*)history_base;
+
+    STATEMACHINE_Dispatch( &state, EVENT( TransitionToB0 ) );
+    TEST_ASSERT_EQUAL( 1U, cache.hits );
+    TEST_ASSERT_EQUAL( 2U, cache.misses );
+    TEST_ASSERT_EQUAL( 2U, cache.fill );
+    
+    TEST_ASSERT_EQUAL( history->base.fill, 5U ); 
+    TEST_ASSERT_EQUAL( history->queue[0].state, STATE( A0 ) );
+    TEST_ASSERT_EQUAL( history->queue[1].state, STATE( A0 ) );
+    TEST_ASSERT_EQUAL( history->queue[2].state, STATE( A ) );
+    TEST_ASSERT_EQUAL( history->queue[3].state, STATE( B ) );
+    TEST_ASSERT_EQUAL( history->queue[4].state, STATE( B0 ) );
+    
+    TEST_ASSERT_EQUAL( history->queue[0].event, EVENT( TransitionToB0 ) );
+    TEST_ASSERT_EQUAL( history->queue[1].event, EVENT( Exit ) );
+    TEST_ASSERT_EQUAL( history->queue[2].event, EVENT( Exit ) );
+    TEST_ASSERT_EQUAL( history->queue[3].event, EVENT( Enter ) );
+    TEST_ASSERT_EQUAL( history->queue[4].event, EVENT( Enter ) );
+    
+    TEST_ASSERT_EQUAL( state.state, STATE( B0 ) );
+    STATEMACHINE_SetCache( NULL );
+}
+
+static void test_STATE_CacheTransitionWhileEntering( void )
+{
+    state_cache_t cache;
+    STATEMACHINE_CacheInit( &cache );
+
+    state_t state;
+    STATEMACHINE_Init( &state, STATE( A0 ) );
+    STATEMACHINE_SetCache( &cache );
+
+    /* A0 -> B1, then B1 -> A1 upon entry */
+    STATEMACHINE_Dispatch( &state, EVENT( TransitionToB1 ) );
+    TEST_ASSERT_EQUAL( state.state, STATE( A1 ) );
+    TEST_ASSERT_EQUAL( 0U, cache.hits );
+    TEST_ASSERT_EQUAL( 2U, cache.misses );
+
+    STATEMACHINE_Dispatch( &state, EVENT( TransitionToA0 ) );
+    TEST_ASSERT_EQUAL( state.state, STATE( A0 ) );
+    TEST_ASSERT_EQUAL( 3U, cache.misses );
+
+    STATE_UnitTestInit();
+    fifo_base_t * history_base = STATE_GetHistory();
+    history_fifo_t * history = (history_fifo_t*)history_base;
+
+    STATEMACHINE_Dispatch( &state, EVENT( TransitionToB1 ) );
+    TEST_ASSERT_EQUAL( 2U, cache.hits );
+    TEST_ASSERT_EQUAL( 3U, cache.misses );
+    
+    TEST_ASSERT_EQUAL( history->base.fill, 9U ); 
+    TEST_ASSERT_EQUAL( history->queue[0].state, STATE( A0 ) );
+    TEST_ASSERT_EQUAL( history->queue[1].state, STATE( A0 ) );
+    TEST_ASSERT_EQUAL( history->queue[2].state, STATE( A ) );
+    TEST_ASSERT_EQUAL( history->queue[3].state, STATE( B ) );
+    TEST_ASSERT_EQUAL( history->queue[4].state, STATE( B1 ) );
+    TEST_ASSERT_EQUAL( history->queue[5].state, STATE( B1 ) );
+    TEST_ASSERT_EQUAL( history->queue[6].state, STATE( B ) );
+    TEST_ASSERT_EQUAL( history->queue[7].state, STATE( A ) );
+    TEST_ASSERT_EQUAL( history->queue[8].state, STATE( A1 ) );
+
+    TEST_ASSERT_EQUAL( state.state, STATE( A1 ) );
+    STATEMACHINE_SetCache( NULL );
+}
+
+typedef struct
+{
+    state_cache_t cache;
+    uint32_t rounds;
+    bool installed;
+}
+cache_worker_t;
+
+static void * CacheWorker( void * arg )
+{
+    cache_worker_t * const worker = (cache_worker_t *)arg;
+    state_t state;
+
+    worker->installed = ( STATEMACHINE_GetCache() == NULL );
+    STATEMACHINE_CacheInit( &worker->cache );
+    STATEMACHINE_SetCache( &worker->cache );
+    STATEMACHINE_Init( &state, STATE( A0 ) );
+
+    for( uint32_t idx = 0U; idx < worker->rounds; idx++ )
+    {
+        STATEMACHINE_Dispatch( &state, EVENT( TransitionToB0 ) );
+        STATEMACHINE_Dispatch( &state, EVENT( TransitionToA0 ) );
+    }
+    return NULL;
+}
+
+/* Each thread only ever sees its own cache, so counters stay exact */
+static void test_STATE_CachePerThread( void )
+{
+    cache_worker_t worker[ 2 ] = { { .rounds = 1000U }, { .rounds = 500U } };
+    pthread_t thread[ 2 ];
+
+    for( uint32_t idx = 0U; idx < 2U; idx++ )
+    {
+        TEST_ASSERT_EQUAL( 0, pthread_create( &thread[ idx ], NULL, CacheWorker, &worker[ idx ] ) );
+    }
+    for( uint32_t idx = 0U; idx < 2U; idx++ )
+    {
+        TEST_ASSERT_EQUAL( 0, pthread_join( thread[ idx ], NULL ) );
+        TEST_ASSERT_TRUE( worker[ idx ].installed );
+        TEST_ASSERT_EQUAL( 2U, worker[ idx ].cache.misses );
+        TEST_ASSERT_EQUAL( ( 2U * worker[ idx ].rounds ) - 2U, worker[ idx ].cache.hits );
+        TEST_ASSERT_EQUAL( 2U, worker[ idx ].cache.fill );
+    }
+    TEST_ASSERT_EQUAL( NULL, STATEMACHINE_GetCache() );
+}
+
+static bool StopInStateB( state_t const * const state, event_t s, void * arg )
+{
+    (void)s;
+    uint32_t * calls = (uint32_t *)arg;
+    (*calls)++;
+    return ( state->state == STATE( B ) );
+}
+
+static void test_STATE_DispatchBatch( void )
+{
+    event_fifo_t events;
+    Init( &events );
+
+    state_t state;
+    STATEMACHINE_Init( &state, STATE( A ) );
+
+    FIFO_Enqueue( &events, EVENT( Tick ) );
+    FIFO_Enqueue( &events, EVENT( TransitionToB ) );
+    FIFO_Enqueue( &events, EVENT( TransitionToA0 ) );
+    FIFO_Enqueue( &events, EVENT( TransitionToA1 ) );
+
+    uint32_t consumed = STATEMACHINE_DispatchBatch( &state, &events, 3U, NULL, NULL );
+    TEST_ASSERT_EQUAL( 3U, consumed );
+    TEST_ASSERT_EQUAL( STATE( A0 ), state.state );
+    TEST_ASSERT_EQUAL( 1U, events.base.fill );
+    TEST_ASSERT_EQUAL( 3U, events.base.read_index );
+
+    consumed = STATEMACHINE_DispatchBatch( &state, &events, 3U, NULL, NULL );
+    TEST_ASSERT_EQUAL( 1U, consumed );
+    TEST_ASSERT_EQUAL( STATE( A1 ), state.state );
+    TEST_ASSERT_TRUE( FIFO_IsEmpty( &events.base ) );
+
+    consumed = STATEMACHINE_DispatchBatch( &state, &events, 3U, NULL, NULL );
+    TEST_ASSERT_EQUAL( 0U, consumed );
+}
+
+static void test_STATE_DispatchBatchWrapAround( void )
+{
+    event_fifo_t events;
+    Init( &events );
+    
+    events.base.write_index = ( events.base.max - 1U );
+    events.base.read_index = ( events.base.max - 1U );
+
+    state_t state;
+    STATEMACHINE_Init( &state, STATE( A ) );
+
+    FIFO_Enqueue( &events, EVENT( TransitionToB ) );
+    FIFO_Enqueue( &events, EVENT( TransitionToA0 ) );
+
+    uint32_t consumed = STATEMACHINE_DispatchBatch( &state, &events, FIFO_LEN, NULL, NULL );
+    TEST_ASSERT_EQUAL( 2U, consumed );
+    TEST_ASSERT_EQUAL( STATE( A0 ), state.state );
+    TEST_ASSERT_EQUAL( 1U, events.base.read_index );
+    TEST_ASSERT_TRUE( FIFO_IsEmpty( &events.base ) );
+}
+
+static void test_STATE_DispatchBatchStop( void )
+{
+    event_fifo_t events;
+    Init( &events );
+
+    state_t state;
+    STATEMACHINE_Init( &state, STATE( A ) );
+
+    FIFO_Enqueue( &events, EVENT( Tick ) );
+    FIFO_Enqueue( &events, EVENT( TransitionToB ) );
+    FIFO_Enqueue( &events, EVENT( Tick ) );
+
+    uint32_t calls = 0U;
+    uint32_t consumed = STATEMACHINE_DispatchBatch( &state, &events, FIFO_LEN, StopInStateB, &calls );
+    TEST_ASSERT_EQUAL( 2U, consumed );
+    TEST_ASSERT_EQUAL( 2U, calls );
+    TEST_ASSERT_EQUAL( STATE( B ), state.state );
+    TEST_ASSERT_EQUAL( 1U, events.base.fill );
+    TEST_ASSERT_EQUAL( EVENT( Tick ), FIFO_Dequeue( &events ) );
+}
+
+static void test_STATE_DispatchSpan( void )
+{
+    const event_t span[] = 
+    { 
+        EVENT( TransitionToB ),
+        EVENT( TransitionToA0 ),
+        EVENT( TransitionToB ),
+        EVENT( Tick ),
+    };
+
+    state_t state;
+    STATEMACHINE_Init( &state, STATE( A ) );
+
+    STATE_UnitTestInit();
+    fifo_base_t * history_base = STATE_GetHistory();
+    history_fifo_t * history = (history_fifo_t*)history_base;
+
+    uint32_t calls = 0U;
+    uint32_t consumed = STATEMACHINE_DispatchSpan( &state, span, 2U, StopInStateB, &calls );
+    TEST_ASSERT_EQUAL( 1U, consumed );
+    TEST_ASSERT_EQUAL( STATE( B ), state.state );
+
+    consumed = STATEMACHINE_DispatchSpan( &state, &span[1], 3U, NULL, NULL );
+    TEST_ASSERT_EQUAL( 3U, consumed );
+    TEST_ASSERT_EQUAL( STATE( B ), state.state );
+
+    /* A -> B, B -> A0, A0 -> B, Tick */
+    TEST_ASSERT_EQUAL( 12U, history->base.fill );
+    TEST_ASSERT_EQUAL( history->queue[11].state, STATE( B ) );
+    TEST_ASSERT_EQUAL( history->queue[11].event, EVENT( Tick ) );
+}
 
 extern void STATETestSuite(void)
 {
@@ -765,5 +1370,25 @@ extern void STATETestSuite(void)
     RUN_TEST( test_STATE_TransitionIntoItself );
     RUN_TEST( test_STATE_TransitionWhileEntering );
     RUN_TEST( test_STATE_TransitionWhileExiting );
+    RUN_TEST( test_STATE_FlatTransition );
+    RUN_TEST( test_STATE_FlatTransitionWhileEntering );
+    RUN_TEST( test_STATE_FlatHierarchy );
+
+    RUN_TEST( test_STATE_HierarchyInit );
+    RUN_TEST( test_STATE_HierarchyInitRejects );
+    RUN_TEST( test_STATE_HierarchyInitPath );
+    RUN_TEST( test_STATE_HierarchyTransitionNoSharedParent );
+    RUN_TEST( test_STATE_HierarchyTransitionWhileEntering );
+    RUN_TEST( test_STATE_HierarchyTransitionWhileExiting );
+
+    RUN_TEST( test_STATE_CacheInit );
+    RUN_TEST( test_STATE_CacheHitMiss );
+    RUN_TEST( test_STATE_CacheTransitionWhileEntering );
+    RUN_TEST( test_STATE_CachePerThread );
+
+    RUN_TEST( test_STATE_DispatchBatch );
+    RUN_TEST( test_STATE_DispatchBatchWrapAround );
+    RUN_TEST( test_STATE_DispatchBatchStop );
+    RUN_TEST( test_STATE_DispatchSpan );
 
 }
@@ -0,0 +1,134 @@
+#include "state_trace_tests.h"
+#include "state_trace.h"
+#include "state.h"
+#include "unity.h"
+#include <string.h>
+
+#define EVENTS(EVNT) \
+    EVNT( Tick ) \
+    EVNT( Toggle ) \
+    EVNT( Ignored ) \
+
+GENERATE_EVENTS( EVENTS );
+
+DEFINE_STATE( Off );
+DEFINE_STATE( On );
+
+static state_ret_t State_Off( state_t * this, event_t s )
+{
+    state_ret_t ret;
+
+    switch( s )
+    {
+        case EVENT( Enter ):
+        case EVENT( Exit ):
+        case EVENT( Tick ):
+            ret = HANDLED( this );
+            break;
+        case EVENT( Toggle ):
+            ret = TRANSITION( this, STATE( On ) );
+            break;
+        default:
+            ret = NO_PARENT( this );
+            break;
+    }
+
+    return ret;
+}
+
+static state_ret_t State_On( state_t * this, event_t s )
+{
+    state_ret_t ret;
+
+    switch( s )
+    {
+        case EVENT( Enter ):
+        case EVENT( Exit ):
+        case EVENT( Tick ):
+            ret = HANDLED( this );
+            break;
+        case EVENT( Toggle ):
+            ret = TRANSITION( this, STATE( Off ) );
+            break;
+        default:
+            ret = NO_PARENT( this );
+            break;
+    }
+
+    return ret;
+}
+
+static void test_STATETRACE_Records( void )
+{
+    state_t state;
+    state_trace_record_t out[ 8U ];
+    state_trace_t * trace = StateTrace_Get();
+
+    StateTrace_Reset( trace );
+    STATEMACHINE_Init( &state, STATE( Off ) );
+    STATEMACHINE_Dispatch( &state, EVENT( Tick ) );
+    STATEMACHINE_Dispatch( &state, EVENT( Toggle ) );
+
+    /* Enter on init, the tick, then the toggle and its exit/entry */
+    uint32_t count = StateTrace_Dump( trace, out, 8U );
+    TEST_ASSERT_EQUAL( 5U, count );
+
+    TEST_ASSERT_EQUAL_PTR( STATE( Off ), out[0].state );
+    TEST_ASSERT_EQUAL( EVENT( Enter ), out[0].event );
+    TEST_ASSERT_EQUAL( RETURN( Handled ), out[0].ret );
+
+    TEST_ASSERT_EQUAL( EVENT( Tick ), out[1].event );
+    TEST_ASSERT_EQUAL( RETURN( Handled ), out[1].ret );
+
+    TEST_ASSERT_EQUAL_PTR( STATE( Off ), out[2].state );
+    TEST_ASSERT_EQUAL( EVENT( Toggle ), out[2].event );
+    TEST_ASSERT_EQUAL( RETURN( Transition ), out[2].ret );
+
+    TEST_ASSERT_EQUAL_PTR( STATE( Off ), out[3].state );
+    TEST_ASSERT_EQUAL( EVENT( Exit ), out[3].event );
+    TEST_ASSERT_EQUAL_PTR( STATE( On ), out[4].state );
+    TEST_ASSERT_EQUAL( EVENT( Enter ), out[4].event );
+
+    for( uint32_t idx = 0U; idx < count; idx++ )
+    {
+        TEST_ASSERT_EQUAL_PTR( &state, (void *)out[idx].machine );
+        if( idx > 0U )
+        {
+            TEST_ASSERT_LESS_OR_EQUAL( out[idx].timestamp, out[idx - 1U].timestamp );
+        }
+    }
+}
+
+static void test_STATETRACE_Overwrite( void )
+{
+    state_t state;
+    static state_trace_record_t out[ STATE_TRACE_LEN ];
+    state_trace_t * trace = StateTrace_Get();
+
+    STATEMACHINE_Init( &state, STATE( Off ) );
+    StateTrace_Reset( trace );
+
+    /* Alternate events so that the oldest survivor is easy to find */
+    for( uint32_t idx = 0U; idx < ( STATE_TRACE_LEN + 3U ); idx++ )
+    {
+        STATEMACHINE_Dispatch( &state, ( idx & 1U ) ? EVENT( Tick ) : EVENT( Ignored ) );
+    }
+    TEST_ASSERT_EQUAL( STATE_TRACE_LEN + 3U, trace->written );
+
+    uint32_t count = StateTrace_Dump( trace, out, STATE_TRACE_LEN );
+    TEST_ASSERT_EQUAL( STATE_TRACE_LEN, count );
+    TEST_ASSERT_EQUAL( EVENT( Tick ), out[0].event );
+    TEST_ASSERT_EQUAL( EVENT( Ignored ), out[1].event );
+    TEST_ASSERT_EQUAL( EVENT( Ignored ), out[count - 1U].event );
+
+    /* Partial dumps still start from the oldest record */
+    count = StateTrace_Dump( trace, out, 2U );
+    TEST_ASSERT_EQUAL( 2U, count );
+    TEST_ASSERT_EQUAL( EVENT( Tick ), out[0].event );
+}
+
+extern void STATETRACETestSuite(void)
+{
+    RUN_TEST(test_STATETRACE_Records);
+    RUN_TEST(test_STATETRACE_Overwrite);
+}
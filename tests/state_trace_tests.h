@@ -0,0 +1,6 @@
+#ifndef STATE_TRACE_TESTS_H
+#define STATE_TRACE_TESTS_H
+
+extern void STATETRACETestSuite(void);
+
+#endif /* STATE_TRACE_TESTS_H */
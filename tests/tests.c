@@ -1,8 +1,25 @@
 #include "state_tests.h"
+#include "state_table_tests.h"
+#include "state_trace_tests.h"
 #include "fifo_tests.h"
+#include "fifo_static_tests.h"
+#include "fifo_spsc_tests.h"
+#include "fifo_mpmc_tests.h"
+#include "fifo_wait_tests.h"
+#include "fifo_shm_tests.h"
+#include "fifo_priority_tests.h"
+#include "fifo_coalesce_tests.h"
 #include "heap_tests.h"
+#include "heap_static_tests.h"
+#include "heap_dary_tests.h"
+#include "heap_indexed_tests.h"
 #include "emitter_tests.h"
+#include "emitter_wheel_tests.h"
 #include "event_observer_tests.h"
+#include "event_pool_tests.h"
+#include "scheduler_tests.h"
+#include "executor_tests.h"
+#include "work_stealing_tests.h"
 #include "unity.h"
 
 int main( void )
@@ -10,9 +27,26 @@ int main( void )
     UNITY_BEGIN();
 
     FIFOTestSuite();
+    FIFOSTATICTestSuite();
+    FIFOSPSCTestSuite();
+    FIFOMPMCTestSuite();
+    FIFOWAITTestSuite();
+    FIFOSHMTestSuite();
+    FIFOPRIORITYTestSuite();
+    FIFOCOALESCETestSuite();
     STATETestSuite();
+    STATETABLETestSuite();
+    STATETRACETestSuite();
     HeapTestSuite();
+    HeapStaticTestSuite();
+    HeapDaryTestSuite();
+    HeapIndexedTestSuite();
     EMITTERTestSuite();
+    EMITTERWHEELTestSuite();
     EVENTOBSERVERTestSuite();
+    EVENTPOOLTestSuite();
+    SCHEDULERTestSuite();
+    EXECUTORTestSuite();
+    WORKSTEALINGTestSuite();
     return UNITY_END();
 }
@@ -0,0 +1,302 @@
+#include "work_stealing_tests.h"
+#include "work_stealing.h"
+#include "state.h"
+#include "unity.h"
+#include <sched.h>
+#include <string.h>
+
+#define EVENTS(EVNT) \
+    EVNT(Increment) \
+    EVNT(Forward) \
+    EVNT(Spin) \
+
+GENERATE_EVENTS( EVENTS );
+
+#define NUM_OBJECTS (4U)
+#define NUM_PRODUCERS (2U)
+#define EVENTS_PER_PRODUCER (1000U)
+#define HOT_LIMIT (100000U)
+
+typedef struct
+{
+    state_t state;
+    atomic_bool in_dispatch;
+    uint32_t count;
+    uint32_t overlaps;
+    uint32_t dropped;
+    work_stealing_t * ws;
+    ws_object_t * next;
+}
+counter_t;
+
+typedef struct
+{
+    work_stealing_t * ws;
+    ws_object_t * object;
+    event_t event;
+}
+producer_t;
+
+/* Keeps posting to itself until told another machine has run */
+typedef struct
+{
+    state_t state;
+    work_stealing_t * ws;
+    ws_object_t * self;
+    atomic_bool * served;
+    atomic_uint count;
+}
+hot_t;
+
+DEFINE_STATE(Counting);
+DEFINE_STATE(Hot);
+
+static state_ret_t State_Counting( state_t * this, event_t s )
+{
+    state_ret_t ret;
+    counter_t * counter = (counter_t *)this;
+
+    switch( s )
+    {
+        case EVENT(Enter):
+        case EVENT(Exit):
+            ret = HANDLED(this);
+            break;
+        case EVENT(Increment):
+        case EVENT(Forward):
+            if( atomic_exchange( &counter->in_dispatch, true ) )
+            {
+                counter->overlaps++;
+            }
+            counter->count++;
+            /* Never spin in a handler, the target may be queued behind us */
+            if( ( s == EVENT(Forward) ) && ( counter->next != NULL ) &&
+                    !WorkStealing_Post( counter->ws, counter->next, EVENT(Increment) ) )
+            {
+                counter->dropped++;
+            }
+            atomic_store( &counter->in_dispatch, false );
+            ret = HANDLED(this);
+            break;
+        default:
+            ret = NO_PARENT(this);
+            break;
+    }
+
+    return ret;
+}
+
+static state_ret_t State_Hot( state_t * this, event_t s )
+{
+    state_ret_t ret;
+    hot_t * hot = (hot_t *)this;
+
+    switch( s )
+    {
+        case EVENT(Enter):
+        case EVENT(Exit):
+            ret = HANDLED(this);
+            break;
+        case EVENT(Spin):
+            if( ( atomic_fetch_add( &hot->count, 1U ) + 1U ) < HOT_LIMIT && !atomic_load( hot->served ) )
+            {
+                (void)WorkStealing_Post( hot->ws, hot->self, EVENT(Spin) );
+            }
+            ret = HANDLED(this);
+            break;
+        case EVENT(Increment):
+            atomic_store( hot->served, true );
+            ret = HANDLED(this);
+            break;
+        default:
+            ret = NO_PARENT(this);
+            break;
+    }
+
+    return ret;
+}
+
+static void * Producer( void * arg )
+{
+    producer_t * producer = (producer_t *)arg;
+
+    for( uint32_t idx = 0U; idx < EVENTS_PER_PRODUCER; idx++ )
+    {
+        for( uint32_t jdx = 0U; jdx < NUM_OBJECTS; jdx++ )
+        {
+            while( !WorkStealing_Post( producer->ws, &producer->object[jdx], producer->event ) )
+            {
+                sched_yield();
+            }
+        }
+    }
+
+    return NULL;
+}
+
+static void CreateCounters( counter_t * counter, uint32_t num, work_stealing_t * ws )
+{
+    for( uint32_t idx = 0U; idx < num; idx++ )
+    {
+        STATEMACHINE_Init( &counter[idx].state, STATE( Counting ) );
+        atomic_init( &counter[idx].in_dispatch, false );
+        counter[idx].count = 0U;
+        counter[idx].overlaps = 0U;
+        counter[idx].dropped = 0U;
+        counter[idx].ws = ws;
+        counter[idx].next = NULL;
+    }
+}
+
+static void RunProducers( producer_t * producer )
+{
+    pthread_t thread[NUM_PRODUCERS];
+
+    for( uint32_t idx = 0U; idx < NUM_PRODUCERS; idx++ )
+    {
+        pthread_create( &thread[idx], NULL, Producer, producer );
+    }
+    for( uint32_t idx = 0U; idx < NUM_PRODUCERS; idx++ )
+    {
+        pthread_join( thread[idx], NULL );
+    }
+}
+
+static void test_WORKSTEALING_Init( void )
+{
+    static work_stealing_t ws;
+
+    WorkStealing_Init( &ws, 3U );
+
+    TEST_ASSERT_EQUAL( 3U, ws.num_workers );
+    TEST_ASSERT_EQUAL( 0U, ws.num_objects );
+    TEST_ASSERT_FALSE( ws.started );
+    TEST_ASSERT_EQUAL_PTR( &ws, ws.worker[2].runtime );
+    TEST_ASSERT_EQUAL( 2U, ws.worker[2].index );
+}
+
+static void test_WORKSTEALING_PostBeforeStart( void )
+{
+    static work_stealing_t ws;
+    static ws_object_t object;
+    counter_t counter;
+
+    CreateCounters( &counter, 1U, &ws );
+    WorkStealing_Init( &ws, 1U );
+    WorkStealing_Register( &ws, &object, &counter.state );
+
+    TEST_ASSERT_EQUAL( 1U, ws.num_objects );
+    TEST_ASSERT_FALSE( WorkStealing_Post( &ws, &object, EVENT(Increment) ) );
+}
+
+static void test_WORKSTEALING_Drain( void )
+{
+    static work_stealing_t ws;
+    static ws_object_t object[NUM_OBJECTS];
+    counter_t counter[NUM_OBJECTS];
+    producer_t producer = { .ws = &ws, .object = object, .event = EVENT(Increment) };
+
+    CreateCounters( counter, NUM_OBJECTS, &ws );
+    WorkStealing_Init( &ws, 2U );
+    for( uint32_t idx = 0U; idx < NUM_OBJECTS; idx++ )
+    {
+        WorkStealing_Register( &ws, &object[idx], &counter[idx].state );
+    }
+    WorkStealing_Start( &ws );
+    RunProducers( &producer );
+    WorkStealing_Stop( &ws );
+
+    uint64_t total = 0U;
+    for( uint32_t idx = 0U; idx < NUM_OBJECTS; idx++ )
+    {
+        TEST_ASSERT_EQUAL( NUM_PRODUCERS * EVENTS_PER_PRODUCER, counter[idx].count );
+        TEST_ASSERT_EQUAL( NUM_PRODUCERS * EVENTS_PER_PRODUCER, object[idx].dispatched );
+        TEST_ASSERT_EQUAL( 0U, counter[idx].overlaps );
+        TEST_ASSERT_FALSE( atomic_load( &object[idx].scheduled ) );
+    }
+
+    /* Machines may run on any worker, but every event is counted once */
+    for( uint32_t idx = 0U; idx < ws.num_workers; idx++ )
+    {
+        ws_stats_t stats;
+        WorkStealing_GetStats( &ws, idx, &stats );
+        TEST_ASSERT_LESS_OR_EQUAL( stats.steal_attempts, stats.steals );
+        TEST_ASSERT_TRUE( ( stats.utilization >= 0.0 ) && ( stats.utilization <= 100.0 ) );
+        total += stats.dispatched;
+    }
+    TEST_ASSERT_EQUAL_UINT64( (uint64_t)NUM_OBJECTS * NUM_PRODUCERS * EVENTS_PER_PRODUCER, total );
+
+    /* Posts are rejected once stopped */
+    TEST_ASSERT_FALSE( WorkStealing_Post( &ws, &object[0], EVENT(Increment) ) );
+}
+
+static void test_WORKSTEALING_PostFromHandler( void )
+{
+    static work_stealing_t ws;
+    static ws_object_t object[NUM_OBJECTS + 1U];
+    counter_t counter[NUM_OBJECTS + 1U];
+    producer_t producer = { .ws = &ws, .object = object, .event = EVENT(Forward) };
+
+    /* Every machine forwards to the last one, so it is fed by posts from
+     * the workers themselves. Anything forwarded and not dropped must land */
+    CreateCounters( counter, NUM_OBJECTS + 1U, &ws );
+    WorkStealing_Init( &ws, 2U );
+    for( uint32_t idx = 0U; idx < ( NUM_OBJECTS + 1U ); idx++ )
+    {
+        WorkStealing_Register( &ws, &object[idx], &counter[idx].state );
+        counter[idx].next = ( idx < NUM_OBJECTS ) ? &object[NUM_OBJECTS] : NULL;
+    }
+    WorkStealing_Start( &ws );
+    RunProducers( &producer );
+    WorkStealing_Stop( &ws );
+
+    uint32_t dropped = 0U;
+    for( uint32_t idx = 0U; idx < NUM_OBJECTS; idx++ )
+    {
+        TEST_ASSERT_EQUAL( NUM_PRODUCERS * EVENTS_PER_PRODUCER, counter[idx].count );
+        TEST_ASSERT_EQUAL( 0U, counter[idx].overlaps );
+        dropped += counter[idx].dropped;
+    }
+    TEST_ASSERT_GREATER_THAN( 0U, counter[NUM_OBJECTS].count );
+    TEST_ASSERT_EQUAL( NUM_OBJECTS * NUM_PRODUCERS * EVENTS_PER_PRODUCER, counter[NUM_OBJECTS].count + dropped );
+    TEST_ASSERT_EQUAL( 0U, counter[NUM_OBJECTS].overlaps );
+}
+
+static void test_WORKSTEALING_Quantum( void )
+{
+    static work_stealing_t ws;
+    static ws_object_t object[2];
+    static hot_t hot[2];
+    atomic_bool served;
+
+    /* With a single worker the only way the second machine runs while the
+     * first keeps feeding itself is the first being preempted */
+    atomic_init( &served, false );
+    WorkStealing_Init( &ws, 1U );
+    for( uint32_t idx = 0U; idx < 2U; idx++ )
+    {
+        STATEMACHINE_Init( &hot[idx].state, STATE( Hot ) );
+        hot[idx].ws = &ws;
+        hot[idx].self = &object[idx];
+        hot[idx].served = &served;
+        atomic_init( &hot[idx].count, 0U );
+        WorkStealing_Register( &ws, &object[idx], &hot[idx].state );
+    }
+    WorkStealing_Start( &ws );
+    TEST_ASSERT_TRUE( WorkStealing_Post( &ws, &object[0], EVENT(Spin) ) );
+    TEST_ASSERT_TRUE( WorkStealing_Post( &ws, &object[1], EVENT(Increment) ) );
+    WorkStealing_Stop( &ws );
+
+    TEST_ASSERT_TRUE( atomic_load( &served ) );
+    TEST_ASSERT_LESS_THAN( HOT_LIMIT, atomic_load( &hot[0].count ) );
+    TEST_ASSERT_EQUAL( 1U, object[1].dispatched );
+}
+
+extern void WORKSTEALINGTestSuite(void)
+{
+    RUN_TEST(test_WORKSTEALING_Init);
+    RUN_TEST(test_WORKSTEALING_PostBeforeStart);
+    RUN_TEST(test_WORKSTEALING_Drain);
+    RUN_TEST(test_WORKSTEALING_PostFromHandler);
+    RUN_TEST(test_WORKSTEALING_Quantum);
+}
@@ -0,0 +1,6 @@
+#ifndef WORK_STEALING_TESTS_H
+#define WORK_STEALING_TESTS_H
+
+extern void WORKSTEALINGTestSuite(void);
+
+#endif /* WORK_STEALING_TESTS_H */